@@ -0,0 +1,90 @@
+#include "async_writer.h"
+#include <cstring>
+
+std::atomic<unsigned int> AsyncWriter::nb_running_(0);
+
+//-----------------------------CONSTRUCTOR----------------------------//
+AsyncWriter::AsyncWriter(const std::string& file_name)
+: file_(file_name, std::ios::binary), good_(file_.is_open()), nb_bytes_(0), stop_(false)
+{
+	thread_ = std::thread(&AsyncWriter::run, this);
+	++nb_running_;
+}
+
+//-------------------------------GETTERS------------------------------//
+bool AsyncWriter::is_good() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return good_;
+}
+
+unsigned long AsyncWriter::get_nb_bytes() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return nb_bytes_;
+}
+
+unsigned int AsyncWriter::get_nb_running()
+{
+	return nb_running_;
+}
+
+//-------------------------------WRITING------------------------------//
+void AsyncWriter::write(const void* data, unsigned long size)
+{
+	std::vector<char> block;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (not free_blocks_.empty()) {
+			block.swap(free_blocks_.back());
+			free_blocks_.pop_back();
+		}
+	}
+
+	block.resize(size);
+	std::memcpy(block.data(), data, size);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		blocks_.push_back(std::move(block));
+		nb_bytes_ += size;
+	}
+	condition_.notify_one();
+}
+
+void AsyncWriter::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true) {
+		condition_.wait(lock, [this] { return stop_ or not blocks_.empty(); });
+		if (blocks_.empty()) {
+			//stop_ is true and everything has been written
+			return;
+		}
+
+		std::vector<char> block(std::move(blocks_.front()));
+		blocks_.pop_front();
+
+		//the disk is accessed without the lock so that write() never waits for it
+		lock.unlock();
+		file_.write(block.data(), block.size());
+		bool good(file_.good());
+		lock.lock();
+
+		good_ = good_ and good;
+		free_blocks_.push_back(std::move(block));
+	}
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+AsyncWriter::~AsyncWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	condition_.notify_one();
+	thread_.join();
+	file_.close();
+	--nb_running_;
+}
@@ -0,0 +1,68 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AsyncWriter {
+	public:
+	///CONSTRUCTOR (opens the file in binary mode and starts the writing thread)
+	/**
+      \param file_name is the name of the file where the data are written.
+    */
+	AsyncWriter(const std::string& file_name);
+
+		//getters
+	///getter for the state of the file.
+	/**
+      \return true if the file could be opened and every write succeeded.
+    */
+	bool is_good() const;
+
+	///getter for the number of bytes given to the writer.
+	/**
+      \return the number of bytes given since the beginning (written or still waiting).
+    */
+	unsigned long get_nb_bytes() const;
+
+	///getter for the number of writers alive in the process.
+	/**
+      \return the number of writing threads running (the process must not be forked while it is not 0).
+    */
+	static unsigned int get_nb_running();
+
+		//writing
+	///copies a block of data which will be written by the writing thread (the caller doesn't wait for the disk).
+	/**
+      \param data is the beginning of the block.
+      \param size is the size of the block in bytes.
+    */
+	void write(const void* data, unsigned long size);
+
+	///DESTRUCTOR (waits until every block has been written and closes the file)
+	~AsyncWriter();
+
+	private:
+	///loop of the writing thread.
+	void run();
+
+	std::ofstream file_; /**< the file where the data are written */
+	bool good_; /**< false if an error happened on the file */
+	unsigned long nb_bytes_; /**< number of bytes given since the beginning */
+
+	std::deque<std::vector<char>> blocks_; /**< blocks waiting to be written */
+	std::vector<std::vector<char>> free_blocks_; /**< blocks already written, kept to avoid new allocations */
+	bool stop_; /**< true when the writing thread has to end */
+	mutable std::mutex mutex_; /**< protects the attributes shared with the writing thread */
+	std::condition_variable condition_; /**< wakes up the writing thread when a block is available */
+	std::thread thread_; /**< the writing thread */
+
+	static std::atomic<unsigned int> nb_running_; /**< number of writers alive in the process */
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "background_checkpointer.h"
+#include "async_writer.h"
+#include "simulation.h"
+#include <cstdio>
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+///says if the process has only one thread (the one which calls the function).
+bool is_single_threaded()
+{
+	//each thread has a directory in /proc/self/task (Linux), otherwise only the writers of the program are known
+	DIR* tasks(opendir("/proc/self/task"));
+	if (tasks == nullptr) {
+		return AsyncWriter::get_nb_running() == 0;
+	}
+	unsigned int nb_threads(0);
+	while (const dirent* entry = readdir(tasks)) {
+		if (entry->d_name[0] != '.') {
+			++nb_threads;
+		}
+	}
+	closedir(tasks);
+	return nb_threads == 1;
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+BackgroundCheckpointer::BackgroundCheckpointer(const std::string& prefix, unsigned long interval_steps, unsigned int retention)
+: prefix_(prefix), interval_steps_(interval_steps > 0 ? interval_steps : 1), retention_(retention)
+, nb_started_(0), nb_completed_(0), nb_failed_(0), nb_synchronous_(0)
+{}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long BackgroundCheckpointer::get_nb_started() const
+{
+	return nb_started_;
+}
+
+unsigned long BackgroundCheckpointer::get_nb_completed() const
+{
+	return nb_completed_;
+}
+
+unsigned long BackgroundCheckpointer::get_nb_failed() const
+{
+	return nb_failed_;
+}
+
+unsigned long BackgroundCheckpointer::get_nb_synchronous() const
+{
+	return nb_synchronous_;
+}
+
+std::string BackgroundCheckpointer::get_last_checkpoint() const
+{
+	if (completed_.empty()) {
+		return "";
+	}
+	return completed_.back();
+}
+
+//-----------------------------CHECKPOINTS----------------------------//
+void BackgroundCheckpointer::step(const Simulation& simulation, unsigned long clock)
+{
+	if (not pending_.empty()) {
+		poll(false);
+	}
+	if (clock % interval_steps_ != 0) {
+		return;
+	}
+
+	const std::string file_name(prefix_ + "_" + std::to_string(clock) + ".chk");
+	const std::string temporary_name(file_name + ".tmp");
+	++nb_started_;
+
+	//the buffers of the standard streams are emptied so that the child doesn't write them a second time
+	std::cout.flush();
+	std::fflush(nullptr);
+
+	//a thread of the parent holding a lock of the allocator or of a stream would leave it locked forever in the child
+	pid_t pid(is_single_threaded() ? fork() : -1);
+	if (pid == 0) {
+		//child: the memory is a frozen copy of the parent's one, _exit doesn't run the destructors of the parent's objects
+		bool good(simulation.save(temporary_name) and std::rename(temporary_name.c_str(), file_name.c_str()) == 0);
+		_exit(good ? 0 : 1);
+	}
+
+	if (pid < 0) {
+		//the process couldn't be forked: the checkpoint is written now
+		++nb_synchronous_;
+		if (simulation.save(temporary_name) and std::rename(temporary_name.c_str(), file_name.c_str()) == 0) {
+			complete(file_name);
+		} else {
+			std::remove(temporary_name.c_str());
+			++nb_failed_;
+		}
+		return;
+	}
+
+	pending_.push_back({pid, file_name});
+}
+
+void BackgroundCheckpointer::poll(bool wait)
+{
+	//the checkpoints are started one after the other, so the oldest is expected to end first
+	while (not pending_.empty()) {
+		int status(0);
+		pid_t pid(waitpid(pending_.front().pid, &status, wait ? 0 : WNOHANG));
+		if (pid == 0) {
+			return;
+		}
+
+		const std::string file_name(pending_.front().file_name);
+		pending_.pop_front();
+		if (pid > 0 and WIFEXITED(status) and WEXITSTATUS(status) == 0) {
+			complete(file_name);
+		} else {
+			std::remove((file_name + ".tmp").c_str());
+			++nb_failed_;
+		}
+	}
+}
+
+void BackgroundCheckpointer::complete(const std::string& file_name)
+{
+	++nb_completed_;
+	completed_.push_back(file_name);
+	while (retention_ > 0 and completed_.size() > retention_) {
+		std::remove(completed_.front().c_str());
+		completed_.pop_front();
+	}
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+BackgroundCheckpointer::~BackgroundCheckpointer()
+{
+	poll(true);
+}
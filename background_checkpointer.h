@@ -0,0 +1,89 @@
+#ifndef BACKGROUND_CHECKPOINTER_H
+#define BACKGROUND_CHECKPOINTER_H
+#include <deque>
+#include <string>
+#include <sys/types.h>
+
+class Simulation;
+
+///writes periodic checkpoints of a simulation without stopping it.
+/**
+  At each checkpoint the process is forked: the child has a frozen (copy-on-write) image of the simulation,
+  writes it with Simulation::save() and ends, while the parent goes on simulating. The file is first written
+  with the suffix ".tmp" and renamed when it is complete, so a checkpoint file is never half-written.
+  Only the thread which forks is copied in the child, which serializes with iostreams and allocates: a lock held
+  by another thread would never be released. So if the process has other threads (an AsyncWriter, the workers of
+  a sweep...) or if fork() fails, the checkpoint is written directly.
+*/
+class BackgroundCheckpointer {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param prefix is the beginning of the names of the files (the clock and ".chk" are added).
+      \param interval_steps is the number of steps between two checkpoints.
+      \param retention is the number of complete checkpoint files kept (the oldest ones are removed, 0 to keep all of them).
+    */
+	BackgroundCheckpointer(const std::string& prefix, unsigned long interval_steps, unsigned int retention = 2);
+
+		//getters
+	///getter for the number of checkpoints started.
+	unsigned long get_nb_started() const;
+
+	///getter for the number of checkpoints written successfully.
+	unsigned long get_nb_completed() const;
+
+	///getter for the number of checkpoints which failed.
+	unsigned long get_nb_failed() const;
+
+	///getter for the number of checkpoints written directly, without a child process.
+	unsigned long get_nb_synchronous() const;
+
+	///getter for the last complete checkpoint.
+	/**
+      \return the name of the file of the last complete checkpoint (empty if there is none).
+    */
+	std::string get_last_checkpoint() const;
+
+		//checkpoints
+	///starts a checkpoint if the clock is a multiple of the interval and looks for finished checkpoints.
+	/**
+      \param simulation is the simulation saved.
+      \param clock is the current time of the simulation in number of steps.
+    */
+	void step(const Simulation& simulation, unsigned long clock);
+
+	///looks for finished checkpoints.
+	/**
+      \param wait says if the function has to wait until every checkpoint started is finished.
+    */
+	void poll(bool wait);
+
+	///DESTRUCTOR (waits for the checkpoints which are not finished)
+	~BackgroundCheckpointer();
+
+	private:
+	///a checkpoint written by a child process.
+	struct Pending {
+		pid_t pid; /**< process writing the checkpoint */
+		std::string file_name; /**< final name of the file */
+	};
+
+	///keeps a finished checkpoint and removes the old ones.
+	/**
+      \param file_name is the name of the file.
+    */
+	void complete(const std::string& file_name);
+
+	const std::string prefix_; /**< beginning of the names of the files */
+	const unsigned long interval_steps_; /**< number of steps between two checkpoints */
+	const unsigned int retention_; /**< number of complete checkpoint files kept */
+
+	std::deque<Pending> pending_; /**< checkpoints being written */
+	std::deque<std::string> completed_; /**< complete checkpoint files kept, the oldest first */
+	unsigned long nb_started_; /**< number of checkpoints started */
+	unsigned long nb_completed_; /**< number of checkpoints written successfully */
+	unsigned long nb_failed_; /**< number of checkpoints which failed */
+	unsigned long nb_synchronous_; /**< number of checkpoints written without a child process */
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+///writes the bytes of a value in a binary stream.
+/**
+  \param out is the stream.
+  \param value is the value written (it has to be a plain type: number, boolean...).
+*/
+template<typename T>
+void write_binary(std::ostream& out, const T& value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+///reads the bytes of a value from a binary stream.
+/**
+  \param in is the stream.
+  \param value receives the value read.
+  \return true if the value could be read.
+*/
+template<typename T>
+bool read_binary(std::istream& in, T& value)
+{
+	in.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return in.good();
+}
+
+///writes the size of a vector and then all its elements in one block.
+/**
+  \param out is the stream.
+  \param values is the vector written (its elements have to be plain types).
+*/
+template<typename T>
+void write_binary_vector(std::ostream& out, const std::vector<T>& values)
+{
+	const unsigned long long size(values.size());
+	write_binary(out, size);
+	if (size > 0) {
+		out.write(reinterpret_cast<const char*>(values.data()), size*sizeof(T));
+	}
+}
+
+///reads a vector written by write_binary_vector.
+/**
+  \param in is the stream.
+  \param values receives the elements read.
+  \param max_size is the maximal number of elements accepted (to detect corrupted files).
+  \return true if the vector could be read.
+*/
+template<typename T>
+bool read_binary_vector(std::istream& in, std::vector<T>& values, unsigned long long max_size = -1)
+{
+	unsigned long long size(0);
+	if (not read_binary(in, size) or size > max_size) {
+		return false;
+	}
+	values.resize(size);
+	if (size > 0) {
+		in.read(reinterpret_cast<char*>(values.data()), size*sizeof(T));
+	}
+	return in.good();
+}
+
+///reads an array of a known size, block by block.
+/**
+  \param in is the stream.
+  \param values receives the elements read.
+  \param size is the number of elements (read from the stream, it can be corrupted: the memory is allocated as the elements are read).
+  \return true if the array could be read.
+*/
+template<typename T>
+bool read_binary_array(std::istream& in, std::vector<T>& values, unsigned long long size)
+{
+	const unsigned long long block_size(1 << 16);
+	values.clear();
+	while (values.size() < size and in.good()) {
+		const unsigned long long begin(values.size());
+		values.resize(begin + std::min(block_size, size - begin));
+		in.read(reinterpret_cast<char*>(values.data() + begin), (values.size() - begin)*sizeof(T));
+	}
+	return in.good();
+}
+
+#endif
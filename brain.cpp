@@ -1,40 +1,99 @@
 #include "brain.h"
+#include "binary_io.h"
+#include <algorithm>
+#include <cstddef>
 #include <cmath>
-#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+	///the excitatory and the inhibitory populations of N. Brunel's network, which share their parameters.
+	std::vector<Population> brunel_populations(unsigned long NE, unsigned long NI, double dt, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double J, double TAU, double R)
+	{
+		std::shared_ptr<NeuronParameters> parameters(std::make_shared<NeuronParameters>());
+		parameters->dt = dt;
+		parameters->Refractory_Time_Steps = Refractory_Time_Steps;
+		parameters->Vthr = Vthr;
+		parameters->Vreset = Vreset;
+		parameters->J = J;
+		parameters->TAU = TAU;
+		parameters->R = R;
+		return {{NE, parameters}, {NI, parameters}};
+	}
+	
+	///the projections of N. Brunel's network: each population sends JE or JI to both with the same delay.
+	std::vector<Projection> brunel_projections(double JE, double JI, unsigned int Delay_Steps)
+	{
+		return {{0, 0, JE, Delay_Steps}, {0, 1, JE, Delay_Steps}, {1, 0, JI, Delay_Steps}, {1, 1, JI, Delay_Steps}};
+	}
+	
+	///the first population, after checking that the populations are exactly the neurons of the connections.
+	const Population& first_population(const std::vector<Population>& populations, unsigned long nb_neurons)
+	{
+		unsigned long size(0);
+		for (const auto& population : populations) {
+			size += population.size;
+		}
+		if (populations.empty() or size != nb_neurons) {
+			throw std::invalid_argument("Brain: the populations must have the neurons of the connections");
+		}
+		return populations.front();
+	}
+	
+	///the weights of connections without weights of their own (the code of every connection is 1).
+	struct UnitWeights {
+		double operator[](std::ptrdiff_t) const { return 1.0; }
+	};
+	
+	///the codes of the weights of a bucket of connections.
+	template<class Code>
+	struct CodedWeights {
+		const Code* codes; /**< code of each connection of the bucket */
+		double operator[](std::ptrdiff_t k) const { return codes[k]; }
+	};
+	
+	///a random seed for the connections.
+	unsigned int random_seed()
+	{
+		static std::random_device rd;
+		return rd();
+	}
+}
 
 //----------------------------CONSTRUCTOR-----------------------------//
 Brain::Brain(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, double dt, double v_ext, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double JE, double JI, double J, double TAU, double R)
-: nb_neurons_(NE + NI), NE_(NE), dt_(dt), Delay_Steps_(Delay_Steps), v_ext_(v_ext), time_(0)
+: Brain(Connectivity::random(NE, NI, CE, CI, random_seed()), brunel_populations(NE, NI, dt, Refractory_Time_Steps, Vthr, Vreset, J, TAU, R), brunel_projections(JE, JI, Delay_Steps), v_ext)
+{}
+
+Brain::Brain(std::shared_ptr<Connectivity> network, unsigned long NE, double dt, double v_ext, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double JE, double JI, double J, double TAU, double R)
+: Brain(network, brunel_populations(NE, network->get_nb_neurons() - NE, dt, Refractory_Time_Steps, Vthr, Vreset, J, TAU, R), brunel_projections(JE, JI, Delay_Steps), v_ext)
+{}
+
+Brain::Brain(std::shared_ptr<Connectivity> network, const std::vector<Population>& populations, const std::vector<Projection>& projections, double v_ext)
+: nb_neurons_(network->get_nb_neurons()), NE_(first_population(populations, nb_neurons_).size), dt_(populations.front().parameters->dt), v_ext_(v_ext)
+, populations_(populations), weights_(populations.size()*populations.size(), 0.0), delays_(populations.size()*populations.size(), 0), min_delay_(~0u)
+, time_(0), generator_(std::random_device()()), background_noise_(POISSON_NOISE), gaussian_noise_(v_ext, std::sqrt(v_ext)), network_(network)
 {
-	//creation of neurons and connections between them
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
-	std::uniform_int_distribution<> random_excitatory(0, NE_-1);
-	std::uniform_int_distribution<> random_inhibitory(NE_, nb_neurons_-1);
+	const unsigned int nb_populations(populations_.size());
 	
-	for(unsigned int j(0); j<nb_neurons_ ; ++j) {
-		std::vector<unsigned long> transmitter_neuron;
-		network_.push_back(transmitter_neuron);
+	//weight and delay of each pair of populations, and longest delay received by each population (size of the buffers of its neurons)
+	std::vector<unsigned int> longest_delays(nb_populations, 0);
+	for (const auto& projection : projections) {
+		if (projection.source < nb_populations and projection.target < nb_populations) {
+			weights_[projection.source*nb_populations + projection.target] = projection.weight;
+			delays_[projection.source*nb_populations + projection.target] = projection.Delay_Steps;
+			longest_delays[projection.target] = std::max(longest_delays[projection.target], projection.Delay_Steps + network_->get_max_delay());
+			min_delay_ = std::min(min_delay_, projection.Delay_Steps);
+		}
 	}
 	
-	for (unsigned int i(0) ; i < nb_neurons_ ; ++i) {
-		 //NEURONS
-		if (i<NE_) {
-			//creation of nb_excitatory neurons (from 0 to nb_excitatory-1 )
-			neurons_.push_back(Neuron(true, dt_, Delay_Steps_, Refractory_Time_Steps, Vthr, Vreset, JE, JI, J, TAU, R));
-		} else {
-			//creation of nb_inhibitory neurons (from nb_excitatory to nb_neurons )
-			neurons_.push_back(Neuron(false, dt, Delay_Steps_, Refractory_Time_Steps, Vthr, Vreset, JE, JI, J, TAU, R));
-		}
-		
-		//CONNECTIONS
-		//creation of CE random connections between the receiver neurons (i) and excitatory neurons (random)
-		for(unsigned int k(0) ; k<CE ; ++k) {
-			network_[random_excitatory(generator)].push_back(i);
-		}
-		//creation of CI random connections between the receiver neurons (i) and inhibitory neurons (random)
-		for(unsigned int k(0) ; k<CI ; ++k) {
-			network_[random_inhibitory(generator)].push_back(i);
+	//creation of the neurons of each population
+	population_of_.reserve(nb_neurons_);
+	neurons_.reserve(nb_neurons_);
+	for (unsigned int p(0) ; p < nb_populations ; ++p) {
+		for (unsigned long i(0) ; i < populations_[p].size ; ++i) {
+			population_of_.push_back(p);
+			neurons_.push_back(Neuron(populations_[p].parameters, longest_delays[p]));
 		}
 	}
 }
@@ -55,32 +114,71 @@ unsigned long Brain::get_nb_inhibitory() const
 	return nb_neurons_ - NE_;
 }
 
+const std::vector<Population>& Brain::get_populations() const
+{
+	return populations_;
+}
+
 const Neuron& Brain::get_neuron(unsigned long neuron_index)
 {
 	return neurons_[neuron_index];
 }
 
+void Brain::gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const
+{
+	const unsigned long nb_indexes(neuron_indexes.size());
+	for (unsigned long k(0) ; k<nb_indexes ; ++k) {
+		membrane_potentials[k] = neurons_[neuron_indexes[k]].get_membrane_potential();
+	}
+}
+
+std::shared_ptr<const Connectivity> Brain::get_network() const
+{
+	return network_;
+}
+
+const Stdp& Brain::get_stdp() const
+{
+	return stdp_;
+}
+
+const ShortTermPlasticity& Brain::get_short_term_plasticity() const
+{
+	return short_term_;
+}
+
 //--------------------------------UPDATE------------------------------//
 void Brain::update(unsigned long T, std::ostream& file)
 {
 	//poisson distribution
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
 	std::poisson_distribution<> random_input(v_ext_);
 	
+	//the Gaussian background input of every neuron is drawn at once
+	const bool gaussian(background_noise_ == GAUSSIAN_NOISE);
+	if (gaussian) {
+		random_inputs_.resize(nb_neurons_);
+		gaussian_noise_.generate(generator_, random_inputs_.data(), nb_neurons_);
+	}
+	
+	spiking_neurons_.clear();
+	
 	//update(T) de chaque neurone //stockage des spikes dans un vector de taille nb_neurones
 	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
-		bool spike = neurons_[i].update(T, random_input(generator));
+		bool spike = neurons_[i].update(T, gaussian ? random_inputs_[i] : random_input(generator_));
 		
 		//send signals and save the data if there is a spike
 		if (spike) {
 			send_signals(i, T);
+			spiking_neurons_.push_back(i);
 			file << T*dt_ << '\t' << i << '\n';
+			for (auto recorder : recorders_) {
+				recorder->record_spike(i, T);
+			}
 		}
 	}
 	
 	//this part never occurs because or delay_steps=15 : in one step time no neuron will receive a signal from "this" update for "this" time
-	if (Delay_Steps_<1) {
+	if (min_delay_<1) {
 		bool s;
 		do {
 			s = false;
@@ -89,51 +187,143 @@ void Brain::update(unsigned long T, std::ostream& file)
 				bool spike = neurons_[i].add_signals();
 				if (spike) {
 					s = true;
-					if (i<NE_) {
-						for (auto receiver_neuron : network_[i]) {
-							neurons_[receiver_neuron].receive_signal(T, true);
-						}
-					} else {
-						for (auto receiver_neuron : network_[i]) {
-							neurons_[receiver_neuron].receive_signal(T, false);
-						}
+					for (auto recorder : recorders_) {
+						recorder->record_spike(i, T);
 					}
+					send_signals(i, T);
+					spiking_neurons_.push_back(i);
 				}
 			}
 		} while (s);
 	}
 	
+	//the plasticity takes all the spikes of the step at once, so that it doesn't depend on the order of the neurons
+	if (stdp_.is_enabled()) {
+		stdp_.spikes(spiking_neurons_, T);
+	}
+	
 	//update du time
 	time_ = T;
+	
+	for (auto recorder : recorders_) {
+		recorder->end_of_step(*this, T);
+	}
 }
 
 //---------------------------OTHER-METHODS----------------------------//
 void Brain::send_signals(unsigned long transmitter_neuron, unsigned long T)
 {
-	if (transmitter_neuron<NE_) {
-		for (auto receiver_neuron : network_[transmitter_neuron]) {
-			neurons_[receiver_neuron].receive_signal(T, true);
+	//the projections from the population of the transmitter, looked up by the population of each receiver
+	const unsigned long nb_populations(populations_.size());
+	const double* weights(&weights_[population_of_[transmitter_neuron]*nb_populations]);
+	const unsigned int* delays(&delays_[population_of_[transmitter_neuron]*nb_populations]);
+	
+	//the short-term plasticity is computed once for all the connections of the spike (its efficacy is 1 without it),
+	//and the weight of the code 1 of the connections (1 without weights) is put with the weight of each projection
+	const double efficacy(short_term_.spike(transmitter_neuron, T));
+	const unsigned int short_term_target(short_term_.get_parameters().target);
+	const double weight_scale(network_->get_weight_scale());
+	signal_weights_.resize(nb_populations);
+	for (unsigned int target(0) ; target<nb_populations ; ++target) {
+		signal_weights_[target] = weights[target]*weight_scale*(target == short_term_target ? efficacy : 1.0);
+	}
+	
+	//the plastic weights replace the weights of the connections to their population
+	const float* plastic_weights(stdp_.get_weights(transmitter_neuron));
+	const unsigned int plastic_target(stdp_.get_parameters().target);
+	const double plastic_efficacy(plastic_target == short_term_target ? efficacy : 1.0);
+	
+	//the kind of weights is chosen for each bucket, not for each connection
+	const std::uint32_t* first_receiver(network_->begin(transmitter_neuron));
+	const unsigned long nb_buckets(network_->get_nb_buckets(transmitter_neuron));
+	for (unsigned long bucket(0) ; bucket<nb_buckets ; ++bucket) {
+		const unsigned int bucket_delay(network_->get_bucket_delay(transmitter_neuron, bucket));
+		const std::uint8_t* codes_8(network_->weight_codes_8(transmitter_neuron, bucket));
+		const std::uint16_t* codes_16(network_->weight_codes_16(transmitter_neuron, bucket));
+		const std::uint32_t* begin(network_->bucket_begin(transmitter_neuron, bucket));
+		const std::uint32_t* end(network_->bucket_end(transmitter_neuron, bucket));
+		const float* bucket_plastic_weights(plastic_weights != nullptr ? plastic_weights + (begin - first_receiver) : nullptr);
+		if (codes_8 != nullptr) {
+			send_bucket(T, begin, end, CodedWeights<std::uint8_t>({codes_8}), delays, bucket_delay, bucket_plastic_weights, plastic_target, plastic_efficacy);
+		} else if (codes_16 != nullptr) {
+			send_bucket(T, begin, end, CodedWeights<std::uint16_t>({codes_16}), delays, bucket_delay, bucket_plastic_weights, plastic_target, plastic_efficacy);
+		} else {
+			send_bucket(T, begin, end, UnitWeights(), delays, bucket_delay, bucket_plastic_weights, plastic_target, plastic_efficacy);
 		}
-	} else {
-		for (auto receiver_neuron : network_[transmitter_neuron]) {
-			neurons_[receiver_neuron].receive_signal(T, false);
+	}
+}
+
+template<class Codes>
+void Brain::send_bucket(unsigned long T, const std::uint32_t* begin, const std::uint32_t* end, const Codes& codes, const unsigned int* delays, unsigned int bucket_delay, const float* plastic_weights, unsigned int plastic_target, double plastic_efficacy)
+{
+	if (plastic_weights == nullptr) {
+		for (const std::uint32_t* receiver_neuron(begin) ; receiver_neuron != end ; ++receiver_neuron) {
+			const unsigned int target(population_of_[*receiver_neuron]);
+			neurons_[*receiver_neuron].receive_signal(T, signal_weights_[target]*codes[receiver_neuron - begin], delays[target] + bucket_delay);
 		}
+		return;
+	}
+	for (const std::uint32_t* receiver_neuron(begin) ; receiver_neuron != end ; ++receiver_neuron) {
+		const unsigned int target(population_of_[*receiver_neuron]);
+		const double weight(target == plastic_target ? plastic_weights[receiver_neuron - begin]*plastic_efficacy : signal_weights_[target]*codes[receiver_neuron - begin]);
+		neurons_[*receiver_neuron].receive_signal(T, weight, delays[target] + bucket_delay);
 	}
 }
 
-void Brain::add_connection(unsigned long transmitter_neuron, unsigned long receiver_neuron)
+bool Brain::add_connection(unsigned long transmitter_neuron, unsigned long receiver_neuron)
 {
-	if (transmitter_neuron<nb_neurons_ and receiver_neuron<nb_neurons_) {
-		network_[transmitter_neuron].push_back(receiver_neuron);
+	if (transmitter_neuron>=nb_neurons_ or receiver_neuron>=nb_neurons_ or stdp_.is_enabled()) {
+		return false;
+	}
+	//the connections shared with other brains are not modified
+	if (network_.use_count() > 1) {
+		network_ = std::make_shared<Connectivity>(*network_);
 	}
+	network_->add(transmitter_neuron, receiver_neuron);
+	return true;
+}
+
+bool Brain::enable_stdp(const StdpParameters& parameters)
+{
+	if (parameters.source >= populations_.size() or parameters.target >= populations_.size()) {
+		return false;
+	}
+	stdp_ = create_stdp(network_, parameters);
+	return true;
+}
+
+bool Brain::enable_short_term_plasticity(const ShortTermParameters& parameters)
+{
+	if (parameters.source >= populations_.size() or parameters.target >= populations_.size() or not (parameters.U > 0.0 and parameters.U <= 1.0)) {
+		return false;
+	}
+	const std::vector<unsigned long> first(first_neurons());
+	short_term_ = ShortTermPlasticity(first[parameters.source], first[parameters.source+1], dt_, parameters);
+	return true;
+}
+
+Stdp Brain::create_stdp(std::shared_ptr<const Connectivity> network, const StdpParameters& parameters) const
+{
+	const std::vector<unsigned long> first(first_neurons());
+	const double weight(weights_[parameters.source*populations_.size() + parameters.target]);
+	return Stdp(network, first[parameters.source], first[parameters.source+1], first[parameters.target], first[parameters.target+1], weight, dt_, parameters);
+}
+
+std::vector<unsigned long> Brain::first_neurons() const
+{
+	std::vector<unsigned long> first(1, 0);
+	for (const auto& population : populations_) {
+		first.push_back(first.back() + population.size);
+	}
+	return first;
 }
 
 unsigned int Brain::is_connected(unsigned long transmitter_neuron, unsigned long receiver_neuron) const
 {
 	unsigned int nb_connections(0);
 	
-	for (auto n : network_[transmitter_neuron]) {
-		if (n == receiver_neuron) {
+	for (const std::uint32_t* n(network_->begin(transmitter_neuron)) ; n != network_->end(transmitter_neuron) ; ++n) {
+		if (*n == receiver_neuron) {
 			++nb_connections;
 		}
 	}
@@ -141,6 +331,131 @@ unsigned int Brain::is_connected(unsigned long transmitter_neuron, unsigned long
 	return nb_connections;
 }
 
+void Brain::set_noise_seed(unsigned int seed)
+{
+	generator_.seed(seed);
+}
+
+void Brain::set_background_noise(BackgroundNoise noise)
+{
+	background_noise_ = noise;
+}
+
+void Brain::attach_recorder(Recorder* recorder)
+{
+	if (recorder != nullptr) {
+		recorders_.push_back(recorder);
+	}
+}
+
+void Brain::detach_recorder(Recorder* recorder)
+{
+	recorders_.erase(std::remove(recorders_.begin(), recorders_.end(), recorder), recorders_.end());
+}
+
+void Brain::save(std::ostream& out) const
+{
+	write_binary(out, time_);
+	
+	//the standard only defines the text format for the state of the generator
+	std::ostringstream generator;
+	generator << generator_;
+	const std::string generator_state(generator.str());
+	write_binary_vector(out, std::vector<char>(generator_state.begin(), generator_state.end()));
+	
+	write_binary(out, nb_neurons_);
+	for (const auto& neuron : neurons_) {
+		neuron.save(out);
+	}
+	
+	network_->write(out);
+	
+	write_binary(out, stdp_.is_enabled());
+	if (stdp_.is_enabled()) {
+		stdp_.save(out);
+	}
+	
+	write_binary(out, short_term_.is_enabled());
+	if (short_term_.is_enabled()) {
+		short_term_.save(out);
+	}
+}
+
+bool Brain::load(std::istream& in)
+{
+	unsigned long time;
+	std::vector<char> generator;
+	unsigned long nb_neurons;
+	if (not read_binary(in, time) or not read_binary_vector(in, generator, 1ul << 20) or not read_binary(in, nb_neurons) or nb_neurons != nb_neurons_) {
+		return false;
+	}
+	
+	for (auto& neuron : neurons_) {
+		if (not neuron.load(in)) {
+			return false;
+		}
+	}
+	
+	//the buffers of the neurons are made for the delays of the connections
+	std::shared_ptr<Connectivity> network(new Connectivity(nb_neurons_));
+	if (not network->read(in) or network->get_max_delay() != network_->get_max_delay()) {
+		return false;
+	}
+	//the connections read are a private copy, the current ones are kept if they are the same (they can be shared or mapped)
+	if (network->is_same(*network_)) {
+		network = network_;
+	}
+	
+	//the plastic weights of the connections read
+	bool plastic;
+	if (not read_binary(in, plastic) or plastic != stdp_.is_enabled()) {
+		return false;
+	}
+	Stdp stdp;
+	if (plastic) {
+		stdp = create_stdp(network, stdp_.get_parameters());
+		if (not stdp.load(in)) {
+			return false;
+		}
+	}
+	
+	//the states of the short-term plasticity
+	bool short_term;
+	if (not read_binary(in, short_term) or short_term != short_term_.is_enabled()) {
+		return false;
+	}
+	ShortTermPlasticity short_term_plasticity(short_term_);
+	if (short_term and not short_term_plasticity.load(in)) {
+		return false;
+	}
+	
+	std::istringstream generator_state(std::string(generator.begin(), generator.end()));
+	generator_state >> generator_;
+	if (generator_state.fail()) {
+		return false;
+	}
+	
+	time_ = time;
+	network_ = network;
+	stdp_ = stdp;
+	short_term_ = short_term_plasticity;
+	return true;
+}
+
+bool Brain::copy_state(const Brain& other)
+{
+	if (other.nb_neurons_ != nb_neurons_ or other.population_of_ != population_of_ or other.delays_ != delays_) {
+		return false;
+	}
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		if (not neurons_[i].copy_state(other.neurons_[i])) {
+			return false;
+		}
+	}
+	time_ = other.time_;
+	return true;
+}
+
 void Brain::print() const
 {	
 	for (unsigned int i(0); i<nb_neurons_ ; ++i) {
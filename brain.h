@@ -1,10 +1,18 @@
 #ifndef BRAIN_H
 #define BRAIN_H
 #include <iostream>
+#include <memory>
+#include <random>
 #include <vector>
+#include "connectivity.h"
+#include "gaussian_noise.h"
 #include "neuron.h"
+#include "population.h"
+#include "recorder.h"
+#include "short_term_plasticity.h"
+#include "stdp.h"
 
-class Brain {
+class Brain : public RecordedNetwork {
 	public:
 	///CONSTRUCTOR
 	/**
@@ -26,6 +34,38 @@ class Brain {
     */
 	Brain(unsigned long NE, unsigned long NI, unsigned long CE = 0, unsigned long CI = 0, double dt = 0.1, double v_ext = 2.0, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double Vthr = 20.0, double Vreset = 0.0, double JE = 1.0, double JI = -5.0, double J = 0.1, double TAU = 20, double R = 20.0);
 	
+	///CONSTRUCTOR with connections already created (they can be shared with other brains, a brain copies them before adding a connection).
+	/**
+      \param network contains the connections, the number of neurons is its number of neurons.
+      \param NE is the number of excitatory neurons wanted (the first NE neurons, at most the number of neurons of the network).
+      \param dt is the time step for each update in ms.
+      \param v_ext is the frequency of the external input needed to reach Vthr.
+      \param Delay_Steps is the delay for a neuron to transmit a signal in number of time steps.
+      \param Refractory_Time_Steps is the refractrory time for the neurons in number of time steps.
+      \param Vthr is the potential (mV) to exceed for a spike to appear.
+      \param Vreset is the initial and refractory potential (mV).
+      \param JE is the potential transmited when an excitatory neuron has a spike in number of J.
+      \param JI is the potential transmited when an inhibitory neuron has a spike in number of J.
+      \param J is the "potential step" transmitted between neurons in mV.
+      \param TAU is the membrane time constant (ms).
+      \param R is the neuron membrane resistance.
+    */
+	Brain(std::shared_ptr<Connectivity> network, unsigned long NE, double dt = 0.1, double v_ext = 2.0, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double Vthr = 20.0, double Vreset = 0.0, double JE = 1.0, double JI = -5.0, double J = 0.1, double TAU = 20, double R = 20.0);
+	
+	///CONSTRUCTOR with several populations of neurons (the two other constructors create N. Brunel's excitatory and inhibitory populations).
+	/**
+	  The neurons only keep a pointer to the parameters of their population, and a signal takes the weight and the
+	  delay of the projection from the population of its transmitter to the population of its receiver (a spike
+	  between two populations without projection has no effect). The delay of the connection, if the connections
+	  have delays (see Connectivity::set_delays()), is added to the delay of the projection, and its weight (see
+	  Connectivity::set_weights()) multiplies the weight of the projection.
+      \param network contains the connections, its number of neurons has to be the sum of the sizes of the populations (std::invalid_argument is thrown otherwise).
+      \param populations are the populations (at least one), the first one has the first neurons (it is the excitatory population for get_nb_excitatory()); they all have the same time step.
+      \param projections are the weights and the delays between the populations (at most one for each pair of populations).
+      \param v_ext is the frequency of the external input needed to reach Vthr.
+    */
+	Brain(std::shared_ptr<Connectivity> network, const std::vector<Population>& populations, const std::vector<Projection>& projections, double v_ext = 2.0);
+	
 		//getters
 	///getter for the number of neurons.
 	/**
@@ -45,6 +85,12 @@ class Brain {
 	*/
 	unsigned long get_nb_inhibitory() const;
 	
+	///getter for the populations.
+	/**
+	  \return the populations of neurons of the brain, in the order of their neurons.
+	*/
+	const std::vector<Population>& get_populations() const;
+	
 	///getter for a precise neuron.
 	/**
 	  \param neuron_index is the index of the neuron wanted.
@@ -52,6 +98,31 @@ class Brain {
 	*/
 	const Neuron& get_neuron(unsigned long neuron_index);
 	
+	///getter for the connections.
+	/**
+	  \return the connections of the brain.
+	*/
+	std::shared_ptr<const Connectivity> get_network() const;
+	
+	///getter for the plasticity of the connections (not enabled by default).
+	/**
+	  \return the plasticity, with the weights of the plastic connections.
+	*/
+	const Stdp& get_stdp() const;
+	
+	///getter for the short-term plasticity of the connections (not enabled by default).
+	/**
+	  \return the short-term plasticity, with the state of its transmitters.
+	*/
+	const ShortTermPlasticity& get_short_term_plasticity() const;
+	
+	///copies the membrane potentials of some neurons in an array.
+	/**
+	  \param neuron_indexes contains the indexes of the neurons wanted.
+	  \param membrane_potentials is the array (of size neuron_indexes.size()) which receives the membrane potentials in mV.
+	*/
+	void gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const override;
+	
 		//update
 	///updates every neurons with time T and handles the signals sent
 	/**
@@ -68,12 +139,15 @@ class Brain {
 	*/
 	void send_signals(unsigned long transmitter_neuron, unsigned long T);
 	
-	///create a connection between 2 given neurons.
+	///create a connection between 2 given neurons (without a delay of its own).
 	/**
+	  The connections can't change while the spike-timing-dependent plasticity is enabled: its weights and its
+	  transposed index are those of the connections it was created with.
 	  \param transmitter_neuron is the index of the transmitter neuron.
 	  \param receiver_neuron is the index of the receiver neuron.
+	  \return false if a neuron doesn't exist or the plasticity is enabled (the connection is not created).
 	*/
-	void add_connection(unsigned long transmitter_neuron, unsigned long receiver_neuron);
+	bool add_connection(unsigned long transmitter_neuron, unsigned long receiver_neuron);
 	
 	///returns the number of connections from a given transmitter neuron to a given receiver neuron.
 	/**
@@ -83,6 +157,76 @@ class Brain {
 	*/
 	unsigned int is_connected(unsigned long transmitter_neuron, unsigned long receiver_neuron) const;
 	
+	///enables the spike-timing-dependent plasticity of the connections between two populations (see Stdp).
+	/**
+	  The plastic connections start from the weight of their projection (times their weight in the connections)
+	  and the weights of the plasticity are used instead of it from then on.
+	  \param parameters are the parameters of the plasticity (the connections from the first population to itself by default, E->E in N. Brunel's network).
+	  \return false if the populations don't exist.
+	*/
+	bool enable_stdp(const StdpParameters& parameters = StdpParameters());
+	
+	///enables the short-term plasticity of the connections between two populations (see ShortTermPlasticity).
+	/**
+	  The state of a transmitter is computed once per spike and multiplies the weight of all its connections to
+	  the population (with the spike-timing-dependent plasticity too).
+	  \param parameters are the parameters of the plasticity (the connections from the first population to itself by default, E->E in N. Brunel's network).
+	  \return false if the populations don't exist or U is not in ]0,1].
+	*/
+	bool enable_short_term_plasticity(const ShortTermParameters& parameters = ShortTermParameters());
+	
+	///sets the seed of the background noise (by default it is random).
+	/**
+	  \param seed is the seed of the random generator of the background noise.
+	*/
+	void set_noise_seed(unsigned int seed);
+	
+	///chooses the kind of background noise (Poisson by default).
+	/**
+	  The Gaussian noise has the same mean and variance as the Poisson one and is drawn about 5 times faster,
+	  but the input is continuous (it can be negative) instead of a number of signals J: the network follows
+	  the diffusion approximation (see MeanField), which is better when v_ext is large. In the network of
+	  12500 neurons the rates differ by about 1% for ETA >= 2 and 4% at ETA = 0.9, the CV by less than 0.02,
+	  but the spectra are not the same in detail. Each step is 1.5 to 2 times faster.
+	  \param noise is the kind of background noise.
+	*/
+	void set_background_noise(BackgroundNoise noise);
+	
+	///attach a recorder which will be told about every spike and every end of update (the brain doesn't own it).
+	/**
+	  \param recorder is the recorder to attach.
+	*/
+	void attach_recorder(Recorder* recorder);
+	
+	///detach a recorder attached before.
+	/**
+	  \param recorder is the recorder to detach.
+	*/
+	void detach_recorder(Recorder* recorder);
+	
+	///writes the complete state of the brain (clock, random generator, neurons, connections and plastic weights) in a binary stream.
+	/**
+	  \param out is the stream.
+	*/
+	void save(std::ostream& out) const;
+	
+	///reads the state of the brain written by save() (the recorders and the parameters are not changed).
+	/**
+	  The connections are read in memory; the current ones (which can be shared with other brains or mapped) are
+	  kept if they are the same, otherwise the brain owns the ones read.
+	  \param in is the stream.
+	  \return true if the state could be read and has the same number of neurons, the same longest delay of the connections and the same plasticity (if false, the state of the brain is incomplete and it has to be loaded again before being used).
+	*/
+	bool load(std::istream& in);
+	
+	///takes the clock and the state of the neurons of another brain (its last state is the initial state of this one).
+	/**
+	  The connections, the parameters, the background noise and the recorders of this brain are kept.
+	  \param other is the brain copied.
+	  \return false if the brains don't have the same number of neurons or the same delays.
+	*/
+	bool copy_state(const Brain& other);
+	
 	///print on the terminal the time and for each neuron its number, its membrane potential and its number of spikes.
 	void print() const;
 	
@@ -90,23 +234,62 @@ class Brain {
 	~Brain();
 	
 	private:
+	///creates the plasticity of the connections of a network between two populations (which exist).
+	Stdp create_stdp(std::shared_ptr<const Connectivity> network, const StdpParameters& parameters) const;
+	
+	///delivers the signals of a spike to a bucket of receivers (the signal weights of the spike are in signal_weights_).
+	/**
+	  \param T is the time of the spike.
+	  \param begin and end are the receivers of the bucket.
+	  \param codes gives the code of the weight of each connection of the bucket (codes[k] for the receiver begin+k).
+	  \param delays are the delays of the projections from the population of the transmitter.
+	  \param bucket_delay is the delay of the connections of the bucket.
+	  \param plastic_weights are the plastic weights of the connections of the bucket (null if the transmitter has none).
+	  \param plastic_target is the population of the receivers of the plastic connections.
+	  \param plastic_efficacy multiplies the plastic weights (short-term plasticity).
+	*/
+	template<class Codes>
+	void send_bucket(unsigned long T, const std::uint32_t* begin, const std::uint32_t* end, const Codes& codes, const unsigned int* delays, unsigned int bucket_delay, const float* plastic_weights, unsigned int plastic_target, double plastic_efficacy);
+	
+	///index of the first neuron of each population (the neurons of a population have contiguous indexes), and the number of neurons at the end.
+	std::vector<unsigned long> first_neurons() const;
+	
 		//Parameters
 	const unsigned long nb_neurons_; /**< number of neurons */
-	const unsigned long NE_; /**< number of excitatory neurons */
+	const unsigned long NE_; /**< number of excitatory neurons (size of the first population) */
 	
 	const double dt_; /**< time step */
-	const unsigned int Delay_Steps_; /**< delay to receive a signal in number of time steps */
 	
 	const double v_ext_; /**< the frequency of the external input needed to reach Vthr */
 	
+		//Populations
+	const std::vector<Population> populations_; /**< populations of neurons, in the order of their neurons */
+	std::vector<unsigned int> population_of_; /**< index of the population of each neuron */
+	std::vector<double> weights_; /**< weight of the projection from the population s to the population t at s*populations_.size()+t (0 without projection) */
+	std::vector<unsigned int> delays_; /**< delay of the projections in number of time steps (same order as weights_) */
+	unsigned int min_delay_; /**< shortest delay of the projections (without the delays of the connections) */
+	std::vector<double> signal_weights_; /**< weight of the code 1 of the signals of the current spike to each population (with the scale of the codes and the short-term plasticity) */
+	
 		//Time
 	unsigned long time_; /**< clock */
 	
+		//Background noise
+	std::mt19937 generator_; /**< random generator of the background noise */
+	BackgroundNoise background_noise_; /**< kind of background noise */
+	GaussianNoise gaussian_noise_; /**< generator of the Gaussian background noise (mean and variance v_ext) */
+	std::vector<double> random_inputs_; /**< Gaussian background input of the current step */
+	
 		//Neurons
-	std::vector<Neuron> neurons_; /**< a vector containing every neurons: first the excitatory and second the inhibitory */
+	std::vector<Neuron> neurons_; /**< a vector containing every neurons: first the excitatory and second the inhibitory (in the order of the populations) */
 	
 		//Connections
-	std::vector<std::vector<unsigned long>> network_; /**< a vector containing for each neuron a vector with the index of the neurons they send signals to */
+	std::shared_ptr<Connectivity> network_; /**< for each neuron the indexes of the neurons they send signals to (can be shared with other brains) */
+	Stdp stdp_; /**< plasticity of the connections between two populations (not enabled by default) */
+	std::vector<unsigned long> spiking_neurons_; /**< neurons which spiked during the current step (given to the plasticity at the end of the step) */
+	ShortTermPlasticity short_term_; /**< short-term plasticity of the connections between two populations (not enabled by default) */
+	
+		//Recorders
+	std::vector<Recorder*> recorders_; /**< the recorders attached to the brain (empty by default) */
 };
 
 #endif
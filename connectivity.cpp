@@ -0,0 +1,697 @@
+#include "connectivity.h"
+#include "binary_io.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const std::uint64_t Magic(0x4e434c454e555242ull); //"BRUNELCN"
+const std::uint64_t Version(3);
+
+///puts the values of the connections of a neuron in a new order.
+/**
+  \param values are the values of all the connections (an empty array is left empty).
+  \param first is the index of the first connection of the neuron.
+  \param order contains the old index (from first) of each new connection.
+*/
+template<class Value>
+void reorder(std::vector<Value>& values, unsigned long first, const std::vector<unsigned long>& order)
+{
+	if (values.empty()) {
+		return;
+	}
+	std::vector<Value> old(values.begin() + first, values.begin() + first + order.size());
+	for (unsigned long k(0) ; k<order.size() ; ++k) {
+		values[first + k] = old[order[k]];
+	}
+}
+
+///says if an array of offsets starts at 0, never decreases and ends at a size.
+bool valid_offsets(const std::uint64_t* offsets, unsigned long nb_offsets, unsigned long size)
+{
+	if (offsets[0] != 0 or offsets[nb_offsets-1] != size) {
+		return false;
+	}
+	for (unsigned long k(1) ; k<nb_offsets ; ++k) {
+		if (offsets[k] < offsets[k-1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+///checks the arrays read from a file, so that the connections can be used without any other check.
+/**
+  The offsets and the bucket offsets have to be sorted, the receivers have to be neurons and the buckets of a
+  neuron have to hold exactly its receivers, with increasing delays and at least one receiver each.
+*/
+bool valid_arrays(unsigned long nb_neurons, unsigned long nb_connections, unsigned long nb_buckets, const std::uint64_t* offsets, const std::uint32_t* receivers, const std::uint64_t* bucket_offsets, const std::uint64_t* bucket_starts, const std::uint32_t* bucket_delays)
+{
+	if (not valid_offsets(offsets, nb_neurons+1, nb_connections)) {
+		return false;
+	}
+	for (unsigned long k(0) ; k<nb_connections ; ++k) {
+		if (receivers[k] >= nb_neurons) {
+			return false;
+		}
+	}
+	if (nb_buckets == 0) {
+		return true;
+	}
+	if (not valid_offsets(bucket_offsets, nb_neurons+1, nb_buckets) or not valid_offsets(bucket_starts, nb_buckets+1, nb_connections)) {
+		return false;
+	}
+	for (unsigned long i(0) ; i<nb_neurons ; ++i) {
+		if (bucket_starts[bucket_offsets[i]] != offsets[i]) {
+			return false;
+		}
+		for (unsigned long b(bucket_offsets[i]) ; b<bucket_offsets[i+1] ; ++b) {
+			if (bucket_starts[b+1] == bucket_starts[b] or (b > bucket_offsets[i] and bucket_delays[b] <= bucket_delays[b-1])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+Connectivity::Connectivity(unsigned long nb_neurons)
+: nb_neurons_(nb_neurons), owned_offsets_(nb_neurons+1, 0)
+, offsets_(owned_offsets_.data()), receivers_(owned_receivers_.data())
+, nb_buckets_(0), bucket_offsets_(nullptr), bucket_starts_(nullptr), bucket_delays_(nullptr)
+, weight_bits_(0), weight_scale_(1.0), weight_codes_8_(nullptr), weight_codes_16_(nullptr)
+, mapping_(nullptr), mapping_size_(0)
+{}
+
+Connectivity::Connectivity(const Connectivity& other)
+: nb_neurons_(other.nb_neurons_)
+, owned_offsets_(other.offsets_, other.offsets_ + other.nb_neurons_+1)
+, owned_receivers_(other.receivers_, other.receivers_ + other.get_nb_connections())
+, nb_buckets_(other.nb_buckets_)
+, weight_bits_(other.weight_bits_), weight_scale_(other.weight_scale_)
+, mapping_(nullptr), mapping_size_(0)
+{
+	if (nb_buckets_ > 0) {
+		owned_bucket_offsets_.assign(other.bucket_offsets_, other.bucket_offsets_ + nb_neurons_+1);
+		owned_bucket_starts_.assign(other.bucket_starts_, other.bucket_starts_ + nb_buckets_+1);
+		owned_bucket_delays_.assign(other.bucket_delays_, other.bucket_delays_ + nb_buckets_);
+	}
+	if (weight_bits_ == 8) {
+		owned_weight_codes_8_.assign(other.weight_codes_8_, other.weight_codes_8_ + get_nb_connections());
+	} else if (weight_bits_ == 16) {
+		owned_weight_codes_16_.assign(other.weight_codes_16_, other.weight_codes_16_ + get_nb_connections());
+	}
+	use_owned_arrays();
+}
+
+std::shared_ptr<Connectivity> Connectivity::random(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, unsigned int seed)
+{
+	const unsigned long nb_neurons(NE + NI);
+	std::shared_ptr<Connectivity> network(new Connectivity(nb_neurons));
+	std::vector<std::uint64_t>& offsets(network->owned_offsets_);
+	std::vector<std::uint32_t>& receivers(network->owned_receivers_);
+
+	std::uniform_int_distribution<> random_excitatory(0, NE-1);
+	std::uniform_int_distribution<> random_inhibitory(NE, nb_neurons-1);
+
+	//the connections are drawn twice with the same seed: first to count the receivers of each neuron, then to place them
+	for (unsigned int pass(0) ; pass<2 ; ++pass) {
+		std::mt19937 generator(seed);
+		random_excitatory.reset();
+		random_inhibitory.reset();
+		for (unsigned long i(0) ; i<nb_neurons ; ++i) {
+			//creation of CE random connections between the receiver neuron (i) and excitatory neurons (random)
+			for (unsigned long k(0) ; k<CE ; ++k) {
+				unsigned long transmitter(random_excitatory(generator));
+				if (pass == 0) {
+					++offsets[transmitter+1];
+				} else {
+					receivers[offsets[transmitter]++] = i;
+				}
+			}
+			//creation of CI random connections between the receiver neuron (i) and inhibitory neurons (random)
+			for (unsigned long k(0) ; k<CI ; ++k) {
+				unsigned long transmitter(random_inhibitory(generator));
+				if (pass == 0) {
+					++offsets[transmitter+1];
+				} else {
+					receivers[offsets[transmitter]++] = i;
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (unsigned long i(0) ; i<nb_neurons ; ++i) {
+				offsets[i+1] += offsets[i];
+			}
+			receivers.resize(offsets[nb_neurons]);
+		} else {
+			//offsets[i] now points at the end of the receivers of i, which is the beginning of the receivers of i+1
+			for (unsigned long i(nb_neurons) ; i>0 ; --i) {
+				offsets[i] = offsets[i-1];
+			}
+			offsets[0] = 0;
+		}
+	}
+
+	network->use_owned_arrays();
+	return network;
+}
+
+std::string Connectivity::cache_file_name(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, unsigned int seed, const std::string& directory)
+{
+	return directory + "/connectivity_fixed_indegree_" + std::to_string(NE) + "_" + std::to_string(NI) + "_" + std::to_string(CE) + "_" + std::to_string(CI) + "_" + std::to_string(seed) + ".bin";
+}
+
+std::shared_ptr<Connectivity> Connectivity::cached_random(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, unsigned int seed, const std::string& directory)
+{
+	const std::string file_name(cache_file_name(NE, NI, CE, CI, seed, directory));
+	const std::vector<std::uint64_t> key({NE, NI, CE, CI, seed});
+
+	std::shared_ptr<Connectivity> network(map(file_name));
+	if (network != nullptr) {
+		const Header* header(static_cast<const Header*>(network->mapping_));
+		if (std::vector<std::uint64_t>(header->key, header->key+5) == key) {
+			return network;
+		}
+	}
+
+	network = random(NE, NI, CE, CI, seed);
+	if (network->save(file_name, key)) {
+		//the file is mapped so that the memory is shared with the other processes using the cache
+		std::shared_ptr<Connectivity> mapped(map(file_name));
+		if (mapped != nullptr) {
+			return mapped;
+		}
+	}
+	return network;
+}
+
+std::shared_ptr<Connectivity> Connectivity::map(const std::string& file_name)
+{
+	int file(open(file_name.c_str(), O_RDONLY));
+	if (file < 0) {
+		return nullptr;
+	}
+	struct stat status;
+	if (fstat(file, &status) != 0 or static_cast<unsigned long>(status.st_size) < sizeof(Header)) {
+		close(file);
+		return nullptr;
+	}
+	const unsigned long size(status.st_size);
+	void* mapping(mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0));
+	close(file);
+	if (mapping == MAP_FAILED) {
+		return nullptr;
+	}
+
+	//the arrays of 8 bytes are before the arrays of 4 bytes, then 2 or 1 byte, so that they are all aligned
+	//(the numbers of the header are first compared with the size, so that the expected size can't overflow)
+	const Header* header(static_cast<const Header*>(mapping));
+	if (header->nb_neurons >= size/sizeof(std::uint64_t) or header->nb_connections > size/sizeof(std::uint32_t) or header->nb_buckets > header->nb_connections
+		or (header->weight_bits != 0 and header->weight_bits != 8 and header->weight_bits != 16)) {
+		munmap(mapping, size);
+		return nullptr;
+	}
+	const unsigned long nb_bucket_offsets(header->nb_buckets > 0 ? (header->nb_neurons+1) + (header->nb_buckets+1) : 0);
+	const unsigned long expected_size(sizeof(Header) + (header->nb_neurons+1 + nb_bucket_offsets)*sizeof(std::uint64_t) + (header->nb_connections + header->nb_buckets)*sizeof(std::uint32_t) + header->nb_connections*(header->weight_bits/8));
+	if (header->magic != Magic or header->version != Version or size != expected_size) {
+		munmap(mapping, size);
+		return nullptr;
+	}
+	const std::uint64_t* offsets(reinterpret_cast<const std::uint64_t*>(header+1));
+	const std::uint64_t* bucket_offsets(header->nb_buckets > 0 ? offsets + header->nb_neurons+1 : nullptr);
+	const std::uint64_t* bucket_starts(header->nb_buckets > 0 ? bucket_offsets + header->nb_neurons+1 : nullptr);
+	const std::uint32_t* receivers(reinterpret_cast<const std::uint32_t*>(header->nb_buckets > 0 ? bucket_starts + header->nb_buckets+1 : offsets + header->nb_neurons+1));
+	if (not valid_arrays(header->nb_neurons, header->nb_connections, header->nb_buckets, offsets, receivers, bucket_offsets, bucket_starts, receivers + header->nb_connections)) {
+		munmap(mapping, size);
+		return nullptr;
+	}
+
+	std::shared_ptr<Connectivity> network(new Connectivity(0));
+	network->nb_neurons_ = header->nb_neurons;
+	network->owned_offsets_.clear();
+	network->offsets_ = offsets;
+	network->receivers_ = receivers;
+	network->nb_buckets_ = header->nb_buckets;
+	if (network->nb_buckets_ > 0) {
+		network->bucket_offsets_ = bucket_offsets;
+		network->bucket_starts_ = bucket_starts;
+		network->bucket_delays_ = receivers + header->nb_connections;
+	}
+	network->weight_bits_ = header->weight_bits;
+	network->weight_scale_ = header->weight_scale;
+	const void* weight_codes(network->receivers_ + header->nb_connections + header->nb_buckets);
+	if (network->weight_bits_ == 8) {
+		network->weight_codes_8_ = static_cast<const std::uint8_t*>(weight_codes);
+	} else if (network->weight_bits_ == 16) {
+		network->weight_codes_16_ = static_cast<const std::uint16_t*>(weight_codes);
+	}
+	network->mapping_ = mapping;
+	network->mapping_size_ = size;
+	return network;
+}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long Connectivity::get_nb_neurons() const
+{
+	return nb_neurons_;
+}
+
+unsigned long Connectivity::get_nb_connections() const
+{
+	return offsets_[nb_neurons_];
+}
+
+bool Connectivity::is_mapped() const
+{
+	return mapping_ != nullptr;
+}
+
+bool Connectivity::is_same(const Connectivity& other) const
+{
+	if (nb_neurons_ != other.nb_neurons_ or get_nb_connections() != other.get_nb_connections() or nb_buckets_ != other.nb_buckets_
+		or weight_bits_ != other.weight_bits_ or weight_scale_ != other.weight_scale_) {
+		return false;
+	}
+	const unsigned long nb_connections(get_nb_connections());
+	if (not std::equal(offsets_, offsets_ + nb_neurons_+1, other.offsets_) or not std::equal(receivers_, receivers_ + nb_connections, other.receivers_)) {
+		return false;
+	}
+	if (nb_buckets_ > 0 and (not std::equal(bucket_offsets_, bucket_offsets_ + nb_neurons_+1, other.bucket_offsets_)
+		or not std::equal(bucket_starts_, bucket_starts_ + nb_buckets_+1, other.bucket_starts_)
+		or not std::equal(bucket_delays_, bucket_delays_ + nb_buckets_, other.bucket_delays_))) {
+		return false;
+	}
+	if (weight_bits_ == 8) {
+		return std::equal(weight_codes_8_, weight_codes_8_ + nb_connections, other.weight_codes_8_);
+	} else if (weight_bits_ == 16) {
+		return std::equal(weight_codes_16_, weight_codes_16_ + nb_connections, other.weight_codes_16_);
+	}
+	return true;
+}
+
+const std::uint32_t* Connectivity::begin(unsigned long transmitter_neuron) const
+{
+	return receivers_ + offsets_[transmitter_neuron];
+}
+
+const std::uint32_t* Connectivity::end(unsigned long transmitter_neuron) const
+{
+	return receivers_ + offsets_[transmitter_neuron+1];
+}
+
+unsigned long Connectivity::get_nb_receivers(unsigned long transmitter_neuron) const
+{
+	return offsets_[transmitter_neuron+1] - offsets_[transmitter_neuron];
+}
+
+bool Connectivity::has_delays() const
+{
+	return nb_buckets_ > 0;
+}
+
+unsigned long Connectivity::get_nb_buckets(unsigned long transmitter_neuron) const
+{
+	if (nb_buckets_ == 0) {
+		return 1;
+	}
+	return bucket_offsets_[transmitter_neuron+1] - bucket_offsets_[transmitter_neuron];
+}
+
+unsigned int Connectivity::get_bucket_delay(unsigned long transmitter_neuron, unsigned long bucket) const
+{
+	if (nb_buckets_ == 0) {
+		return 0;
+	}
+	return bucket_delays_[bucket_offsets_[transmitter_neuron] + bucket];
+}
+
+const std::uint32_t* Connectivity::bucket_begin(unsigned long transmitter_neuron, unsigned long bucket) const
+{
+	if (nb_buckets_ == 0) {
+		return begin(transmitter_neuron);
+	}
+	return receivers_ + bucket_starts_[bucket_offsets_[transmitter_neuron] + bucket];
+}
+
+const std::uint32_t* Connectivity::bucket_end(unsigned long transmitter_neuron, unsigned long bucket) const
+{
+	if (nb_buckets_ == 0) {
+		return end(transmitter_neuron);
+	}
+	return receivers_ + bucket_starts_[bucket_offsets_[transmitter_neuron] + bucket + 1];
+}
+
+unsigned int Connectivity::get_min_delay() const
+{
+	return nb_buckets_ > 0 ? *std::min_element(bucket_delays_, bucket_delays_ + nb_buckets_) : 0;
+}
+
+unsigned int Connectivity::get_max_delay() const
+{
+	return nb_buckets_ > 0 ? *std::max_element(bucket_delays_, bucket_delays_ + nb_buckets_) : 0;
+}
+
+std::vector<std::uint32_t> Connectivity::get_delays() const
+{
+	std::vector<std::uint32_t> delays(get_nb_connections(), 0);
+	for (unsigned long b(0) ; b<nb_buckets_ ; ++b) {
+		std::fill(delays.begin() + bucket_starts_[b], delays.begin() + bucket_starts_[b+1], bucket_delays_[b]);
+	}
+	return delays;
+}
+
+bool Connectivity::has_weights() const
+{
+	return weight_bits_ > 0;
+}
+
+unsigned int Connectivity::get_weight_bits() const
+{
+	return weight_bits_;
+}
+
+double Connectivity::get_weight_scale() const
+{
+	return weight_scale_;
+}
+
+const std::uint8_t* Connectivity::weight_codes_8(unsigned long transmitter_neuron, unsigned long bucket) const
+{
+	if (weight_codes_8_ == nullptr) {
+		return nullptr;
+	}
+	return weight_codes_8_ + (bucket_begin(transmitter_neuron, bucket) - receivers_);
+}
+
+const std::uint16_t* Connectivity::weight_codes_16(unsigned long transmitter_neuron, unsigned long bucket) const
+{
+	if (weight_codes_16_ == nullptr) {
+		return nullptr;
+	}
+	return weight_codes_16_ + (bucket_begin(transmitter_neuron, bucket) - receivers_);
+}
+
+double Connectivity::get_weight(unsigned long connection) const
+{
+	if (weight_codes_8_ != nullptr) {
+		return weight_scale_*weight_codes_8_[connection];
+	} else if (weight_codes_16_ != nullptr) {
+		return weight_scale_*weight_codes_16_[connection];
+	}
+	return 1.0;
+}
+
+std::vector<double> Connectivity::get_weights() const
+{
+	std::vector<double> weights(get_nb_connections());
+	for (unsigned long k(0) ; k<weights.size() ; ++k) {
+		weights[k] = get_weight(k);
+	}
+	return weights;
+}
+
+//-------------------------------SETTERS------------------------------//
+void Connectivity::add(unsigned long transmitter_neuron, unsigned long receiver_neuron)
+{
+	own();
+	//the new connection has no delay (the buckets are made again) and the weight 1 (or the largest one)
+	std::vector<std::uint32_t> delays;
+	if (nb_buckets_ > 0) {
+		delays = get_delays();
+		delays.insert(delays.begin() + owned_offsets_[transmitter_neuron+1], 0);
+	}
+	if (weight_bits_ > 0) {
+		const double code(std::min(std::round(1.0/weight_scale_), std::ldexp(1.0, weight_bits_) - 1));
+		if (weight_bits_ == 8) {
+			owned_weight_codes_8_.insert(owned_weight_codes_8_.begin() + owned_offsets_[transmitter_neuron+1], code);
+		} else {
+			owned_weight_codes_16_.insert(owned_weight_codes_16_.begin() + owned_offsets_[transmitter_neuron+1], code);
+		}
+		use_owned_arrays();
+	}
+	owned_receivers_.insert(owned_receivers_.begin() + owned_offsets_[transmitter_neuron+1], receiver_neuron);
+	for (unsigned long i(transmitter_neuron+1) ; i<=nb_neurons_ ; ++i) {
+		++owned_offsets_[i];
+	}
+	receivers_ = owned_receivers_.data();
+	if (nb_buckets_ > 0) {
+		set_delays(delays);
+	}
+}
+
+bool Connectivity::set_delays(const std::vector<std::uint32_t>& delays)
+{
+	if (delays.size() != get_nb_connections()) {
+		return false;
+	}
+	own();
+
+	std::vector<std::uint64_t> bucket_offsets(nb_neurons_+1, 0);
+	std::vector<std::uint64_t> bucket_starts;
+	std::vector<std::uint32_t> bucket_delays;
+	std::vector<unsigned long> order; //old index of the connections of a neuron sorted by delay
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		const unsigned long first(owned_offsets_[i]);
+		order.resize(owned_offsets_[i+1] - first);
+		for (unsigned long k(0) ; k<order.size() ; ++k) {
+			order[k] = k;
+		}
+		//the receivers keep their order in each bucket, and their weights follow them
+		std::stable_sort(order.begin(), order.end(), [&](unsigned long a, unsigned long b) {
+			return delays[first + a] < delays[first + b];
+		});
+		reorder(owned_receivers_, first, order);
+		reorder(owned_weight_codes_8_, first, order);
+		reorder(owned_weight_codes_16_, first, order);
+		for (unsigned long k(0) ; k<order.size() ; ++k) {
+			if (k == 0 or delays[first + order[k]] != delays[first + order[k-1]]) {
+				bucket_starts.push_back(first + k);
+				bucket_delays.push_back(delays[first + order[k]]);
+			}
+		}
+		bucket_offsets[i+1] = bucket_delays.size();
+	}
+	bucket_starts.push_back(get_nb_connections());
+
+	nb_buckets_ = bucket_delays.size();
+	owned_bucket_offsets_.swap(bucket_offsets);
+	owned_bucket_starts_.swap(bucket_starts);
+	owned_bucket_delays_.swap(bucket_delays);
+	use_owned_arrays();
+	return true;
+}
+
+bool Connectivity::set_random_delays(unsigned int min_delay, unsigned int max_delay, unsigned int seed)
+{
+	if (min_delay > max_delay) {
+		return false;
+	}
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<std::uint32_t> random_delay(min_delay, max_delay);
+	std::vector<std::uint32_t> delays(get_nb_connections());
+	for (auto& delay : delays) {
+		delay = random_delay(generator);
+	}
+	return set_delays(delays);
+}
+
+bool Connectivity::set_weights(const std::vector<double>& weights, unsigned int bits)
+{
+	if (weights.size() != get_nb_connections() or (bits != 8 and bits != 16) or (not weights.empty() and *std::min_element(weights.begin(), weights.end()) < 0.0)) {
+		return false;
+	}
+	own();
+
+	//the largest weight has the largest code
+	const double largest_code(std::ldexp(1.0, bits) - 1);
+	const double largest_weight(weights.empty() ? 0.0 : *std::max_element(weights.begin(), weights.end()));
+	weight_scale_ = largest_weight > 0.0 ? largest_weight/largest_code : 1.0;
+	weight_bits_ = bits;
+	owned_weight_codes_8_.clear();
+	owned_weight_codes_16_.clear();
+	for (auto weight : weights) {
+		const double code(std::min(std::round(weight/weight_scale_), largest_code));
+		if (bits == 8) {
+			owned_weight_codes_8_.push_back(code);
+		} else {
+			owned_weight_codes_16_.push_back(code);
+		}
+	}
+	use_owned_arrays();
+	return true;
+}
+
+bool Connectivity::set_random_weights(double spread, unsigned int bits, unsigned int seed)
+{
+	if (not (spread >= 0.0 and spread <= 1.0)) {
+		return false;
+	}
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<> random_weight(1.0 - spread, 1.0 + spread);
+	std::vector<double> weights(get_nb_connections());
+	for (auto& weight : weights) {
+		weight = random_weight(generator);
+	}
+	return set_weights(weights, bits);
+}
+
+void Connectivity::own()
+{
+	if (mapping_ == nullptr) {
+		return;
+	}
+	owned_offsets_.assign(offsets_, offsets_ + nb_neurons_+1);
+	owned_receivers_.assign(receivers_, receivers_ + get_nb_connections());
+	if (nb_buckets_ > 0) {
+		owned_bucket_offsets_.assign(bucket_offsets_, bucket_offsets_ + nb_neurons_+1);
+		owned_bucket_starts_.assign(bucket_starts_, bucket_starts_ + nb_buckets_+1);
+		owned_bucket_delays_.assign(bucket_delays_, bucket_delays_ + nb_buckets_);
+	}
+	if (weight_bits_ == 8) {
+		owned_weight_codes_8_.assign(weight_codes_8_, weight_codes_8_ + get_nb_connections());
+	} else if (weight_bits_ == 16) {
+		owned_weight_codes_16_.assign(weight_codes_16_, weight_codes_16_ + get_nb_connections());
+	}
+	use_owned_arrays();
+	munmap(mapping_, mapping_size_);
+	mapping_ = nullptr;
+	mapping_size_ = 0;
+}
+
+void Connectivity::use_owned_arrays()
+{
+	offsets_ = owned_offsets_.data();
+	receivers_ = owned_receivers_.data();
+	bucket_offsets_ = owned_bucket_offsets_.data();
+	bucket_starts_ = owned_bucket_starts_.data();
+	bucket_delays_ = owned_bucket_delays_.data();
+	weight_codes_8_ = weight_bits_ == 8 ? owned_weight_codes_8_.data() : nullptr;
+	weight_codes_16_ = weight_bits_ == 16 ? owned_weight_codes_16_.data() : nullptr;
+}
+
+//--------------------------------FILES-------------------------------//
+bool Connectivity::save(const std::string& file_name, const std::vector<std::uint64_t>& key) const
+{
+	const std::string temporary_name(file_name + ".tmp." + std::to_string(getpid()));
+	std::ofstream file(temporary_name, std::ios::binary);
+	if (not file.is_open()) {
+		return false;
+	}
+
+	Header header({Magic, Version, {0, 0, 0, 0, 0}, nb_neurons_, get_nb_connections(), nb_buckets_, weight_bits_, weight_scale_});
+	for (unsigned int k(0) ; k<5 and k<key.size() ; ++k) {
+		header.key[k] = key[k];
+	}
+	write_binary(file, header);
+	file.write(reinterpret_cast<const char*>(offsets_), (nb_neurons_+1)*sizeof(std::uint64_t));
+	if (nb_buckets_ > 0) {
+		file.write(reinterpret_cast<const char*>(bucket_offsets_), (nb_neurons_+1)*sizeof(std::uint64_t));
+		file.write(reinterpret_cast<const char*>(bucket_starts_), (nb_buckets_+1)*sizeof(std::uint64_t));
+	}
+	file.write(reinterpret_cast<const char*>(receivers_), get_nb_connections()*sizeof(std::uint32_t));
+	file.write(reinterpret_cast<const char*>(bucket_delays_), nb_buckets_*sizeof(std::uint32_t));
+	write_weight_codes(file);
+	file.close();
+
+	//the file appears complete for the other processes
+	if (not file.good() or std::rename(temporary_name.c_str(), file_name.c_str()) != 0) {
+		std::remove(temporary_name.c_str());
+		return false;
+	}
+	return true;
+}
+
+void Connectivity::write(std::ostream& out) const
+{
+	write_binary(out, static_cast<std::uint64_t>(nb_neurons_));
+	write_binary(out, static_cast<std::uint64_t>(get_nb_connections()));
+	write_binary(out, static_cast<std::uint64_t>(nb_buckets_));
+	out.write(reinterpret_cast<const char*>(offsets_), (nb_neurons_+1)*sizeof(std::uint64_t));
+	out.write(reinterpret_cast<const char*>(receivers_), get_nb_connections()*sizeof(std::uint32_t));
+	if (nb_buckets_ > 0) {
+		out.write(reinterpret_cast<const char*>(bucket_offsets_), (nb_neurons_+1)*sizeof(std::uint64_t));
+		out.write(reinterpret_cast<const char*>(bucket_starts_), (nb_buckets_+1)*sizeof(std::uint64_t));
+		out.write(reinterpret_cast<const char*>(bucket_delays_), nb_buckets_*sizeof(std::uint32_t));
+	}
+	write_binary(out, static_cast<std::uint64_t>(weight_bits_));
+	write_binary(out, weight_scale_);
+	write_weight_codes(out);
+}
+
+void Connectivity::write_weight_codes(std::ostream& out) const
+{
+	if (weight_bits_ == 8) {
+		out.write(reinterpret_cast<const char*>(weight_codes_8_), get_nb_connections()*sizeof(std::uint8_t));
+	} else if (weight_bits_ == 16) {
+		out.write(reinterpret_cast<const char*>(weight_codes_16_), get_nb_connections()*sizeof(std::uint16_t));
+	}
+}
+
+bool Connectivity::read(std::istream& in)
+{
+	//the sizes are checked before the arrays are allocated, and these are read by blocks:
+	//a corrupted number of connections makes the reading fail at the end of the stream
+	std::uint64_t nb_neurons, nb_connections, nb_buckets;
+	if (not read_binary(in, nb_neurons) or nb_neurons != nb_neurons_ or not read_binary(in, nb_connections) or not read_binary(in, nb_buckets) or nb_buckets > nb_connections) {
+		return false;
+	}
+	std::vector<std::uint64_t> offsets;
+	if (not read_binary_array(in, offsets, nb_neurons+1) or not valid_offsets(offsets.data(), nb_neurons+1, nb_connections)) {
+		return false;
+	}
+	std::vector<std::uint32_t> receivers;
+	if (not read_binary_array(in, receivers, nb_connections)) {
+		return false;
+	}
+	std::vector<std::uint64_t> bucket_offsets, bucket_starts;
+	std::vector<std::uint32_t> bucket_delays;
+	if (nb_buckets > 0 and not (read_binary_array(in, bucket_offsets, nb_neurons+1) and read_binary_array(in, bucket_starts, nb_buckets+1) and read_binary_array(in, bucket_delays, nb_buckets))) {
+		return false;
+	}
+	if (not valid_arrays(nb_neurons, nb_connections, nb_buckets, offsets.data(), receivers.data(), bucket_offsets.data(), bucket_starts.data(), bucket_delays.data())) {
+		return false;
+	}
+	std::uint64_t weight_bits;
+	double weight_scale;
+	if (not read_binary(in, weight_bits) or not read_binary(in, weight_scale) or (weight_bits != 0 and weight_bits != 8 and weight_bits != 16)) {
+		return false;
+	}
+	std::vector<std::uint8_t> weight_codes_8;
+	std::vector<std::uint16_t> weight_codes_16;
+	if (not read_binary_array(in, weight_codes_8, weight_bits == 8 ? nb_connections : 0) or not read_binary_array(in, weight_codes_16, weight_bits == 16 ? nb_connections : 0)) {
+		return false;
+	}
+
+	own();
+	owned_offsets_.swap(offsets);
+	owned_receivers_.swap(receivers);
+	owned_bucket_offsets_.swap(bucket_offsets);
+	owned_bucket_starts_.swap(bucket_starts);
+	owned_bucket_delays_.swap(bucket_delays);
+	nb_buckets_ = nb_buckets;
+	owned_weight_codes_8_.swap(weight_codes_8);
+	owned_weight_codes_16_.swap(weight_codes_16);
+	weight_bits_ = weight_bits;
+	weight_scale_ = weight_scale;
+	use_owned_arrays();
+	return true;
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+Connectivity::~Connectivity()
+{
+	if (mapping_ != nullptr) {
+		munmap(mapping_, mapping_size_);
+	}
+}
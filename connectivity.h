@@ -0,0 +1,284 @@
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+///the connections of a brain in compressed sparse row format.
+/**
+  The receivers of the neuron i are receivers[offsets[i]] to receivers[offsets[i+1]-1].
+  The arrays are either owned by the object or mapped read-only from a cache file, which lets several
+  processes share one copy of the connections in the page cache.
+  The connections can have their own delays (see set_delays()), which are added to the delay of the brain
+  (Brain and FastBrain use them, the other networks don't). The receivers of each neuron are then sorted by
+  delay and grouped in buckets of receivers with the same delay, in a second compressed sparse row: the
+  buckets of the neuron i are bucket_offsets[i] to bucket_offsets[i+1]-1, and the receivers of the bucket b
+  are receivers[bucket_starts[b]] to receivers[bucket_starts[b+1]-1]. A spike is then delivered bucket by
+  bucket, each bucket into the signals of one future step.
+  The connections can also have their own weights (see set_weights()), which multiply the weight of the
+  brain (JE, JI or the weight of a projection). They are stored as codes of 8 or 16 bits in an array parallel to
+  the receivers, and the weight of a connection is its code times the unit given by get_weight_scale(): a brain
+  multiplies the weight of each projection by the unit once, and each signal by the code of its connection, so
+  the delivery reads 1 or 2 bytes per connection more than without weights instead of 8 for a double.
+*/
+class Connectivity {
+	public:
+	///CONSTRUCTOR (no connections)
+	/**
+      \param nb_neurons is the number of neurons.
+    */
+	Connectivity(unsigned long nb_neurons);
+
+	///COPY CONSTRUCTOR (the copy always owns its arrays)
+	Connectivity(const Connectivity& other);
+
+	Connectivity& operator=(const Connectivity&) = delete;
+
+	///creates the random connections of the Brunel model: each neuron receives CE connections from random excitatory neurons and CI from random inhibitory neurons.
+	/**
+      \param NE is the number of excitatory neurons (indexes from 0 to NE-1).
+      \param NI is the number of inhibitory neurons (indexes from NE to NE+NI-1).
+      \param CE is the number of excitatory connections received by each neuron.
+      \param CI is the number of inhibitory connections received by each neuron.
+      \param seed is the seed of the random generator (the same seed gives the same connections).
+      \return the connections.
+    */
+	static std::shared_ptr<Connectivity> random(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, unsigned int seed);
+
+	///maps the random connections from the cache if they have already been created, otherwise creates them and saves them in the cache.
+	/**
+      \param NE is the number of excitatory neurons.
+      \param NI is the number of inhibitory neurons.
+      \param CE is the number of excitatory connections received by each neuron.
+      \param CI is the number of inhibitory connections received by each neuron.
+      \param seed is the seed of the random generator.
+      \param directory is the directory of the cache.
+      \return the connections (created in memory if the cache can't be used).
+    */
+	static std::shared_ptr<Connectivity> cached_random(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, unsigned int seed, const std::string& directory);
+
+	///gives the name of the cache file for a set of parameters.
+	/**
+      \return the name of the file (in the directory given) for the random connections with these parameters.
+    */
+	static std::string cache_file_name(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, unsigned int seed, const std::string& directory);
+
+	///maps read-only the connections saved in a file.
+	/**
+	  The arrays are checked (the offsets are sorted and the receivers are neurons), which reads the whole file once.
+      \param file_name is the name of the file written by save().
+      \return the connections, or a null pointer if the file can't be mapped or is not valid.
+    */
+	static std::shared_ptr<Connectivity> map(const std::string& file_name);
+
+		//getters
+	///getter for the number of neurons.
+	unsigned long get_nb_neurons() const;
+
+	///getter for the number of connections.
+	unsigned long get_nb_connections() const;
+
+	///says if the arrays are mapped from a file.
+	bool is_mapped() const;
+
+	///says if two networks have the same connections (the same receivers in the same order, delays and weights).
+	/**
+      \param other is the other network.
+    */
+	bool is_same(const Connectivity& other) const;
+
+	///getter for the first receiver of a neuron.
+	/**
+      \param transmitter_neuron is the index of the transmitter neuron.
+      \return a pointer to its first receiver.
+    */
+	const std::uint32_t* begin(unsigned long transmitter_neuron) const;
+
+	///getter for the end of the receivers of a neuron.
+	/**
+      \param transmitter_neuron is the index of the transmitter neuron.
+      \return a pointer after its last receiver.
+    */
+	const std::uint32_t* end(unsigned long transmitter_neuron) const;
+
+	///getter for the number of receivers of a neuron.
+	unsigned long get_nb_receivers(unsigned long transmitter_neuron) const;
+
+	///says if the connections have their own delays.
+	bool has_delays() const;
+
+	///getter for the number of buckets of a neuron (1 if the connections have no delays).
+	unsigned long get_nb_buckets(unsigned long transmitter_neuron) const;
+
+	///getter for the delay of a bucket of a neuron.
+	/**
+      \param transmitter_neuron is the index of the transmitter neuron.
+      \param bucket is the index of the bucket among the buckets of the neuron (sorted by delay).
+      \return the delay of its receivers in number of time steps (0 if the connections have no delays).
+    */
+	unsigned int get_bucket_delay(unsigned long transmitter_neuron, unsigned long bucket) const;
+
+	///getter for the first receiver of a bucket of a neuron.
+	const std::uint32_t* bucket_begin(unsigned long transmitter_neuron, unsigned long bucket) const;
+
+	///getter for the end of the receivers of a bucket of a neuron.
+	const std::uint32_t* bucket_end(unsigned long transmitter_neuron, unsigned long bucket) const;
+
+	///getter for the shortest delay of the connections (0 if they have no delays).
+	unsigned int get_min_delay() const;
+
+	///getter for the longest delay of the connections (0 if they have no delays).
+	unsigned int get_max_delay() const;
+
+	///getter for the delays of the connections.
+	/**
+      \return the delay of each connection, in the order of the receivers (0 if the connections have no delays).
+    */
+	std::vector<std::uint32_t> get_delays() const;
+
+	///says if the connections have their own weights.
+	bool has_weights() const;
+
+	///getter for the number of bits of the codes of the weights (0 if the connections have no weights).
+	unsigned int get_weight_bits() const;
+
+	///getter for the weight of the code 1 (1 if the connections have no weights).
+	double get_weight_scale() const;
+
+	///getter for the codes of 8 bits of the weights of a bucket of a neuron.
+	/**
+      \return the code of the weight of each receiver of the bucket (the same order), a null pointer if the codes don't have 8 bits.
+    */
+	const std::uint8_t* weight_codes_8(unsigned long transmitter_neuron, unsigned long bucket) const;
+
+	///getter for the codes of 16 bits of the weights of a bucket of a neuron.
+	/**
+      \return the code of the weight of each receiver of the bucket (the same order), a null pointer if the codes don't have 16 bits.
+    */
+	const std::uint16_t* weight_codes_16(unsigned long transmitter_neuron, unsigned long bucket) const;
+
+	///getter for the weight of a connection.
+	/**
+      \param connection is the index of the connection (its receiver is receivers[connection]).
+      \return its code times the scale (1 if the connections have no weights).
+    */
+	double get_weight(unsigned long connection) const;
+
+	///getter for the weights of the connections.
+	/**
+      \return the weight of each connection (code times the scale), in the order of the receivers (1 if the connections have no weights).
+    */
+	std::vector<double> get_weights() const;
+
+		//setters
+	///adds a connection (the arrays are copied in memory first if they are mapped).
+	/**
+      \param transmitter_neuron is the index of the transmitter neuron.
+      \param receiver_neuron is the index of the receiver neuron.
+    */
+	void add(unsigned long transmitter_neuron, unsigned long receiver_neuron);
+
+	///gives a delay to each connection and groups the receivers of each neuron by delay (their order changes).
+	/**
+      \param delays contains the delay of each connection in number of time steps, in the order of the receivers.
+      \return false if there isn't one delay for each connection.
+    */
+	bool set_delays(const std::vector<std::uint32_t>& delays);
+
+	///gives to each connection a random delay drawn uniformly between two delays (distributed delays).
+	/**
+      \param min_delay is the shortest delay in number of time steps.
+      \param max_delay is the longest delay in number of time steps.
+      \param seed is the seed of the random generator.
+      \return false if min_delay is longer than max_delay.
+    */
+	bool set_random_delays(unsigned int min_delay, unsigned int max_delay, unsigned int seed);
+
+	///gives a weight to each connection, quantized with a number of bits.
+	/**
+	  The scale is the largest weight divided by the largest code, so the error on a weight is at most half of it.
+      \param weights contains the weight of each connection (at least 0), in the order of the receivers.
+      \param bits is the number of bits of the codes (8 or 16).
+      \return false if there isn't one weight for each connection, a weight is negative or the number of bits is not 8 or 16.
+    */
+	bool set_weights(const std::vector<double>& weights, unsigned int bits = 8);
+
+	///gives to each connection a random weight drawn uniformly between 1-spread and 1+spread (the mean weight is still 1).
+	/**
+      \param spread is the largest difference between a weight and 1 (from 0 to 1).
+      \param bits is the number of bits of the codes (8 or 16).
+      \param seed is the seed of the random generator.
+      \return false if the spread is not between 0 and 1 or the number of bits is not 8 or 16.
+    */
+	bool set_random_weights(double spread, unsigned int bits, unsigned int seed);
+
+		//files
+	///writes the connections in a file which can be mapped (the file is written with the suffix ".tmp" and renamed when it is complete).
+	/**
+      \param file_name is the name of the file.
+      \param key contains the parameters used to create the connections (NE, NI, CE, CI, seed), kept in the header of the file.
+      \return true if the file could be written.
+    */
+	bool save(const std::string& file_name, const std::vector<std::uint64_t>& key = std::vector<std::uint64_t>(5, 0)) const;
+
+	///writes the arrays in a binary stream (used by the checkpoints).
+	void write(std::ostream& out) const;
+
+	///reads the arrays written by write().
+	/**
+      \return true if the arrays could be read, have the right number of neurons and are valid (sorted offsets, receivers which are neurons).
+    */
+	bool read(std::istream& in);
+
+	///DESTRUCTOR (unmaps the file)
+	~Connectivity();
+
+	private:
+	///header of a connectivity file.
+	struct Header {
+		std::uint64_t magic; /**< "BRUNELCN" */
+		std::uint64_t version; /**< version of the format */
+		std::uint64_t key[5]; /**< NE, NI, CE, CI and seed */
+		std::uint64_t nb_neurons; /**< number of neurons */
+		std::uint64_t nb_connections; /**< number of connections */
+		std::uint64_t nb_buckets; /**< number of buckets (0 if the connections have no delays) */
+		std::uint64_t weight_bits; /**< number of bits of the codes of the weights (0 if the connections have no weights) */
+		double weight_scale; /**< weight of the code 1 */
+	};
+
+	///makes the object own its arrays (copies the mapped arrays in memory).
+	void own();
+
+	///points the arrays to the owned ones.
+	void use_owned_arrays();
+
+	///writes the codes of the weights (if there are weights) in a binary stream.
+	void write_weight_codes(std::ostream& out) const;
+
+	unsigned long nb_neurons_; /**< number of neurons */
+	std::vector<std::uint64_t> owned_offsets_; /**< offsets when they are in memory */
+	std::vector<std::uint32_t> owned_receivers_; /**< receivers when they are in memory */
+	const std::uint64_t* offsets_; /**< offsets (nb_neurons_+1 values) */
+	const std::uint32_t* receivers_; /**< receivers */
+
+	unsigned long nb_buckets_; /**< number of buckets (0 if the connections have no delays) */
+	std::vector<std::uint64_t> owned_bucket_offsets_; /**< first bucket of each neuron when they are in memory */
+	std::vector<std::uint64_t> owned_bucket_starts_; /**< first receiver of each bucket when they are in memory */
+	std::vector<std::uint32_t> owned_bucket_delays_; /**< delay of each bucket when they are in memory */
+	const std::uint64_t* bucket_offsets_; /**< first bucket of each neuron (nb_neurons_+1 values) */
+	const std::uint64_t* bucket_starts_; /**< first receiver of each bucket (nb_buckets_+1 values) */
+	const std::uint32_t* bucket_delays_; /**< delay of each bucket in number of time steps */
+
+	unsigned int weight_bits_; /**< number of bits of the codes of the weights (0 if the connections have no weights) */
+	double weight_scale_; /**< weight of the code 1 */
+	std::vector<std::uint8_t> owned_weight_codes_8_; /**< codes of 8 bits when they are in memory */
+	std::vector<std::uint16_t> owned_weight_codes_16_; /**< codes of 16 bits when they are in memory */
+	const std::uint8_t* weight_codes_8_; /**< codes of 8 bits of the weights of the connections (same order as the receivers) */
+	const std::uint16_t* weight_codes_16_; /**< codes of 16 bits of the weights of the connections */
+
+	void* mapping_; /**< beginning of the mapped file (null pointer if nothing is mapped) */
+	unsigned long mapping_size_; /**< size of the mapped file */
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "convergence_monitor.h"
+#include <algorithm>
+#include <cmath>
+
+//-----------------------------CONSTRUCTOR----------------------------//
+ConvergenceMonitor::ConvergenceMonitor(unsigned long nb_neurons, double dt, const StoppingCriteria& criteria)
+: criteria_(criteria)
+, transient_steps_(static_cast<unsigned long>(criteria.transient/dt + 0.5))
+, batch_steps_(std::max(1ul, static_cast<unsigned long>(criteria.batch_length/dt + 0.5)))
+, batch_statistics_(nb_neurons, dt, std::max(1u, static_cast<unsigned int>(criteria.window/dt + 0.5)))
+, nb_steps_(0), steps_in_batch_(0)
+, rates_({0, 0.0, 0.0}), cv_(0.0), cv_error_(INFINITY), correlations_({0, 0.0, 0.0})
+, last_regime_(QUIESCENT), nb_same_regime_(0), stop_reason_(TIME_REACHED)
+{}
+
+//-------------------------------GETTERS------------------------------//
+bool ConvergenceMonitor::should_stop() const
+{
+	return stop_reason_ != TIME_REACHED;
+}
+
+StopReason ConvergenceMonitor::get_stop_reason() const
+{
+	return stop_reason_;
+}
+
+unsigned long ConvergenceMonitor::get_nb_batches() const
+{
+	return rates_.n;
+}
+
+double ConvergenceMonitor::get_rate() const
+{
+	return rates_.mean;
+}
+
+double ConvergenceMonitor::get_cv() const
+{
+	return cv_;
+}
+
+double ConvergenceMonitor::get_correlation() const
+{
+	return correlations_.mean;
+}
+
+double ConvergenceMonitor::get_rate_error() const
+{
+	return rates_.error();
+}
+
+double ConvergenceMonitor::get_cv_error() const
+{
+	return cv_error_;
+}
+
+double ConvergenceMonitor::get_correlation_error() const
+{
+	return correlations_.error();
+}
+
+Regime ConvergenceMonitor::get_regime() const
+{
+	return classify_regime(get_rate(), get_cv(), get_correlation());
+}
+
+//------------------------------RECORDING-----------------------------//
+void ConvergenceMonitor::record_spike(unsigned long neuron_index, unsigned long T)
+{
+	if (nb_steps_ >= transient_steps_) {
+		batch_statistics_.record_spike(neuron_index, T);
+	}
+}
+
+void ConvergenceMonitor::end_of_step(const RecordedNetwork& brain, unsigned long T)
+{
+	if (nb_steps_ < transient_steps_) {
+		++nb_steps_;
+		return;
+	}
+	batch_statistics_.end_of_step(brain, T);
+	++steps_in_batch_;
+	if (steps_in_batch_ == batch_steps_) {
+		close_batch();
+	}
+}
+
+void ConvergenceMonitor::close_batch()
+{
+	const double rate(batch_statistics_.get_mean_rate());
+	const double cv(batch_statistics_.get_mean_cv());
+	const double correlation(batch_statistics_.get_mean_correlation());
+	rates_.add(rate);
+	cv_ = cv;
+	cv_error_ = batch_statistics_.get_cv_error();
+	correlations_.add(correlation);
+	batch_statistics_.reset_counts();
+	steps_in_batch_ = 0;
+
+	Regime regime(classify_regime(rate, cv, correlation));
+	if (rates_.n > 1 and regime == last_regime_) {
+		++nb_same_regime_;
+	} else {
+		nb_same_regime_ = 1;
+	}
+	last_regime_ = regime;
+
+	if (stop_reason_ != TIME_REACHED or rates_.n < criteria_.min_batches) {
+		return;
+	}
+	if (rates_.error() <= criteria_.rate_precision * rates_.mean
+		and cv_error_ <= criteria_.cv_precision
+		and correlations_.error() <= criteria_.correlation_precision) {
+		stop_reason_ = CONVERGED;
+	} else if (criteria_.stable_batches > 0 and nb_same_regime_ >= criteria_.stable_batches) {
+		stop_reason_ = REGIME_STABLE;
+	}
+}
+
+void ConvergenceMonitor::print_report(std::ostream& out) const
+{
+	switch (stop_reason_) {
+		case TIME_REACHED:
+			out << "Stopped at t_stop";
+			break;
+		case CONVERGED:
+			out << "Stopped early: the statistics converged";
+			break;
+		case REGIME_STABLE:
+			out << "Stopped early: the regime was stable";
+			break;
+	}
+	out << " after " << rates_.n << " batches" << std::endl;
+	out << "rate = " << get_rate() << " +/- " << get_rate_error() << " Hz, CV = " << get_cv() << " +/- " << get_cv_error() << ", correlation = " << get_correlation() << " +/- " << get_correlation_error() << ", regime: " << regime_name(get_regime()) << std::endl;
+}
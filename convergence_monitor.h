@@ -0,0 +1,118 @@
+#ifndef CONVERGENCE_MONITOR_H
+#define CONVERGENCE_MONITOR_H
+#include <iostream>
+#include "recorder.h"
+#include "regime.h"
+#include "spike_statistics.h"
+
+///parameters of the early termination of a simulation.
+struct StoppingCriteria {
+	double transient = 100.0; /**< time (ms) at the beginning of the monitoring which is not analyzed */
+	double batch_length = 50.0; /**< length (ms) of the batches whose statistics are compared */
+	double window = 5.0; /**< length (ms) of the windows used for the spike counts (correlations) */
+	unsigned int min_batches = 5; /**< minimal number of batches before the simulation can stop */
+	double rate_precision = 0.05; /**< maximal half-width of the 95% confidence interval of the rate, relative to the rate */
+	double cv_precision = 0.05; /**< maximal half-width of the 95% confidence interval of the CV */
+	double correlation_precision = 0.02; /**< maximal half-width of the 95% confidence interval of the correlation */
+	unsigned int stable_batches = 0; /**< number of consecutive batches with the same regime after which the simulation stops (0 to disable) */
+};
+
+///the reasons why a simulation ended.
+enum StopReason {
+	TIME_REACHED, /**< the simulation reached t_stop */
+	CONVERGED, /**< the confidence intervals of the statistics are small enough */
+	REGIME_STABLE /**< the regime didn't change for the number of batches asked */
+};
+
+///watches the statistics of the network batch after batch and says when they have converged.
+/**
+  The time after the transient is cut in batches. The rate and the correlation of each batch are treated as
+  independent samples (batch means method) to compute a confidence interval for each of them. A batch is too
+  short for a neuron to have several interspike intervals in the asynchronous regime, so the intervals are
+  kept from one batch to the next: the CV is the mean CV of the neurons over all the intervals since the
+  transient. These cumulative estimates are not independent from one batch to the next, so the confidence
+  interval of the CV comes from the spread of the CVs of the neurons instead (SpikeStatistics::get_cv_error()).
+*/
+class ConvergenceMonitor : public Recorder {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param nb_neurons is the number of neurons of the brain.
+      \param dt is the time step in ms.
+      \param criteria contains the parameters of the early termination.
+    */
+	ConvergenceMonitor(unsigned long nb_neurons, double dt, const StoppingCriteria& criteria);
+
+		//getters
+	///says if the simulation can stop.
+	/**
+      \return true if the statistics have converged or the regime is stable.
+    */
+	bool should_stop() const;
+
+	///getter for the reason of the stop.
+	/**
+      \return CONVERGED or REGIME_STABLE if the simulation can stop, TIME_REACHED otherwise.
+    */
+	StopReason get_stop_reason() const;
+
+	///getter for the number of full batches.
+	unsigned long get_nb_batches() const;
+
+	///getter for the mean rate over the batches (Hz).
+	double get_rate() const;
+
+	///getter for the CV of the intervals since the transient (at the end of the last batch).
+	double get_cv() const;
+
+	///getter for the mean correlation over the batches.
+	double get_correlation() const;
+
+	///getter for the half-width of the 95% confidence interval of the rate (Hz).
+	double get_rate_error() const;
+
+	///getter for the half-width of the 95% confidence interval of the CV (at the end of the last batch).
+	double get_cv_error() const;
+
+	///getter for the half-width of the 95% confidence interval of the correlation.
+	double get_correlation_error() const;
+
+	///getter for the regime given by the mean statistics.
+	Regime get_regime() const;
+
+		//recording
+	///gives the spike to the statistics of the current batch (the spikes of the transient are ignored).
+	void record_spike(unsigned long neuron_index, unsigned long T) override;
+
+	///closes the current batch if it is full and checks the stopping criteria.
+	void end_of_step(const RecordedNetwork& brain, unsigned long T) override;
+
+	///prints the reason of the stop and the statistics.
+	/**
+      \param out is the stream where the report is printed.
+    */
+	void print_report(std::ostream& out) const;
+
+	private:
+	///adds the statistics of the batch and checks the stopping criteria.
+	void close_batch();
+
+	const StoppingCriteria criteria_; /**< parameters of the early termination */
+	const unsigned long transient_steps_; /**< length of the transient in number of steps */
+	const unsigned long batch_steps_; /**< length of a batch in number of steps */
+
+	SpikeStatistics batch_statistics_; /**< statistics of the current batch (the interspike intervals since the transient) */
+	unsigned long nb_steps_; /**< number of steps of the transient already seen (the transient starts at the first update, which is not always at time 0) */
+	unsigned long steps_in_batch_; /**< number of steps in the current batch */
+
+	Accumulator rates_; /**< statistics of the batch rates */
+	double cv_; /**< CV at the end of the last batch */
+	double cv_error_; /**< half-width of the 95% confidence interval of the CV at the end of the last batch */
+	Accumulator correlations_; /**< statistics of the batch correlations */
+
+	Regime last_regime_; /**< regime of the last batch */
+	unsigned int nb_same_regime_; /**< number of consecutive batches with the regime last_regime_ */
+	StopReason stop_reason_; /**< reason of the stop (TIME_REACHED while the simulation has to go on) */
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "ensemble.h"
+#include <cmath>
+#include <stdexcept>
+
+//-----------------------------CONSTRUCTOR----------------------------//
+Ensemble::Ensemble(std::shared_ptr<const Connectivity> network, unsigned long NE, const std::vector<EnsembleTrial>& trials, double dt, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double JE, double J, double TAU)
+: nb_neurons_(network->get_nb_neurons()), NE_(NE), nb_trials_(trials.size()), trials_(trials)
+, Refractory_Time_Steps_(Refractory_Time_Steps), Delay_Steps_(Delay_Steps > 0 ? Delay_Steps : 1), size_of_buffer_(Delay_Steps_+1)
+, Vthr_(Vthr), Vreset_(Vreset), J_(J), exponential_(exp(-(1*dt)/TAU))
+, time_(0)
+, membrane_potentials_(nb_neurons_*nb_trials_, 0.0), refractory_(nb_neurons_*nb_trials_, 0)
+, last_spike_times_(nb_neurons_*nb_trials_, 0), nb_of_spikes_(nb_neurons_*nb_trials_, 0)
+, signals_buffers_(size_of_buffer_*nb_neurons_*nb_trials_, 0.0), random_inputs_(nb_neurons_*nb_trials_, 0)
+, spikes_(nb_trials_, 0), sent_signals_(nb_trials_, 0.0)
+, network_(network), recorders_(nb_trials_)
+{
+	//every signal has the delay and the weight of its population
+	if (network_->get_max_delay() != 0 or network_->has_weights()) {
+		throw std::invalid_argument("Ensemble: the connections can not have their own delays or weights");
+	}
+	for (unsigned int k(0) ; k<nb_trials_ ; ++k) {
+		//same values as in Simulation
+		excitatory_weights_.push_back(JE);
+		inhibitory_weights_.push_back(-trials_[k].g * JE);
+		v_ext_.push_back(trials_[k].ETA*Vthr*dt / (J*TAU));
+		generators_.push_back(std::mt19937(trials_[k].seed));
+		trial_networks_.push_back(std::unique_ptr<TrialNetwork>(new TrialNetwork(*this, k)));
+	}
+}
+
+Ensemble::TrialNetwork::TrialNetwork(const Ensemble& ensemble, unsigned int trial)
+: ensemble_(ensemble), trial_(trial)
+{}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long Ensemble::get_nb_neurons() const
+{
+	return nb_neurons_;
+}
+
+unsigned int Ensemble::get_nb_trials() const
+{
+	return nb_trials_;
+}
+
+const EnsembleTrial& Ensemble::get_trial(unsigned int trial) const
+{
+	return trials_[trial];
+}
+
+unsigned long Ensemble::get_clock() const
+{
+	return time_;
+}
+
+double Ensemble::get_membrane_potential(unsigned long neuron_index, unsigned int trial) const
+{
+	return membrane_potentials_[neuron_index*nb_trials_ + trial];
+}
+
+unsigned int Ensemble::get_nb_of_spikes(unsigned long neuron_index, unsigned int trial) const
+{
+	return nb_of_spikes_[neuron_index*nb_trials_ + trial];
+}
+
+unsigned long Ensemble::get_total_nb_of_spikes(unsigned int trial) const
+{
+	unsigned long total(0);
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		total += nb_of_spikes_[i*nb_trials_ + trial];
+	}
+	return total;
+}
+
+const RecordedNetwork& Ensemble::get_network(unsigned int trial) const
+{
+	return *trial_networks_[trial];
+}
+
+void Ensemble::TrialNetwork::gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const
+{
+	const unsigned long nb_indexes(neuron_indexes.size());
+	for (unsigned long k(0) ; k<nb_indexes ; ++k) {
+		membrane_potentials[k] = ensemble_.get_membrane_potential(neuron_indexes[k], trial_);
+	}
+}
+
+//--------------------------------UPDATE------------------------------//
+void Ensemble::attach_recorder(unsigned int trial, Recorder* recorder)
+{
+	if (trial<nb_trials_ and recorder != nullptr) {
+		recorders_[trial].push_back(recorder);
+	}
+}
+
+void Ensemble::update(unsigned long T)
+{
+	const unsigned int K(nb_trials_);
+
+	//background noise of each trial, drawn in the same order as in a brain
+	for (unsigned int k(0) ; k<K ; ++k) {
+		std::poisson_distribution<> random_input(v_ext_[k]);
+		for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+			random_inputs_[i*K + k] = random_input(generators_[k]);
+		}
+	}
+
+	//the signals received now and the ones which will be received after the delay (the buffer is indexed by the time)
+	double* received(&signals_buffers_[(T % size_of_buffer_)*nb_neurons_*K]);
+	double* sent(&signals_buffers_[((T + Delay_Steps_) % size_of_buffer_)*nb_neurons_*K]);
+
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		double* membrane_potential(&membrane_potentials_[i*K]);
+		unsigned char* refractory(&refractory_[i*K]);
+		unsigned long* last_spike_time(&last_spike_times_[i*K]);
+		unsigned int* nb_of_spikes(&nb_of_spikes_[i*K]);
+		double* signals(&received[i*K]);
+		const unsigned int* inputs(&random_inputs_[i*K]);
+		const double* weights(i<NE_ ? excitatory_weights_.data() : inhibitory_weights_.data());
+
+		//same computation as Neuron::update, without branches so that the loop over the trials is vectorized
+		unsigned char any_spike(0);
+		for (unsigned int k(0) ; k<K ; ++k) {
+			const bool active(refractory[k] == 0 or (T - last_spike_time[k]) >= Refractory_Time_Steps_);
+			const double potential(exponential_*membrane_potential[k] + J_*signals[k] + J_*inputs[k]);
+			signals[k] = 0.0;
+
+			const double new_potential(active ? potential : membrane_potential[k]);
+			const bool spike(new_potential > Vthr_);
+			membrane_potential[k] = spike ? Vreset_ : new_potential;
+			refractory[k] = spike ? 1 : (active ? 0 : refractory[k]);
+			last_spike_time[k] = spike ? T : last_spike_time[k];
+			nb_of_spikes[k] += spike;
+			spikes_[k] = spike;
+			sent_signals_[k] = spike ? weights[k] : 0.0;
+			any_spike |= spike;
+		}
+		if (not any_spike) {
+			continue;
+		}
+
+		//one pass over the receivers for every trial (adding 0 where the neuron didn't spike)
+		const std::uint32_t* end(network_->end(i));
+		for (const std::uint32_t* receiver_neuron(network_->begin(i)) ; receiver_neuron != end ; ++receiver_neuron) {
+			double* receiver_signals(&sent[static_cast<unsigned long>(*receiver_neuron)*K]);
+			for (unsigned int k(0) ; k<K ; ++k) {
+				receiver_signals[k] += sent_signals_[k];
+			}
+		}
+
+		for (unsigned int k(0) ; k<K ; ++k) {
+			if (spikes_[k]) {
+				for (auto recorder : recorders_[k]) {
+					recorder->record_spike(i, T);
+				}
+			}
+		}
+	}
+
+	time_ = T;
+
+	for (unsigned int k(0) ; k<K ; ++k) {
+		for (auto recorder : recorders_[k]) {
+			recorder->end_of_step(*trial_networks_[k], T);
+		}
+	}
+}
+
+void Ensemble::run(unsigned long Tstop)
+{
+	while (time_ < Tstop) {
+		update(time_+1);
+	}
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+Ensemble::TrialNetwork::~TrialNetwork()
+{}
+
+Ensemble::~Ensemble()
+{}
@@ -0,0 +1,143 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+#include <memory>
+#include <random>
+#include <vector>
+#include "connectivity.h"
+#include "recorder.h"
+
+///parameters of one trial of an ensemble.
+struct EnsembleTrial {
+	double g; /**< positive ratio of JI/JE */
+	double ETA; /**< ratio v_ext/v_thr */
+	unsigned int seed; /**< seed of the background noise */
+};
+
+///simulates several trials of the same network at the same time.
+/**
+  The trials share the connections and differ only by g, ETA and the seed of their background noise.
+  The state of each neuron is stored for every trial next to each other ([neuron*nb_trials + trial]),
+  so the update of a neuron is a loop over the trials that the compiler vectorizes, and the receivers
+  of a neuron are read once per step for all the trials in which it had a spike.
+  Each trial gives exactly the same spikes as a brain with the same connections, the same parameters
+  and the same noise seed (the delay has to be at least one step).
+*/
+class Ensemble {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param network contains the connections, the number of neurons is its number of neurons (the connections can not have their own delays or weights, see Connectivity::set_delays() and Connectivity::set_weights(), std::invalid_argument is thrown otherwise).
+      \param NE is the number of excitatory neurons (the first NE neurons).
+      \param trials contains the parameters of each trial.
+      \param dt is the time step for each update in ms.
+      \param Delay_Steps is the delay for a neuron to transmit a signal in number of time steps (at least 1).
+      \param Refractory_Time_Steps is the refractrory time for the neurons in number of time steps.
+      \param Vthr is the potential (mV) to exceed for a spike to appear.
+      \param Vreset is the initial and refractory potential (mV).
+      \param JE is the potential transmited when an excitatory neuron has a spike in number of J (JI is -g*JE).
+      \param J is the "potential step" transmitted between neurons in mV.
+      \param TAU is the membrane time constant (ms).
+    */
+	Ensemble(std::shared_ptr<const Connectivity> network, unsigned long NE, const std::vector<EnsembleTrial>& trials, double dt = 0.1, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double Vthr = 20.0, double Vreset = 0.0, double JE = 1.0, double J = 0.1, double TAU = 20);
+
+		//getters
+	///getter for the number of neurons.
+	unsigned long get_nb_neurons() const;
+
+	///getter for the number of trials.
+	unsigned int get_nb_trials() const;
+
+	///getter for the parameters of a trial.
+	const EnsembleTrial& get_trial(unsigned int trial) const;
+
+	///getter for the time of the last update (in number of steps).
+	unsigned long get_clock() const;
+
+	///getter for the membrane potential of a neuron in a trial (mV).
+	double get_membrane_potential(unsigned long neuron_index, unsigned int trial) const;
+
+	///getter for the number of spikes of a neuron in a trial.
+	unsigned int get_nb_of_spikes(unsigned long neuron_index, unsigned int trial) const;
+
+	///getter for the number of spikes of every neuron in a trial.
+	unsigned long get_total_nb_of_spikes(unsigned int trial) const;
+
+	///getter for a trial seen as a network (to read its membrane potentials like a brain).
+	const RecordedNetwork& get_network(unsigned int trial) const;
+
+		//update
+	///attach a recorder to a trial (the ensemble doesn't own it).
+	/**
+      \param trial is the index of the trial.
+      \param recorder is the recorder to attach.
+    */
+	void attach_recorder(unsigned int trial, Recorder* recorder);
+
+	///updates every neuron of every trial with time T and sends the signals.
+	/**
+      \param T is the new time (in number of steps, the next one after the clock).
+    */
+	void update(unsigned long T);
+
+	///updates the ensemble until a given time.
+	/**
+      \param Tstop is the time of the last update (in number of steps).
+    */
+	void run(unsigned long Tstop);
+
+	///DESTRUCTOR
+	~Ensemble();
+
+	private:
+	///one trial of the ensemble seen as a network by the recorders.
+	class TrialNetwork : public RecordedNetwork {
+		public:
+		TrialNetwork(const Ensemble& ensemble, unsigned int trial);
+		void gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const override;
+		~TrialNetwork();
+
+		private:
+		const Ensemble& ensemble_; /**< ensemble of the trial */
+		const unsigned int trial_; /**< index of the trial */
+	};
+
+		//Parameters
+	const unsigned long nb_neurons_; /**< number of neurons */
+	const unsigned long NE_; /**< number of excitatory neurons */
+	const unsigned int nb_trials_; /**< number of trials */
+	const std::vector<EnsembleTrial> trials_; /**< parameters of the trials */
+	const unsigned int Refractory_Time_Steps_; /**< refractrory time in number of time steps */
+	const unsigned int Delay_Steps_; /**< delay to receive a signal in number of time steps */
+	const unsigned int size_of_buffer_; /**< number of steps kept in the signals buffers (Delay_Steps+1) */
+	const double Vthr_; /**< potential to exceed for a spike to appear (mV) */
+	const double Vreset_; /**< potential after a spike (mV) */
+	const double J_; /**< "potential step" transmitted between neurons (mV) */
+	const double exponential_; /**< decay of the membrane potential during one step */
+
+	std::vector<double> excitatory_weights_; /**< JE for each trial */
+	std::vector<double> inhibitory_weights_; /**< JI for each trial */
+	std::vector<double> v_ext_; /**< mean background input per step for each trial */
+
+		//Time
+	unsigned long time_; /**< clock */
+
+		//State [neuron*nb_trials + trial]
+	std::vector<double> membrane_potentials_; /**< membrane potentials (mV) */
+	std::vector<unsigned char> refractory_; /**< says if the neurons are refractory */
+	std::vector<unsigned long> last_spike_times_; /**< time of the last spikes */
+	std::vector<unsigned int> nb_of_spikes_; /**< number of spikes */
+	std::vector<double> signals_buffers_; /**< signals received for each of the next steps [(step*nb_neurons + neuron)*nb_trials + trial] */
+	std::vector<unsigned int> random_inputs_; /**< background input of the current step */
+	std::vector<unsigned char> spikes_; /**< spikes of the neuron being updated (one per trial) */
+	std::vector<double> sent_signals_; /**< signals sent by the neuron being updated (one per trial, 0 without spike) */
+
+		//Background noise
+	std::vector<std::mt19937> generators_; /**< random generator of the background noise of each trial */
+
+		//Connections and recorders
+	std::shared_ptr<const Connectivity> network_; /**< connections shared by the trials */
+	std::vector<std::unique_ptr<TrialNetwork>> trial_networks_; /**< each trial seen as a network */
+	std::vector<std::vector<Recorder*>> recorders_; /**< the recorders attached to each trial */
+};
+
+#endif
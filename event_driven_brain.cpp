@@ -0,0 +1,352 @@
+#include "event_driven_brain.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+///number of steps whose decay is in the table.
+const unsigned int Nb_Decays(4096);
+
+///minimal number of buckets of the calendar queue.
+const unsigned int Min_Nb_Buckets(256);
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+EventDrivenBrain::EventDrivenBrain(std::shared_ptr<const Connectivity> network, unsigned long NE, double dt, double v_ext, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double JE, double JI, double J, double TAU)
+: nb_neurons_(network->get_nb_neurons()), NE_(NE), dt_(dt), v_ext_(v_ext)
+, Delay_Steps_(Delay_Steps > 0 ? Delay_Steps : 1), Refractory_Time_Steps_(Refractory_Time_Steps)
+, Vthr_(Vthr), Vreset_(Vreset), JE_(JE), JI_(JI), J_(J), TAU_(TAU), decays_(Nb_Decays)
+, time_(0), nb_of_updates_(0)
+, membrane_potentials_(nb_neurons_, 0.0), reference_times_(nb_neurons_, 0), last_spike_times_(nb_neurons_, 0)
+, spiked_(nb_neurons_, 0), nb_of_spikes_(nb_neurons_, 0), next_arrivals_(nb_neurons_, 0.0)
+, reference_offsets_(nb_neurons_, 1.0), last_spike_offsets_(nb_neurons_, 1.0)
+, precise_(false), delay_steps_(Delay_Steps_), delay_offset_(0.0), refractory_steps_(Refractory_Time_Steps), refractory_offset_(0.0)
+, inputs_(nb_neurons_, 0.0), has_input_(nb_neurons_, 0), scaled_potentials_(nb_neurons_, 0.0), scaled_times_(nb_neurons_, 0)
+, buckets_(std::max(Delay_Steps_+1, Min_Nb_Buckets))
+, generator_(std::random_device()()), started_(false)
+, network_(network)
+{
+	//every signal has the delay and the weight of its population
+	if (network_->get_max_delay() != 0 or network_->has_weights()) {
+		throw std::invalid_argument("EventDrivenBrain: the connections can not have their own delays or weights");
+	}
+	for (unsigned int k(0) ; k<Nb_Decays ; ++k) {
+		decays_[k] = exp(-(k*dt_)/TAU_);
+	}
+}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long EventDrivenBrain::get_nb_neurons() const
+{
+	return nb_neurons_;
+}
+
+unsigned long EventDrivenBrain::get_clock() const
+{
+	return time_;
+}
+
+double EventDrivenBrain::get_membrane_potential(unsigned long neuron_index) const
+{
+	//the potential stays at Vreset until the end of the refractory period
+	if (precise_) {
+		const double nb_steps((time_ - 1.0*reference_times_[neuron_index]) + (1.0 - reference_offsets_[neuron_index]));
+		return nb_steps > 0.0 ? exp(-(nb_steps*dt_)/TAU_) * membrane_potentials_[neuron_index] : membrane_potentials_[neuron_index];
+	}
+	if (reference_times_[neuron_index] >= time_) {
+		return membrane_potentials_[neuron_index];
+	}
+	return decay(time_ - reference_times_[neuron_index]) * membrane_potentials_[neuron_index];
+}
+
+unsigned int EventDrivenBrain::get_nb_of_spikes(unsigned long neuron_index) const
+{
+	return nb_of_spikes_[neuron_index];
+}
+
+unsigned long EventDrivenBrain::get_nb_of_updates() const
+{
+	return nb_of_updates_;
+}
+
+double EventDrivenBrain::get_last_spike_time(unsigned long neuron_index) const
+{
+	if (not spiked_[neuron_index]) {
+		return 0.0;
+	}
+	return (last_spike_times_[neuron_index] - 1.0 + last_spike_offsets_[neuron_index]) * dt_;
+}
+
+void EventDrivenBrain::gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const
+{
+	const unsigned long nb_indexes(neuron_indexes.size());
+	for (unsigned long k(0) ; k<nb_indexes ; ++k) {
+		membrane_potentials[k] = get_membrane_potential(neuron_indexes[k]);
+	}
+}
+
+//--------------------------------UPDATE------------------------------//
+void EventDrivenBrain::set_noise_seed(unsigned int seed)
+{
+	generator_.seed(seed);
+}
+
+bool EventDrivenBrain::enable_precise_timing(double D, double Refractory_Time)
+{
+	if (D < dt_ or started_) {
+		return false;
+	}
+	precise_ = true;
+	delay_steps_ = static_cast<unsigned long>(D / dt_);
+	delay_offset_ = D/dt_ - delay_steps_;
+	refractory_steps_ = static_cast<unsigned long>(Refractory_Time / dt_);
+	refractory_offset_ = Refractory_Time/dt_ - refractory_steps_;
+	return true;
+}
+
+void EventDrivenBrain::attach_recorder(Recorder* recorder)
+{
+	if (recorder != nullptr) {
+		recorders_.push_back(recorder);
+	}
+}
+
+void EventDrivenBrain::update(unsigned long T, std::ostream& file)
+{
+	//the first arrivals are drawn at the first update, after the seed is set
+	if (not started_) {
+		started_ = true;
+		if (v_ext_ > 0.0) {
+			for (std::uint32_t i(0) ; i<nb_neurons_ ; ++i) {
+				schedule_background(i, time_ + inter_arrival());
+			}
+		}
+		for (const auto& event : next_events_) {
+			buckets_[event.time % buckets_.size()].push_back(event);
+		}
+		next_events_.clear();
+	}
+
+	if (precise_) {
+		update_precise(T, file);
+	} else {
+		update_grid(T, file);
+	}
+
+	for (const auto& event : next_events_) {
+		buckets_[event.time % buckets_.size()].push_back(event);
+	}
+	next_events_.clear();
+
+	time_ = T;
+
+	for (auto recorder : recorders_) {
+		recorder->end_of_step(*this, T);
+	}
+}
+
+void EventDrivenBrain::update_grid(unsigned long T, std::ostream& file)
+{
+	//inputs of the step, the events of the next years stay in the bucket
+	std::vector<Event>& bucket(buckets_[T % buckets_.size()]);
+	std::size_t nb_kept(0);
+	for (std::size_t k(0) ; k<bucket.size() ; ++k) {
+		const Event event(bucket[k]);
+		if (event.time != T) {
+			bucket[nb_kept++] = event;
+		} else if (event.background) {
+			//every arrival of the step is one signal JE
+			double arrival(next_arrivals_[event.neuron]);
+			unsigned int nb_signals(0);
+			while (arrival <= T) {
+				++nb_signals;
+				arrival += inter_arrival();
+			}
+			add_input(event.neuron, nb_signals);
+			schedule_background(event.neuron, arrival);
+		} else {
+			const double weight(event.neuron < NE_ ? JE_ : JI_);
+			const std::uint32_t* end(network_->end(event.neuron));
+			for (const std::uint32_t* receiver(network_->begin(event.neuron)) ; receiver != end ; ++receiver) {
+				add_input(*receiver, weight);
+			}
+		}
+	}
+	bucket.resize(nb_kept);
+
+	//the neurons with an input are updated like Neuron::update
+	for (auto neuron : receivers_) {
+		const double input(inputs_[neuron]);
+		inputs_[neuron] = 0.0;
+		has_input_[neuron] = 0;
+		++nb_of_updates_;
+
+		//the inputs received during the refractory period are lost
+		if (spiked_[neuron] and (T - last_spike_times_[neuron]) < Refractory_Time_Steps_) {
+			continue;
+		}
+		double& membrane_potential(membrane_potentials_[neuron]);
+		membrane_potential = decay(T - reference_times_[neuron]) * membrane_potential + J_*input;
+		reference_times_[neuron] = T;
+
+		if (membrane_potential > Vthr_) {
+			//the potential stays at Vreset until the end of the refractory period, and decays from there
+			membrane_potential = Vreset_;
+			reference_times_[neuron] = T + std::max(Refractory_Time_Steps_, 1u) - 1;
+			last_spike_times_[neuron] = T;
+			spiked_[neuron] = 1;
+			++nb_of_spikes_[neuron];
+			next_events_.push_back(Event{T + Delay_Steps_, 1.0, neuron, false});
+			record_spike(neuron, T, 1.0, file);
+		}
+	}
+	receivers_.clear();
+}
+
+void EventDrivenBrain::update_precise(unsigned long T, std::ostream& file)
+{
+	//the spikes are delivered in the order of their times, the background arrivals of each neuron are read in order when it receives an input
+	std::vector<Event>& bucket(buckets_[T % buckets_.size()]);
+	std::size_t nb_kept(0);
+	for (std::size_t k(0) ; k<bucket.size() ; ++k) {
+		const Event event(bucket[k]);
+		if (event.time != T) {
+			bucket[nb_kept++] = event;
+		} else if (event.background) {
+			background_events_.push_back(event);
+		} else {
+			spike_events_.push_back(event);
+		}
+	}
+	bucket.resize(nb_kept);
+	std::sort(spike_events_.begin(), spike_events_.end(), [](const Event& a, const Event& b) {
+		return a.offset < b.offset;
+	});
+
+	for (const auto& event : spike_events_) {
+		const double growth(exp(event.offset*dt_/TAU_));
+		const double weight(event.neuron < NE_ ? JE_ : JI_);
+		const std::uint32_t* end(network_->end(event.neuron));
+		for (const std::uint32_t* receiver(network_->begin(event.neuron)) ; receiver != end ; ++receiver) {
+			receive_background(*receiver, T, T - 1.0 + event.offset, file);
+			receive_precise_input(*receiver, T, event.offset, growth, weight, file);
+		}
+	}
+	spike_events_.clear();
+
+	//the rest of the background arrivals of the step
+	for (const auto& event : background_events_) {
+		receive_background(event.neuron, T, T, file);
+		schedule_background(event.neuron, next_arrivals_[event.neuron]);
+	}
+	background_events_.clear();
+}
+
+void EventDrivenBrain::receive_background(std::uint32_t neuron, unsigned long T, double time, std::ostream& file)
+{
+	double& arrival(next_arrivals_[neuron]);
+	while (arrival <= time) {
+		const double offset(arrival - (T - 1.0));
+		receive_precise_input(neuron, T, offset, exp(offset*dt_/TAU_), 1.0, file);
+		arrival += inter_arrival();
+	}
+}
+
+void EventDrivenBrain::receive_precise_input(std::uint32_t neuron, unsigned long T, double offset, double growth, double input, std::ostream& file)
+{
+	++nb_of_updates_;
+
+	//the reference time is the end of the refractory period after a spike, the inputs before are lost
+	unsigned long& reference_time(reference_times_[neuron]);
+	double& reference_offset(reference_offsets_[neuron]);
+	if (T < reference_time or (T == reference_time and offset < reference_offset)) {
+		return;
+	}
+
+	//in the step, the potential is scaled by exp(offset*dt/TAU) so that it is constant between the inputs
+	double& scaled_potential(scaled_potentials_[neuron]);
+	if (scaled_times_[neuron] != T) {
+		const double nb_steps((T - 1.0*reference_time) - reference_offset);
+		scaled_potential = exp(-(nb_steps*dt_)/TAU_) * membrane_potentials_[neuron];
+		scaled_times_[neuron] = T;
+	}
+	scaled_potential += J_*input*growth;
+	double& membrane_potential(membrane_potentials_[neuron]);
+	membrane_potential = scaled_potential / growth;
+	reference_time = T;
+	reference_offset = offset;
+
+	if (membrane_potential > Vthr_) {
+		membrane_potential = Vreset_;
+		scaled_times_[neuron] = 0;
+		last_spike_times_[neuron] = T;
+		last_spike_offsets_[neuron] = offset;
+		spiked_[neuron] = 1;
+		++nb_of_spikes_[neuron];
+
+		//(step, offset) of the end of the refractory period and of the reception of the spike
+		reference_time = T + refractory_steps_;
+		reference_offset = offset + refractory_offset_;
+		if (reference_offset > 1.0) {
+			reference_time += 1;
+			reference_offset -= 1.0;
+		}
+		Event spike{T + delay_steps_, offset + delay_offset_, neuron, false};
+		if (spike.offset > 1.0) {
+			spike.time += 1;
+			spike.offset -= 1.0;
+		}
+		next_events_.push_back(spike);
+		record_spike(neuron, T, offset, file);
+	}
+}
+
+void EventDrivenBrain::run(unsigned long Tstop, std::ostream& file)
+{
+	while (time_ < Tstop) {
+		update(time_+1, file);
+	}
+}
+
+//---------------------------OTHER-METHODS----------------------------//
+void EventDrivenBrain::schedule_background(std::uint32_t neuron, double arrival)
+{
+	//an arrival in (T-1, T] is received at the step T
+	next_arrivals_[neuron] = arrival;
+	const unsigned long step(std::max(static_cast<unsigned long>(std::ceil(arrival)), time_+1));
+	next_events_.push_back(Event{step, 1.0, neuron, true});
+}
+
+void EventDrivenBrain::record_spike(std::uint32_t neuron, unsigned long T, double offset, std::ostream& file)
+{
+	file << (T - 1.0 + offset)*dt_ << '\t' << neuron << '\n';
+	for (auto recorder : recorders_) {
+		recorder->record_spike(neuron, T);
+	}
+}
+
+void EventDrivenBrain::add_input(std::uint32_t neuron, double input)
+{
+	if (not has_input_[neuron]) {
+		has_input_[neuron] = 1;
+		receivers_.push_back(neuron);
+	}
+	inputs_[neuron] += input;
+}
+
+double EventDrivenBrain::inter_arrival()
+{
+	//exponential distribution from one 32-bit number (std::exponential_distribution takes two)
+	return -log((generator_() + 0.5) * (1.0/4294967296.0)) / v_ext_;
+}
+
+double EventDrivenBrain::decay(unsigned long nb_steps) const
+{
+	return nb_steps < Nb_Decays ? decays_[nb_steps] : exp(-(nb_steps*dt_)/TAU_);
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+EventDrivenBrain::~EventDrivenBrain()
+{}
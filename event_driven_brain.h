@@ -0,0 +1,231 @@
+#ifndef EVENT_DRIVEN_BRAIN_H
+#define EVENT_DRIVEN_BRAIN_H
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "connectivity.h"
+#include "recorder.h"
+
+///simulates the same network as a brain, but only updates the neurons which receive an input.
+/**
+  Between two inputs the membrane potential of a neuron only decays, so it is computed only when an input
+  arrives: V(T) = exp(-(T - T_last)*dt/TAU)*V(T_last) + J*input. A spike can only happen at such a step.
+  The background noise of each neuron is a Poisson process of v_ext signals per step: its arrival times are
+  drawn as exponential inter-arrival times, and the number of arrivals in a step is the Poisson number of
+  signals received by a neuron of a brain (the random numbers are not the same as in a brain, the statistics are).
+  The inputs wait in a calendar queue with one bucket per step (the background arrivals later than the number
+  of buckets stay in their bucket until their time comes), and a spike is one event of the queue whose
+  receivers are read when it is delivered.
+  The work of a step is proportional to the number of inputs instead of the number of neurons, which is much
+  less when the background noise is weak and the rates are low.
+
+  With the precise timing (enable_precise_timing()), the times are not rounded to the steps: every input is
+  received at its own time, carried as a (step, offset) pair, the inputs of a neuron are handled in their order,
+  and a spike happens at the exact time of the input which crosses the threshold (the inputs are instantaneous,
+  so there is nothing to interpolate). The delay and the refractory time don't have to be multiples of dt.
+  The time step is then only the width of the buckets of the queue and doesn't change the statistics, so it can
+  be as large as the delay.
+*/
+class EventDrivenBrain : public RecordedNetwork {
+	public:
+	///CONSTRUCTOR (the parameters are the ones of a brain)
+	/**
+      \param network contains the connections, the number of neurons is its number of neurons (the connections can not have their own delays or weights, see Connectivity::set_delays() and Connectivity::set_weights(), std::invalid_argument is thrown otherwise).
+      \param NE is the number of excitatory neurons (the first NE neurons).
+      \param dt is the time step for each update in ms.
+      \param v_ext is the mean number of background signals received by a neuron during one step.
+      \param Delay_Steps is the delay for a neuron to transmit a signal in number of time steps (at least 1).
+      \param Refractory_Time_Steps is the refractrory time for the neurons in number of time steps.
+      \param Vthr is the potential (mV) to exceed for a spike to appear.
+      \param Vreset is the initial and refractory potential (mV).
+      \param JE is the potential transmited when an excitatory neuron has a spike in number of J.
+      \param JI is the potential transmited when an inhibitory neuron has a spike in number of J.
+      \param J is the "potential step" transmitted between neurons in mV.
+      \param TAU is the membrane time constant (ms).
+    */
+	EventDrivenBrain(std::shared_ptr<const Connectivity> network, unsigned long NE, double dt = 0.1, double v_ext = 2.0, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double Vthr = 20.0, double Vreset = 0.0, double JE = 1.0, double JI = -5.0, double J = 0.1, double TAU = 20);
+
+		//getters
+	///getter for the number of neurons.
+	unsigned long get_nb_neurons() const;
+
+	///getter for the time of the last update (in number of steps).
+	unsigned long get_clock() const;
+
+	///getter for the membrane potential of a neuron at the time of the last update (mV).
+	double get_membrane_potential(unsigned long neuron_index) const;
+
+	///getter for the number of spikes of a neuron.
+	unsigned int get_nb_of_spikes(unsigned long neuron_index) const;
+
+	///getter for the number of times a neuron was updated because of an input (the work done by the engine).
+	unsigned long get_nb_of_updates() const;
+
+	///getter for the time of the last spike of a neuron.
+	/**
+	  \param neuron_index is the index of the neuron.
+	  \return the time in ms (not rounded to the step with the precise timing), 0 if the neuron never spiked.
+	*/
+	double get_last_spike_time(unsigned long neuron_index) const;
+
+	///gathers the membrane potentials of some neurons (computed at the time of the last update).
+	/**
+	  \param neuron_indexes contains the indexes of the neurons wanted.
+	  \param membrane_potentials is the array (of size neuron_indexes.size()) which receives the membrane potentials in mV.
+	*/
+	void gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const override;
+
+		//update
+	///sets the seed of the background noise (before the first update).
+	/**
+	  \param seed is the seed of the random generator of the background noise.
+	*/
+	void set_noise_seed(unsigned int seed);
+
+	///handles every input at its own time instead of rounding the times to the steps (before the first update).
+	/**
+	  The recorders are told about the spikes at the step which contains them.
+	  \param D is the delay of the connections (ms), at least dt.
+	  \param Refractory_Time is the refractory time (ms).
+	  \return false if the delay is shorter than dt or the brain was already updated.
+	*/
+	bool enable_precise_timing(double D, double Refractory_Time);
+
+	///attach a recorder which will be told about every spike and every end of update (the brain doesn't own it).
+	/**
+	  \param recorder is the recorder to attach.
+	*/
+	void attach_recorder(Recorder* recorder);
+
+	///handles the inputs of time T and sends the signals of the spikes.
+	/**
+      \param T is the new time (in number of steps, the next one after the clock).
+      \param file is the file in which the spikes are written.
+    */
+	void update(unsigned long T, std::ostream& file);
+
+	///updates the brain until a given time.
+	/**
+      \param Tstop is the time of the last update (in number of steps).
+      \param file is the file in which the spikes are written.
+    */
+	void run(unsigned long Tstop, std::ostream& file);
+
+	///DESTRUCTOR
+	~EventDrivenBrain();
+
+	private:
+	///an input waiting in the calendar queue.
+	struct Event {
+		unsigned long time; /**< step at which the input arrives */
+		double offset; /**< time of the input in the step with the precise timing (in (0, 1], 1 is the end of the step) */
+		std::uint32_t neuron; /**< transmitter of a spike, or receiver of the background noise */
+		bool background; /**< says if the input is background noise */
+	};
+
+	///handles the inputs of the bucket of time T with the times rounded to the step.
+	void update_grid(unsigned long T, std::ostream& file);
+
+	///handles the inputs of the bucket of time T at their own time.
+	void update_precise(unsigned long T, std::ostream& file);
+
+	///tells the recorders and the file about a spike.
+	void record_spike(std::uint32_t neuron, unsigned long T, double offset, std::ostream& file);
+
+	///schedules the next background arrival of a neuron.
+	/**
+      \param neuron is the index of the neuron.
+      \param arrival is the time of the arrival (in number of steps, not rounded, after the clock).
+    */
+	void schedule_background(std::uint32_t neuron, double arrival);
+
+	///adds an input to a neuron for the current step.
+	void add_input(std::uint32_t neuron, double input);
+
+	///handles the background arrivals of a neuron until a time of the current step (precise timing).
+	/**
+      \param neuron is the index of the neuron.
+      \param T is the current step.
+      \param time is the time until which the arrivals are handled (in number of steps, not rounded).
+      \param file is the file in which the spikes are written.
+    */
+	void receive_background(std::uint32_t neuron, unsigned long T, double time, std::ostream& file);
+
+	///handles an input of a neuron at its time (precise timing).
+	/**
+      \param neuron is the index of the neuron.
+      \param T is the current step.
+      \param offset is the time of the input in the step (in (0, 1]).
+      \param growth is exp(offset*dt/TAU).
+      \param input is the input in number of J.
+      \param file is the file in which the spikes are written.
+    */
+	void receive_precise_input(std::uint32_t neuron, unsigned long T, double offset, double growth, double input, std::ostream& file);
+
+	///draws the time between two background arrivals (in number of steps).
+	double inter_arrival();
+
+	///decay of the membrane potential during a number of steps.
+	double decay(unsigned long nb_steps) const;
+
+		//Parameters
+	const unsigned long nb_neurons_; /**< number of neurons */
+	const unsigned long NE_; /**< number of excitatory neurons */
+	const double dt_; /**< time step (ms) */
+	const double v_ext_; /**< mean number of background signals per step */
+	const unsigned int Delay_Steps_; /**< delay to receive a signal in number of time steps */
+	const unsigned int Refractory_Time_Steps_; /**< refractrory time in number of time steps */
+	const double Vthr_; /**< potential to exceed for a spike to appear (mV) */
+	const double Vreset_; /**< potential after a spike (mV) */
+	const double JE_; /**< potential transmited by an excitatory spike in number of J */
+	const double JI_; /**< potential transmited by an inhibitory spike in number of J */
+	const double J_; /**< "potential step" transmitted between neurons (mV) */
+	const double TAU_; /**< membrane time constant (ms) */
+	std::vector<double> decays_; /**< decay during k steps for the small k */
+
+		//Time
+	unsigned long time_; /**< clock */
+	unsigned long nb_of_updates_; /**< number of updates of neurons */
+
+		//State of the neurons
+	std::vector<double> membrane_potentials_; /**< membrane potentials at their reference time (mV) */
+	std::vector<unsigned long> reference_times_; /**< time from which the membrane potentials decay (end of the refractory period after a spike) */
+	std::vector<unsigned long> last_spike_times_; /**< time of the last spikes */
+	std::vector<unsigned char> spiked_; /**< says if the neurons had a spike */
+	std::vector<unsigned int> nb_of_spikes_; /**< number of spikes */
+	std::vector<double> next_arrivals_; /**< time of the next background arrival of each neuron (in number of steps, not rounded) */
+	std::vector<double> reference_offsets_; /**< offsets of the reference times in their step (precise timing) */
+	std::vector<double> last_spike_offsets_; /**< offsets of the last spikes in their step (precise timing) */
+
+		//Precise timing
+	bool precise_; /**< says if the times are not rounded to the steps */
+	unsigned long delay_steps_; /**< whole number of steps of the delay */
+	double delay_offset_; /**< rest of the delay (fraction of a step) */
+	unsigned long refractory_steps_; /**< whole number of steps of the refractory time */
+	double refractory_offset_; /**< rest of the refractory time (fraction of a step) */
+
+		//Inputs of the current step
+	std::vector<double> inputs_; /**< input of each neuron (number of J) */
+	std::vector<unsigned char> has_input_; /**< says if the neurons are in receivers_ */
+	std::vector<std::uint32_t> receivers_; /**< neurons with an input */
+	std::vector<Event> next_events_; /**< events created while a bucket is read */
+	std::vector<double> scaled_potentials_; /**< membrane potentials times exp(offset*dt/TAU) in the current step (precise timing) */
+	std::vector<unsigned long> scaled_times_; /**< step of the scaled potentials (0 if they have to be computed again) */
+	std::vector<Event> spike_events_; /**< spikes received in the current step (precise timing) */
+	std::vector<Event> background_events_; /**< background arrivals of the current step (precise timing) */
+
+		//Calendar queue
+	std::vector<std::vector<Event>> buckets_; /**< events of each step modulo the number of buckets */
+
+		//Background noise
+	std::mt19937 generator_; /**< random generator of the background noise */
+	bool started_; /**< says if the first background arrivals are scheduled */
+
+		//Connections and recorders
+	std::shared_ptr<const Connectivity> network_; /**< connections (can be shared with other brains) */
+	std::vector<Recorder*> recorders_; /**< the recorders attached to the brain (empty by default) */
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "fast_brain.h"
+#include "generated_models.h"
+#include <cmath>
+
+namespace {
+	///adds the signals of a bucket of receivers whose connections have weights.
+	/**
+	  \param signals are the signals of the step at which the bucket receives them.
+	  \param begin and end are the receivers of the bucket.
+	  \param codes are the codes of the weights of the receivers.
+	  \param signal is the signal of the code 1.
+	*/
+	template<class Code>
+	void add_weighted_signals(double* signals, const std::uint32_t* begin, const std::uint32_t* end, const Code* codes, double signal)
+	{
+		for (const std::uint32_t* receiver(begin) ; receiver != end ; ++receiver, ++codes) {
+			signals[*receiver] += signal * *codes;
+		}
+	}
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+template<class Model>
+FastBrain<Model>::FastBrain(std::shared_ptr<const Connectivity> network, unsigned long NE, const Model& model, double v_ext, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double JE, double JI)
+: nb_neurons_(network->get_nb_neurons()), NE_(NE), model_(model), dt_(model.get_dt()), v_ext_(v_ext)
+, Delay_Steps_(Delay_Steps > 0 ? Delay_Steps : 1), min_delay_(Delay_Steps_ + network->get_min_delay()), size_of_ring_(Delay_Steps_ + network->get_max_delay() + 1)
+, Refractory_Time_Steps_(Refractory_Time_Steps), JE_(JE), JI_(JI)
+, time_(0)
+, state_(Model::nb_variables * nb_neurons_, 0.0), refractory_ends_(nb_neurons_, 0.0), nb_of_spikes_(nb_neurons_, 0)
+, signals_(size_of_ring_ * nb_neurons_, 0.0)
+, generator_(std::random_device()()), background_noise_(POISSON_NOISE), gaussian_noise_(v_ext, std::sqrt(v_ext)), random_inputs_(nb_neurons_)
+, network_(network)
+{}
+
+//-------------------------------GETTERS------------------------------//
+template<class Model>
+unsigned long FastBrain<Model>::get_nb_neurons() const
+{
+	return nb_neurons_;
+}
+
+template<class Model>
+unsigned long FastBrain<Model>::get_clock() const
+{
+	return time_;
+}
+
+template<class Model>
+double FastBrain<Model>::get_membrane_potential(unsigned long neuron_index) const
+{
+	return state_[neuron_index];
+}
+
+template<class Model>
+unsigned int FastBrain<Model>::get_nb_of_spikes(unsigned long neuron_index) const
+{
+	return nb_of_spikes_[neuron_index];
+}
+
+template<class Model>
+const Model& FastBrain<Model>::get_model() const
+{
+	return model_;
+}
+
+template<class Model>
+void FastBrain<Model>::gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const
+{
+	const unsigned long nb_indexes(neuron_indexes.size());
+	for (unsigned long k(0) ; k<nb_indexes ; ++k) {
+		membrane_potentials[k] = state_[neuron_indexes[k]];
+	}
+}
+
+//--------------------------------UPDATE------------------------------//
+template<class Model>
+void FastBrain<Model>::set_noise_seed(unsigned int seed)
+{
+	generator_.seed(seed);
+}
+
+template<class Model>
+void FastBrain<Model>::set_background_noise(BackgroundNoise noise)
+{
+	background_noise_ = noise;
+}
+
+template<class Model>
+void FastBrain<Model>::attach_recorder(Recorder* recorder)
+{
+	if (recorder != nullptr) {
+		recorders_.push_back(recorder);
+	}
+}
+
+template<class Model>
+void FastBrain<Model>::update(unsigned long T, std::ostream& file)
+{
+	//the background inputs are drawn in the order of the neurons, as in a brain
+	if (background_noise_ == GAUSSIAN_NOISE) {
+		gaussian_noise_.generate(generator_, random_inputs_.data(), nb_neurons_);
+	} else {
+		std::poisson_distribution<> random_input(v_ext_);
+		for (auto& input : random_inputs_) {
+			input = random_input(generator_);
+		}
+	}
+
+	//the inputs of time T are used and cleared
+	model_.step(state_.data(), signals_.data() + (T % size_of_ring_)*nb_neurons_, random_inputs_.data(), refractory_ends_.data(), T, nb_neurons_);
+
+	const double threshold(model_.get_threshold());
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		if (state_[i] > threshold) {
+			model_.reset(state_.data(), nb_neurons_, i);
+			refractory_ends_[i] = T + Refractory_Time_Steps_;
+			++nb_of_spikes_[i];
+			pending_spikes_.push_back(std::make_pair(static_cast<std::uint32_t>(i), T));
+
+			file << T*dt_ << '\t' << i << '\n';
+			for (auto recorder : recorders_) {
+				recorder->record_spike(i, T);
+			}
+		}
+	}
+
+	//the first spike waiting is received at the next step
+	if (not pending_spikes_.empty() and pending_spikes_.front().second + min_delay_ <= T + 1) {
+		deliver_spikes();
+	}
+
+	time_ = T;
+	for (auto recorder : recorders_) {
+		recorder->end_of_step(*this, T);
+	}
+}
+
+template<class Model>
+void FastBrain<Model>::run(unsigned long Tstop, std::ostream& file)
+{
+	while (time_ < Tstop) {
+		update(time_+1, file);
+	}
+}
+
+template<class Model>
+void FastBrain<Model>::deliver_spikes()
+{
+	const double weight_scale(network_->get_weight_scale());
+	for (const auto& spike : pending_spikes_) {
+		const double signal(spike.first < NE_ ? JE_ : JI_);
+		const unsigned long nb_buckets(network_->get_nb_buckets(spike.first));
+		for (unsigned long bucket(0) ; bucket<nb_buckets ; ++bucket) {
+			//the signals of a bucket are received at T+Delay_Steps+its delay
+			double* delayed_signals(signals_.data() + ((spike.second + Delay_Steps_ + network_->get_bucket_delay(spike.first, bucket)) % size_of_ring_)*nb_neurons_);
+			const std::uint32_t* begin(network_->bucket_begin(spike.first, bucket));
+			const std::uint32_t* end(network_->bucket_end(spike.first, bucket));
+			const std::uint8_t* codes_8(network_->weight_codes_8(spike.first, bucket));
+			const std::uint16_t* codes_16(network_->weight_codes_16(spike.first, bucket));
+			if (codes_8 != nullptr) {
+				add_weighted_signals(delayed_signals, begin, end, codes_8, signal*weight_scale);
+			} else if (codes_16 != nullptr) {
+				add_weighted_signals(delayed_signals, begin, end, codes_16, signal*weight_scale);
+			} else {
+				for (const std::uint32_t* receiver(begin) ; receiver != end ; ++receiver) {
+					delayed_signals[*receiver] += signal;
+				}
+			}
+		}
+	}
+	pending_spikes_.clear();
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+template<class Model>
+FastBrain<Model>::~FastBrain()
+{}
+
+//the models for which the brain is compiled (the generated models are described in neuron_models.txt)
+template class FastBrain<LifModel>;
+template class FastBrain<ExponentialModel>;
+template class FastBrain<AdaptiveExponentialModel>;
+#define COMPILE_FAST_BRAIN(Model) template class FastBrain<Model>;
+GENERATED_MODELS(COMPILE_FAST_BRAIN)
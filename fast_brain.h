@@ -0,0 +1,144 @@
+#ifndef FAST_BRAIN_H
+#define FAST_BRAIN_H
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "connectivity.h"
+#include "gaussian_noise.h"
+#include "neuron_models.h"
+#include "recorder.h"
+
+///simulates the network of a brain with any model of neurons (see neuron_models.h), the same spikes as a brain with the same seed for a LifModel.
+/**
+  The state of the neurons is stored by arrays (one array for each variable of the model, one of refractory ends)
+  instead of one object per neuron, and the signals on the way are a ring of arrays of inputs (one for each step
+  until the longest delay), so that the neurons of a step are computed by one loop of the model which the compiler
+  vectorizes.
+  The delays of the connections (see Connectivity::set_delays()) are added to Delay_Steps. A spike is delivered
+  bucket by bucket, each bucket of receivers into the array of one future step. The spikes are delivered together
+  at the end of an interval of the shortest delay, the first step at which one of them has to be received, so that
+  the neurons are updated during the interval without reading the connections.
+  The weights of the connections (see Connectivity::set_weights()) multiply JE and JI: a signal is the code of
+  the weight of its connection times JE (or JI) times the scale of the codes.
+  The brain is a template on its model, so the kernel of the model is called without virtual call; the brain is
+  compiled for LifModel, ExponentialModel, AdaptiveExponentialModel and the models of neuron_models.txt, whose
+  classes are written at build time in generated_models.h (at the end of fast_brain.cpp).
+*/
+template<class Model = LifModel>
+class FastBrain : public RecordedNetwork {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param network contains the connections, the number of neurons is its number of neurons.
+      \param NE is the number of excitatory neurons (the first NE neurons).
+      \param model is the model of the neurons (with their time step).
+      \param v_ext is the mean number of background signals received by a neuron during one step.
+      \param Delay_Steps is the delay for a neuron to transmit a signal in number of time steps (at least 1), added to the delays of the connections.
+      \param Refractory_Time_Steps is the refractrory time for the neurons in number of time steps.
+      \param JE is the potential transmited when an excitatory neuron has a spike in number of J.
+      \param JI is the potential transmited when an inhibitory neuron has a spike in number of J.
+    */
+	FastBrain(std::shared_ptr<const Connectivity> network, unsigned long NE, const Model& model = Model(), double v_ext = 2.0, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double JE = 1.0, double JI = -5.0);
+
+		//getters
+	///getter for the number of neurons.
+	unsigned long get_nb_neurons() const;
+
+	///getter for the time of the last update (in number of steps).
+	unsigned long get_clock() const;
+
+	///getter for the membrane potential of a neuron (mV).
+	double get_membrane_potential(unsigned long neuron_index) const;
+
+	///getter for the number of spikes of a neuron.
+	unsigned int get_nb_of_spikes(unsigned long neuron_index) const;
+
+	///getter for the model of the neurons.
+	const Model& get_model() const;
+
+	///copies the membrane potentials of some neurons in an array.
+	/**
+	  \param neuron_indexes contains the indexes of the neurons wanted.
+	  \param membrane_potentials is the array (of size neuron_indexes.size()) which receives the membrane potentials in mV.
+	*/
+	void gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const override;
+
+		//update
+	///sets the seed of the background noise (by default it is random).
+	/**
+	  \param seed is the seed of the random generator of the background noise.
+	*/
+	void set_noise_seed(unsigned int seed);
+
+	///chooses the kind of background noise (Poisson by default, see Brain::set_background_noise()).
+	/**
+	  \param noise is the kind of background noise.
+	*/
+	void set_background_noise(BackgroundNoise noise);
+
+	///attach a recorder which will be told about every spike and every end of update (the brain doesn't own it).
+	/**
+	  \param recorder is the recorder to attach.
+	*/
+	void attach_recorder(Recorder* recorder);
+
+	///updates every neurons with time T and sends the signals of the spikes.
+	/**
+      \param T is the new time (in number of steps, the next one after the clock).
+      \param file is the file in which the spikes are written.
+    */
+	void update(unsigned long T, std::ostream& file);
+
+	///updates the brain until a given time.
+	/**
+      \param Tstop is the time of the last update (in number of steps).
+      \param file is the file in which the spikes are written.
+    */
+	void run(unsigned long Tstop, std::ostream& file);
+
+	///DESTRUCTOR
+	~FastBrain();
+
+	private:
+	///delivers the spikes waiting since the beginning of the interval into the signals of the steps at which they are received.
+	void deliver_spikes();
+
+		//Parameters
+	const unsigned long nb_neurons_; /**< number of neurons */
+	const unsigned long NE_; /**< number of excitatory neurons */
+	const Model model_; /**< model of the neurons */
+	const double dt_; /**< time step (ms) */
+	const double v_ext_; /**< mean number of background signals per step */
+	const unsigned int Delay_Steps_; /**< delay to receive a signal in number of time steps (without the delays of the connections) */
+	const unsigned int min_delay_; /**< shortest delay of the signals (interval between two deliveries of the spikes) */
+	const unsigned long size_of_ring_; /**< number of arrays of signals (longest delay of the signals + 1) */
+	const unsigned int Refractory_Time_Steps_; /**< refractrory time in number of time steps */
+	const double JE_; /**< potential transmited by an excitatory spike in number of J */
+	const double JI_; /**< potential transmited by an inhibitory spike in number of J */
+
+		//Time
+	unsigned long time_; /**< clock */
+
+		//State of the neurons
+	std::vector<double> state_; /**< variables of the neurons (Model::nb_variables arrays of nb_neurons_ values, the first one is the membrane potentials) */
+	std::vector<double> refractory_ends_; /**< first step at which the neurons are not refractory any more (a double, so that the loop on the neurons is vectorized) */
+	std::vector<unsigned int> nb_of_spikes_; /**< number of spikes */
+
+		//Signals received
+	std::vector<double> signals_; /**< inputs (number of J) of the next size_of_ring_ steps, one array of nb_neurons_ for each step modulo size_of_ring_ */
+	std::vector<std::pair<std::uint32_t, unsigned long>> pending_spikes_; /**< neuron and time of the spikes which are not delivered yet */
+
+		//Background noise
+	std::mt19937 generator_; /**< random generator of the background noise */
+	BackgroundNoise background_noise_; /**< kind of background noise */
+	GaussianNoise gaussian_noise_; /**< generator of the Gaussian background noise (mean and variance v_ext) */
+	std::vector<double> random_inputs_; /**< background input of the current step (number of J) */
+
+		//Connections and recorders
+	std::shared_ptr<const Connectivity> network_; /**< connections (can be shared with other brains) */
+	std::vector<Recorder*> recorders_; /**< the recorders attached to the brain (empty by default) */
+};
+
+#endif
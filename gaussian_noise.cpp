@@ -0,0 +1,74 @@
+#include "gaussian_noise.h"
+#include "kernel_math.h"
+#include <cmath>
+
+namespace {
+
+///uniform number in (0, 1) from 32 random bits (through a signed conversion, which is vectorized).
+inline double uniform(std::uint32_t bits)
+{
+	return (static_cast<std::int32_t>(bits ^ 0x80000000u) + 2147483648.5) * (1.0/4294967296.0);
+}
+
+///Box-Muller transform of n pairs of uniform numbers into the normal numbers first[k] and second[k].
+void box_muller(const std::uint32_t* __restrict first_bits, const std::uint32_t* __restrict second_bits, double* __restrict first, double* __restrict second, unsigned long n)
+{
+	for (unsigned long k(0) ; k<n ; ++k) {
+		//log(u) = e*log(2) + log(m) with m in [sqrt(1/2), sqrt(2)), e is found by steps of 16, 8, 4, 2 and 1
+		double m(uniform(first_bits[k])), e(0.0), s;
+		s = below(m, 1.0/65536.0); m *= 1.0 + 65535.0*s; e -= 16.0*s;
+		s = below(m, 1.0/256.0); m *= 1.0 + 255.0*s; e -= 8.0*s;
+		s = below(m, 1.0/16.0); m *= 1.0 + 15.0*s; e -= 4.0*s;
+		s = below(m, 1.0/4.0); m *= 1.0 + 3.0*s; e -= 2.0*s;
+		s = below(m, 1.0/2.0); m *= 1.0 + s; e -= s;
+		s = below(m, M_SQRT1_2); m *= 1.0 + s; e -= s;
+
+		//log(m) = 2*atanh(t) with |t| < 0.18
+		const double t((m - 1.0) / (m + 1.0)), t2(t*t);
+		const double log_m(2.0*t*(1.0 + t2*(1.0/3.0 + t2*(1.0/5.0 + t2*(1.0/7.0 + t2*(1.0/9.0 + t2*(1.0/11.0 + t2/13.0)))))));
+		const double radius(std::sqrt(-2.0*(log_m + e*M_LN2)));
+
+		//the angle is 2*y with y in (-pi/2, pi/2), the sine and cosine of y are Taylor series
+		const double y(M_PI*(uniform(second_bits[k]) - 0.5)), y2(y*y);
+		const double sine(y*(1.0 + y2*(-1.0/6.0 + y2*(1.0/120.0 + y2*(-1.0/5040.0 + y2*(1.0/362880.0 - y2/39916800.0))))));
+		const double cosine(1.0 + y2*(-1.0/2.0 + y2*(1.0/24.0 + y2*(-1.0/720.0 + y2*(1.0/40320.0 + y2*(-1.0/3628800.0 + y2/479001600.0))))));
+		first[k] = radius*(1.0 - 2.0*sine*sine);
+		second[k] = radius*2.0*sine*cosine;
+	}
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+GaussianNoise::GaussianNoise(double mean, double standard_deviation)
+: mean_(mean), standard_deviation_(standard_deviation)
+{}
+
+//--------------------------------UPDATE------------------------------//
+void GaussianNoise::generate(std::mt19937& generator, double* values, unsigned long nb_values)
+{
+	const unsigned long nb_pairs((nb_values+1) / 2);
+	uniform_numbers_.resize(2*nb_pairs);
+	pairs_.resize(nb_pairs);
+	for (auto& number : uniform_numbers_) {
+		number = generator();
+	}
+
+	box_muller(uniform_numbers_.data(), uniform_numbers_.data() + nb_pairs, values, pairs_.data(), nb_values/2);
+	if (nb_values % 2 == 1) {
+		//only the first number of the last pair is kept
+		box_muller(uniform_numbers_.data() + nb_pairs-1, uniform_numbers_.data() + 2*nb_pairs-1, values + nb_values-1, pairs_.data() + nb_pairs-1, 1);
+	}
+
+	for (unsigned long k(0) ; k<nb_values/2 ; ++k) {
+		values[k] = mean_ + standard_deviation_*values[k];
+		values[nb_values/2 + k] = mean_ + standard_deviation_*pairs_[k];
+	}
+	if (nb_values % 2 == 1) {
+		values[nb_values-1] = mean_ + standard_deviation_*values[nb_values-1];
+	}
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+GaussianNoise::~GaussianNoise()
+{}
@@ -0,0 +1,48 @@
+#ifndef GAUSSIAN_NOISE_H
+#define GAUSSIAN_NOISE_H
+#include <cstdint>
+#include <random>
+#include <vector>
+
+///the kinds of background input of the neurons.
+enum BackgroundNoise {
+	POISSON_NOISE, /**< a random number of excitatory signals J (Poisson distribution of mean v_ext), as in N. Brunel's model */
+	GAUSSIAN_NOISE /**< a continuous input with the same mean and variance (v_ext), the diffusion approximation */
+};
+
+///draws many normal numbers at once.
+/**
+  The numbers are made with the Box-Muller transform from the 32-bit uniform numbers of a mt19937, so
+  a saved generator gives back the same numbers. The logarithm, sine and cosine are polynomials without
+  branches, so the compiler vectorizes the transform (this file is compiled with -fno-math-errno for
+  the square root). They are exact to about 1e-6, and the tails are cut at 6.7 standard deviations
+  (the smallest uniform number is 2^-33): both are far below what a neuron receiving the noise can see.
+*/
+class GaussianNoise {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param mean is the mean of the numbers.
+      \param standard_deviation is the standard deviation of the numbers.
+    */
+	GaussianNoise(double mean = 0.0, double standard_deviation = 1.0);
+
+	///fills an array with independent normal numbers.
+	/**
+      \param generator gives the uniform numbers (two for each pair of normal numbers).
+      \param values is the array which receives the numbers.
+      \param nb_values is the size of the array.
+    */
+	void generate(std::mt19937& generator, double* values, unsigned long nb_values);
+
+	///DESTRUCTOR
+	~GaussianNoise();
+
+	private:
+	const double mean_; /**< mean of the numbers */
+	const double standard_deviation_; /**< standard deviation of the numbers */
+	std::vector<std::uint32_t> uniform_numbers_; /**< uniform numbers of the current array */
+	std::vector<double> pairs_; /**< second numbers of the pairs */
+};
+
+#endif
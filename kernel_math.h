@@ -0,0 +1,28 @@
+#ifndef KERNEL_MATH_H
+#define KERNEL_MATH_H
+#include <cmath>
+
+/**
+  Functions without branch for the loops on the neurons (see neuron_models.h), so that the compiler vectorizes them.
+*/
+
+///1 if x <= limit, 0 otherwise.
+inline double below(double x, double limit)
+{
+	return 0.5 + 0.5*std::copysign(1.0, limit - x);
+}
+
+///exp(x) exact to about 1e-8, x is clamped to [-40, 40].
+inline double exponential(double x)
+{
+	//exp(x) = exp(x/64)^64 with a Taylor series for |x/64| <= 0.625
+	const double low(below(x, -40.0)), high(1.0 - below(x, 40.0));
+	const double y((low*(-40.0) + high*40.0 + (1.0 - low - high)*x) / 64.0);
+	double result(1.0 + y*(1.0 + y*(1.0/2.0 + y*(1.0/6.0 + y*(1.0/24.0 + y*(1.0/120.0 + y*(1.0/720.0 + y*(1.0/5040.0 + y*(1.0/40320.0 + y*(1.0/362880.0 + y/3628800.0))))))))));
+	for (unsigned int k(0) ; k<6 ; ++k) {
+		result *= result;
+	}
+	return result;
+}
+
+#endif
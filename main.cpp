@@ -1,9 +1,27 @@
 #include "simulation.h"
+#include "population_analyzer.h"
+#include "spike_statistics.h"
+#include "sweep.h"
 #include <iostream>
 #include <fstream>
+#include <string>
 
-int main()
+int main(int argc, char** argv)
 {
+	//batch mode: "./simulation --sweep file" runs every simulation described in the file
+	if (argc == 3 and std::string(argv[1]) == "--sweep") {
+		Sweep sweep;
+		if (not sweep.read_file(argv[2])) {
+			return 1;
+		}
+		sweep.run();
+		std::cout << "Done" << std::endl;
+		return 0;
+	}
+	
+	//preview mode: "./simulation --preview" simulates the densities of the populations instead of the neurons
+	const bool preview(argc == 2 and std::string(argv[1]) == "--preview");
+	
 	double t_stop;
 	std::cout << "How long is the simulation (ms)? ";
 	std::cin >> t_stop;
@@ -36,8 +54,31 @@ int main()
 		std::cin >> ETA;
 	}
 	
+	//the population rates and spectra are computed during the simulation
+	PopulationAnalyzer analyzer(10000, 2500, dt);
+	
+	//the preview doesn't create the neurons and their connections
+	if (preview) {
+		PopulationDensity density(Simulation::population_density(10000, 2500, dt, g, ETA));
+		density.attach_recorder(&analyzer);
+		
+		//saving the rates in the file "rates.txt"
+		std::ofstream file;
+		file.open("rates.txt");
+		density.run(static_cast<int>(t_stop*10) / static_cast<int>(dt*10), file);
+		file.close();
+		
+		analyzer.save("population.txt");
+		std::cout << "Excitatory rate: " << analyzer.get_mean_rate(true) << " Hz, inhibitory rate: " << analyzer.get_mean_rate(false) << " Hz" << std::endl;
+		std::cout << "Done" << std::endl;
+		return 0;
+	}
+	
 	//creation of the simulation
 	Simulation sim(10000, 2500, dt, t_stop, g, ETA);
+	sim.attach_recorder(&analyzer);
+	SpikeStatistics statistics(12500, dt);
+	sim.attach_recorder(&statistics);
 	
 	std::cout << "GO!!!" << std::endl;
 	
@@ -49,6 +90,10 @@ int main()
 	
 	file.close();
 	
+	analyzer.save("population.txt");
+	std::cout << "Excitatory rate: " << analyzer.get_mean_rate(true) << " Hz, inhibitory rate: " << analyzer.get_mean_rate(false) << " Hz" << std::endl;
+	std::cout << "CV: " << statistics.get_mean_cv() << ", Fano factor: " << statistics.get_mean_fano_factor() << ", correlation: " << statistics.get_mean_correlation() << std::endl;
+	
 	std::cout << "Done" << std::endl;
 	
 	return 0;
@@ -0,0 +1,183 @@
+#include "mean_field.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+///exp(u^2)*(1+erf(u)), the function integrated by the Siegert formula.
+double siegert_integrand(double u)
+{
+	if (u < -25.0) {
+		//asymptotic expansion, exp(u^2) and erfc(-u) would be out of range
+		const double x(-u), x2(x*x);
+		return (1.0 - 1.0/(2.0*x2) + 3.0/(4.0*x2*x2)) / (x*std::sqrt(M_PI));
+	}
+	if (u < 0.0) {
+		return std::exp(u*u) * std::erfc(-u);
+	}
+	return std::exp(u*u) * (1.0 + std::erf(u));
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+MeanField::MeanField(unsigned long CE, unsigned long CI, double J, double D, double Refractory_Time, double Vthr, double Vreset, double TAU)
+: CE_(CE), CI_(CI), J_(J), D_(D), Refractory_Time_(Refractory_Time), Vthr_(Vthr), Vreset_(Vreset), TAU_(TAU)
+{}
+
+//-----------------------------PREDICTION-----------------------------//
+double MeanField::transfer(double mu, double sigma) const
+{
+	if (sigma <= 0.0) {
+		//without noise the neuron only spikes if the mean input is over the threshold
+		if (mu <= Vthr_) {
+			return 0.0;
+		}
+		return 1000.0 / (Refractory_Time_ + TAU_*std::log((mu-Vreset_) / (mu-Vthr_)));
+	}
+
+	const double lower((Vreset_-mu) / sigma), upper((Vthr_-mu) / sigma);
+	if (upper > 26.0) {
+		//the integral is out of range, the rate is negligible
+		return 0.0;
+	}
+
+	//Simpson's rule, the integrand is smooth but grows like exp(u^2) for u > 0
+	unsigned int nb_intervals(std::min(4000u, std::max(100u, static_cast<unsigned int>(50.0*(upper-lower)))));
+	nb_intervals += nb_intervals % 2;
+	const double step((upper-lower) / nb_intervals);
+	double sum(siegert_integrand(lower) + siegert_integrand(upper));
+	for (unsigned int k(1) ; k<nb_intervals ; ++k) {
+		sum += (k % 2 == 1 ? 4.0 : 2.0) * siegert_integrand(lower + k*step);
+	}
+	const double integral(sum * step / 3.0);
+
+	return 1000.0 / (Refractory_Time_ + TAU_*std::sqrt(M_PI)*integral);
+}
+
+double MeanField::cv(double mu, double sigma) const
+{
+	const double rate(transfer(mu, sigma) * 1e-3);
+	if (sigma <= 0.0 or rate <= 0.0) {
+		return 0.0;
+	}
+
+	//CV^2 = 2*pi*(rate*TAU)^2 * integral from lower to upper of exp(x^2) * (integral from -infinity to x of exp(y^2)*(1+erf(y))^2 dy) dx
+	const double lower((Vreset_-mu) / sigma), upper((Vthr_-mu) / sigma);
+	auto inner_integrand = [](double y) {
+		const double f(siegert_integrand(y));
+		return f*f*std::exp(-y*y);
+	};
+
+	//under -8 the inner integral is negligible and exp(x^2) times it is 1/(2*pi*|x|^3), so the inner integral starts at -8
+	const double start(-8.0);
+	double inner(0.0);
+	if (lower > start) {
+		const unsigned int nb_start(std::max(2u, static_cast<unsigned int>(50.0*(lower-start))));
+		const double start_step((lower-start) / nb_start);
+		for (unsigned int k(0) ; k<nb_start ; ++k) {
+			inner += 0.5*start_step*(inner_integrand(start + k*start_step) + inner_integrand(start + (k+1)*start_step));
+		}
+	}
+	auto outer_integrand = [start](double x, double inner) {
+		return x < start ? 1.0 / (2.0*M_PI*std::fabs(x*x*x)) : std::exp(x*x)*inner;
+	};
+
+	//both integrals together from the lower to the upper bound (trapezoidal rule)
+	const unsigned int nb_intervals(std::min(8000u, std::max(200u, static_cast<unsigned int>(100.0*(upper-lower)))));
+	const double step((upper-lower) / nb_intervals);
+	double outer(0.0), previous(outer_integrand(lower, inner));
+	for (unsigned int k(1) ; k<=nb_intervals ; ++k) {
+		const double x(lower + k*step);
+		if (x > start) {
+			const double y(std::max(x-step, start));
+			inner += 0.5*(x-y)*(inner_integrand(y) + inner_integrand(x));
+		}
+		const double current(outer_integrand(x, inner));
+		outer += 0.5*step*(previous + current);
+		previous = current;
+	}
+
+	return std::sqrt(2.0*M_PI*outer)*rate*TAU_;
+}
+
+void MeanField::input(double rate, double g, double ETA, double& mu, double& sigma) const
+{
+	//the rates are in spikes per ms in the formulas
+	const double recurrent(rate * 1e-3 * TAU_);
+	mu = recurrent*J_*(CE_ - g*CI_) + ETA*Vthr_;
+	sigma = std::sqrt(recurrent*J_*J_*(CE_ + g*g*CI_) + J_*ETA*Vthr_);
+}
+
+double MeanField::loop(double rate, double g, double ETA) const
+{
+	double mu, sigma;
+	input(rate, g, ETA, mu, sigma);
+	return transfer(mu, sigma);
+}
+
+double MeanField::stationary_rate(double g, double ETA) const
+{
+	//loop(rate) - rate is positive at 0 and negative at the maximal rate: the first change of sign is searched on a logarithmic scale
+	const double max_rate(1000.0 / Refractory_Time_);
+	if (loop(0.0, g, ETA) <= 0.0) {
+		return 0.0;
+	}
+	double low(0.0), high(max_rate);
+	for (double rate(1e-3) ; rate<max_rate ; rate *= 1.25) {
+		if (loop(rate, g, ETA) < rate) {
+			high = rate;
+			break;
+		}
+		low = rate;
+	}
+
+	for (unsigned int k(0) ; k<60 and high-low > 1e-9*high ; ++k) {
+		const double middle(0.5*(low+high));
+		if (loop(middle, g, ETA) < middle) {
+			high = middle;
+		} else {
+			low = middle;
+		}
+	}
+	return 0.5*(low+high);
+}
+
+MeanFieldPrediction MeanField::predict(double g, double ETA, double min_rate, double min_cv) const
+{
+	MeanFieldPrediction prediction;
+	prediction.rate = stationary_rate(g, ETA);
+	input(prediction.rate, g, ETA, prediction.mu, prediction.sigma);
+	prediction.cv = cv(prediction.mu, prediction.sigma);
+
+	//slow changes
+	const double h(std::max(1e-3*prediction.rate, 1e-4));
+	if (prediction.rate > h) {
+		prediction.static_gain = (loop(prediction.rate+h, g, ETA) - loop(prediction.rate-h, g, ETA)) / (2.0*h);
+	} else {
+		prediction.static_gain = (loop(prediction.rate+h, g, ETA) - loop(prediction.rate, g, ETA)) / h;
+	}
+
+	//fast changes: a change r1 of the rate changes mu by TAU*J*r1*(g*CI - CE) with the opposite sign, which changes the rate by
+	//rate/sigma*sqrt(2/(i*w*TAU)) times this after the delay, the phase is -pi at w = 3*pi/(4*D)
+	const double omega(3.0*M_PI / (4.0*D_));
+	prediction.frequency = omega / (2.0*M_PI) * 1000.0;
+	prediction.critical_gain = std::sqrt(omega*TAU_ / 2.0);
+	prediction.oscillation_gain = std::max(0.0, prediction.rate*1e-3 * TAU_*J_*(g*CI_ - 1.0*CE_) / prediction.sigma);
+	prediction.stable = prediction.static_gain < 1.0 and prediction.oscillation_gain < prediction.critical_gain;
+
+	if (prediction.rate < min_rate) {
+		prediction.regime = QUIESCENT;
+	} else if (prediction.cv < min_cv or prediction.static_gain >= 1.0) {
+		prediction.regime = SYNCHRONOUS_REGULAR;
+	} else if (not prediction.stable) {
+		prediction.regime = SYNCHRONOUS_IRREGULAR;
+	} else {
+		prediction.regime = ASYNCHRONOUS_IRREGULAR;
+	}
+	return prediction;
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+MeanField::~MeanField()
+{}
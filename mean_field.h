@@ -0,0 +1,111 @@
+#ifndef MEAN_FIELD_H
+#define MEAN_FIELD_H
+#include "regime.h"
+
+///what the mean-field theory predicts for a point (g, ETA).
+struct MeanFieldPrediction {
+	double rate; /**< stationary rate of the neurons (Hz) */
+	double mu; /**< mean input of the neurons (mV) */
+	double sigma; /**< standard deviation of the input of the neurons (mV) */
+	double cv; /**< coefficient of variation of the interspike intervals */
+	double static_gain; /**< change of the stationary rate caused by a slow change of the rate through the connections */
+	double oscillation_gain; /**< gain of the fast changes of the rate through the connections (0 when excitation dominates) */
+	double critical_gain; /**< oscillation gain over which the asynchronous state becomes oscillatory */
+	double frequency; /**< frequency of the oscillations which appear at the critical gain (Hz) */
+	bool stable; /**< says if the asynchronous state is stable */
+	Regime regime; /**< regime predicted */
+};
+
+///stationary rate and stability of the asynchronous state of the network (N. Brunel, 2000).
+/**
+  Each neuron receives a Gaussian input of mean mu and variance sigma^2 from its CE excitatory and CI
+  inhibitory connections and from the background noise:
+  mu = TAU*J*rate*(CE - g*CI) + ETA*Vthr and sigma^2 = TAU*J^2*rate*(CE + g^2*CI) + J*ETA*Vthr.
+  The stationary rate is the solution of rate = phi(mu(rate), sigma(rate)), where phi is the rate of a
+  leaky integrate-and-fire neuron with this input (Siegert formula). The smallest solution is taken.
+  The CV of the interspike intervals of a neuron with this input is computed too.
+
+  The stability is a reduced version of Brunel's analysis, with two conditions:
+  - slow changes: the rate runs away if dphi/drate >= 1 (excitation dominated networks),
+  - fast changes: at high frequency the rate of a noisy integrate-and-fire neuron follows a change of its mean
+    input mu1 as rate*mu1/sigma*sqrt(2/(i*w*TAU)) (N. Brunel and V. Hakim, 1999). A change of the rate comes
+    back through the inhibition after the delay D, with a phase of -pi when w*D = 3*pi/4, and the asynchronous
+    state is unstable if its gain is then over 1 (fast oscillations of the inhibition dominated networks).
+  The slow oscillations near g = 4 at low ETA need the full analysis and are not predicted, so the boundaries
+  are approximate: the prediction is a fast preview, not a replacement for the simulation.
+*/
+class MeanField {
+	public:
+	///CONSTRUCTOR (the default values are the ones of Simulation)
+	/**
+      \param CE is the number of excitatory connections received by each neuron.
+      \param CI is the number of inhibitory connections received by each neuron.
+      \param J is the potential (mV) transmitted by an excitatory connection.
+      \param D is the delay of the connections (ms).
+      \param Refractory_Time is the refractory time (ms).
+      \param Vthr is the potential (mV) to exceed for a spike to appear.
+      \param Vreset is the potential (mV) after a spike.
+      \param TAU is the membrane time constant (ms).
+    */
+	MeanField(unsigned long CE = 1000, unsigned long CI = 250, double J = 0.1, double D = 1.5, double Refractory_Time = 2.0, double Vthr = 20.0, double Vreset = 0.0, double TAU = 20.0);
+
+	///rate of a leaky integrate-and-fire neuron receiving a Gaussian input (Siegert formula).
+	/**
+      \param mu is the mean input (mV).
+      \param sigma is the standard deviation of the input (mV).
+      \return the rate in Hz.
+    */
+	double transfer(double mu, double sigma) const;
+
+	///computes the input of the neurons for a rate of the network.
+	/**
+      \param rate is the rate of the neurons (Hz).
+      \param g is the positive ratio of JI/JE.
+      \param ETA is the ratio v_ext/v_thr.
+      \param mu receives the mean input (mV).
+      \param sigma receives the standard deviation of the input (mV).
+    */
+	void input(double rate, double g, double ETA, double& mu, double& sigma) const;
+
+	///solves the self-consistent equation of the stationary rate.
+	/**
+      \return the smallest stationary rate (Hz).
+    */
+	double stationary_rate(double g, double ETA) const;
+
+	///coefficient of variation of the interspike intervals of a leaky integrate-and-fire neuron receiving a Gaussian input.
+	/**
+      \param mu is the mean input (mV).
+      \param sigma is the standard deviation of the input (mV).
+      \return the CV (0 without spikes).
+    */
+	double cv(double mu, double sigma) const;
+
+	///predicts the stationary rate and the stability of the asynchronous state.
+	/**
+      \param g is the positive ratio of JI/JE.
+      \param ETA is the ratio v_ext/v_thr.
+      \param min_rate is the rate (Hz) under which the network is considered quiescent (as in classify_regime()).
+      \param min_cv is the CV over which the neurons are considered irregular (as in classify_regime()).
+      \return the prediction.
+    */
+	MeanFieldPrediction predict(double g, double ETA, double min_rate = 0.1, double min_cv = 0.5) const;
+
+	///DESTRUCTOR
+	~MeanField();
+
+	private:
+	///rate of the network after one loop through the connections (Hz).
+	double loop(double rate, double g, double ETA) const;
+
+	const unsigned long CE_; /**< number of excitatory connections received by each neuron */
+	const unsigned long CI_; /**< number of inhibitory connections received by each neuron */
+	const double J_; /**< potential transmitted by an excitatory connection (mV) */
+	const double D_; /**< delay (ms) */
+	const double Refractory_Time_; /**< refractory time (ms) */
+	const double Vthr_; /**< threshold (mV) */
+	const double Vreset_; /**< reset potential (mV) */
+	const double TAU_; /**< membrane time constant (ms) */
+};
+
+#endif
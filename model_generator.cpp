@@ -0,0 +1,442 @@
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+  Writes the models of neurons described in a file (see neuron_models.txt) as classes for FastBrain, with the same
+  interface as the models of neuron_models.h. It is run by CMake when the description changes:
+	model_generator description header source
+  The header also defines GENERATED_MODELS(X), which calls X with each class (fast_brain.cpp compiles the brain for them).
+*/
+
+namespace {
+
+///a parameter or a constant of a model.
+struct Value {
+	std::string name; /**< name in the expressions (the member is name_) */
+	std::string value; /**< default value of a parameter, expression of a constant */
+	std::string text; /**< documentation */
+};
+
+///a state variable of a model.
+struct Variable {
+	std::string name; /**< name in the expressions (its value before the step or the reset) */
+	std::string text; /**< documentation */
+	std::string update; /**< value after one step */
+	std::string weight; /**< effect of an input (empty if the inputs don't change the variable) */
+	std::string reset; /**< value after a spike (empty if the spikes don't change the variable) */
+};
+
+///the description of a model.
+struct Model {
+	std::string name; /**< name of the class */
+	std::string text; /**< documentation of the class */
+	std::vector<Value> parameters; /**< parameters of the constructor */
+	std::vector<Value> constants; /**< values computed by the constructor */
+	std::vector<Variable> variables; /**< state variables, the first one is the membrane potential */
+	std::string threshold; /**< membrane potential to exceed for a spike */
+};
+
+///the names used by the kernels, which can't be the names of a model.
+const std::set<std::string> reserved_names = {"i", "time", "active", "state", "signals", "random_inputs", "refractory_ends", "nb_neurons", "neuron_index", "inputs", "noise", "ends"};
+
+///the rest of a line of words.
+std::string rest_of(std::istringstream& words)
+{
+	std::string rest;
+	std::getline(words >> std::ws, rest);
+	while (not rest.empty() and std::isspace(static_cast<unsigned char>(rest.back()))) {
+		rest.pop_back();
+	}
+	return rest;
+}
+
+///says if a word is a name which can be given to a value or a variable.
+bool is_valid_name(const std::string& word)
+{
+	if (word.empty() or not (std::isalpha(static_cast<unsigned char>(word[0])) or word[0] == '_') or reserved_names.count(word) > 0) {
+		return false;
+	}
+	for (char c : word) {
+		if (not (std::isalnum(static_cast<unsigned char>(c)) or c == '_')) {
+			return false;
+		}
+	}
+	return word.compare(0, 4, "new_") != 0 and (word.size() < 7 or word.compare(word.size()-7, 7, "_values") != 0);
+}
+
+///the names (words which could be names) used by an expression.
+std::set<std::string> names_in(const std::string& expression)
+{
+	std::set<std::string> names;
+	std::string name;
+	for (char c : expression + ' ') {
+		if (std::isalnum(static_cast<unsigned char>(c)) or c == '_') {
+			name += c;
+		} else {
+			if (not name.empty() and not std::isdigit(static_cast<unsigned char>(name[0]))) {
+				names.insert(name);
+			}
+			name.clear();
+		}
+	}
+	return names;
+}
+
+///the variable of a model with a name (nullptr if there is none).
+Variable* find_variable(Model& model, const std::string& name)
+{
+	for (auto& variable : model.variables) {
+		if (variable.name == name) {
+			return &variable;
+		}
+	}
+	return nullptr;
+}
+
+///says if a name is already used by a model.
+bool is_used(const Model& model, const std::string& name)
+{
+	for (const auto& parameter : model.parameters) {
+		if (parameter.name == name) {
+			return true;
+		}
+	}
+	for (const auto& constant : model.constants) {
+		if (constant.name == name) {
+			return true;
+		}
+	}
+	for (const auto& variable : model.variables) {
+		if (variable.name == name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+///checks that a model can be written (the expressions are checked by the compiler).
+bool check(const Model& model, std::ostream& errors)
+{
+	bool has_dt(false);
+	for (const auto& parameter : model.parameters) {
+		has_dt = has_dt or parameter.name == "dt";
+	}
+	if (not has_dt or model.variables.empty() or model.threshold.empty()) {
+		errors << "Model " << model.name << " needs a parameter dt, a variable and a threshold." << std::endl;
+		return false;
+	}
+
+	//the constants are initialised by the constructor, where only the names of the parameters are declared
+	bool good(true);
+	for (const auto& constant : model.constants) {
+		for (const auto& name : names_in(constant.value)) {
+			bool is_parameter(false);
+			for (const auto& parameter : model.parameters) {
+				is_parameter = is_parameter or parameter.name == name;
+			}
+			if (is_used(model, name) and not is_parameter) {
+				errors << "Model " << model.name << ": the constant " << constant.name << " can only use parameters, not " << name << '.' << std::endl;
+				good = false;
+			}
+		}
+	}
+	return good;
+}
+
+///reads the descriptions of the models.
+/**
+  \param in is the stream of the description.
+  \param models receives the models.
+  \param errors receives the lines which can't be read.
+  \return false if the description has errors.
+*/
+bool read(std::istream& in, std::vector<Model>& models, std::ostream& errors)
+{
+	bool good(true), in_model(false);
+	std::string line;
+	unsigned int line_number(0);
+	while (std::getline(in, line)) {
+		++line_number;
+		line = line.substr(0, line.find('#'));
+		std::istringstream words(line);
+		std::string command, name;
+		if (not (words >> command)) {
+			continue;
+		}
+
+		bool valid(false);
+		if (command == "model") {
+			valid = not in_model and (words >> name) and is_valid_name(name);
+			models.push_back(Model());
+			models.back().name = name;
+			in_model = true;
+		} else if (not in_model) {
+			valid = false;
+		} else if (command == "end") {
+			valid = check(models.back(), errors);
+			in_model = false;
+		} else if (command == "doc") {
+			models.back().text = rest_of(words);
+			valid = not models.back().text.empty();
+		} else if (command == "parameter" or command == "constant") {
+			Value value;
+			valid = (words >> value.name) and is_valid_name(value.name) and not is_used(models.back(), value.name);
+			if (command == "parameter") {
+				double number;
+				valid = valid and (words >> value.value);
+				std::istringstream default_value(value.value);
+				valid = valid and (default_value >> number) and default_value.eof();
+				value.text = rest_of(words);
+				models.back().parameters.push_back(value);
+			} else {
+				value.value = rest_of(words);
+				value.text = value.value;
+				valid = valid and not value.value.empty();
+				models.back().constants.push_back(value);
+			}
+		} else if (command == "variable") {
+			Variable variable;
+			valid = (words >> variable.name) and is_valid_name(variable.name) and not is_used(models.back(), variable.name);
+			variable.text = rest_of(words);
+			variable.update = variable.name;
+			models.back().variables.push_back(variable);
+		} else if (command == "update" or command == "input" or command == "reset") {
+			Variable* variable((words >> name) ? find_variable(models.back(), name) : nullptr);
+			const std::string expression(rest_of(words));
+			valid = variable != nullptr and not expression.empty();
+			if (valid) {
+				(command == "update" ? variable->update : command == "input" ? variable->weight : variable->reset) = expression;
+			}
+		} else if (command == "threshold") {
+			models.back().threshold = rest_of(words);
+			valid = not models.back().threshold.empty();
+		}
+
+		if (not valid) {
+			errors << "Model description, line " << line_number << " can not be read: " << line << std::endl;
+			good = false;
+		}
+	}
+	if (in_model) {
+		errors << "Model description: the last model has no end." << std::endl;
+		good = false;
+	}
+	return good;
+}
+
+///declares the parameters and constants used by some expressions as local constants (so that the expressions use their names).
+void write_values(std::ostream& out, const Model& model, const std::set<std::string>& names)
+{
+	for (const auto& parameter : model.parameters) {
+		if (names.count(parameter.name) > 0) {
+			out << "\tconst double " << parameter.name << '(' << parameter.name << "_);\n";
+		}
+	}
+	for (const auto& constant : model.constants) {
+		if (names.count(constant.name) > 0) {
+			out << "\tconst double " << constant.name << '(' << constant.name << "_);\n";
+		}
+	}
+}
+
+///writes the declaration of a model.
+void write_declaration(std::ostream& out, const Model& model)
+{
+	out << "///" << model.text << "\n";
+	out << "class " << model.name << " {\n";
+	out << "\tpublic:\n";
+	out << "\tstatic const unsigned int nb_variables = " << model.variables.size() << "; /**<";
+	for (unsigned int k(0) ; k<model.variables.size() ; ++k) {
+		out << (k > 0 ? "," : "") << ' ' << model.variables[k].name << " (" << model.variables[k].text << ')';
+	}
+	out << " */\n\n";
+
+	out << "\t///CONSTRUCTOR\n\t/**\n";
+	for (const auto& parameter : model.parameters) {
+		out << "      \\param " << parameter.name << " is the " << parameter.text << ".\n";
+	}
+	out << "    */\n\t" << model.name << '(';
+	for (unsigned int k(0) ; k<model.parameters.size() ; ++k) {
+		out << (k > 0 ? ", " : "") << "double " << model.parameters[k].name << " = " << model.parameters[k].value;
+	}
+	out << ");\n\n";
+
+	out << "\t///getter for the time step (ms).\n";
+	out << "\tdouble get_dt() const;\n\n";
+	out << "\t///computes one step of the neurons (see LifModel::step()).\n";
+	out << "\tvoid step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const;\n\n";
+	out << "\t///getter for the membrane potential to exceed for a spike to appear (mV).\n";
+	out << "\tdouble get_threshold() const;\n\n";
+	out << "\t///resets a neuron after a spike.\n";
+	out << "\tvoid reset(double* state, unsigned long nb_neurons, unsigned long neuron_index) const;\n\n";
+
+	out << "\tprivate:\n";
+	for (const auto& parameter : model.parameters) {
+		out << "\tconst double " << parameter.name << "_; /**< " << parameter.text << " */\n";
+	}
+	for (const auto& constant : model.constants) {
+		out << "\tconst double " << constant.name << "_; /**< " << constant.text << " */\n";
+	}
+	out << "};\n\n";
+}
+
+///writes the definitions of the methods of a model.
+void write_definition(std::ostream& out, const Model& model)
+{
+	std::string name;
+	for (char c : model.name) {
+		if (std::isupper(static_cast<unsigned char>(c)) and not name.empty()) {
+			name += '-';
+		}
+		name += std::toupper(static_cast<unsigned char>(c));
+	}
+	const std::string dashes(name.size() < 64 ? (64 - name.size()) / 2 : 1, '-');
+	out << "//" << dashes << name << dashes << "//\n";
+
+	//constructor
+	out << model.name << "::" << model.name << '(';
+	for (unsigned int k(0) ; k<model.parameters.size() ; ++k) {
+		out << (k > 0 ? ", " : "") << "double " << model.parameters[k].name;
+	}
+	out << ")\n: ";
+	for (unsigned int k(0) ; k<model.parameters.size() ; ++k) {
+		out << (k > 0 ? ", " : "") << model.parameters[k].name << "_(" << model.parameters[k].name << ')';
+	}
+	for (const auto& constant : model.constants) {
+		out << ", " << constant.name << "_(" << constant.value << ')';
+	}
+	out << "\n{}\n\n";
+
+	out << "double " << model.name << "::get_dt() const\n{\n\treturn dt_;\n}\n\n";
+
+	//step: the variables are read, then written, so that each update uses the values before the step
+	std::set<std::string> names;
+	for (const auto& variable : model.variables) {
+		for (const auto& used : names_in(variable.update + ' ' + variable.weight)) {
+			names.insert(used);
+		}
+	}
+	const Variable& potential(model.variables[0]);
+	names.insert(potential.name);
+	out << "void " << model.name << "::step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const\n{\n";
+	for (unsigned int k(0) ; k<model.variables.size() ; ++k) {
+		out << "\tdouble* __restrict " << model.variables[k].name << "_values(state";
+		if (k > 0) {
+			out << " + " << k << "*nb_neurons";
+		}
+		out << ");\n";
+	}
+	out << "\tdouble* __restrict inputs(signals);\n";
+	out << "\tconst double* __restrict noise(random_inputs);\n";
+	out << "\tconst double* __restrict ends(refractory_ends);\n";
+	write_values(out, model, names);
+	out << "\tfor (unsigned long i(0) ; i<nb_neurons ; ++i) {\n";
+	out << "\t\tconst double active(below(ends[i], time));\n";
+	for (const auto& variable : model.variables) {
+		if (names.count(variable.name) > 0) {
+			out << "\t\tconst double " << variable.name << '(' << variable.name << "_values[i]);\n";
+		}
+	}
+	for (const auto& variable : model.variables) {
+		out << "\t\tconst double new_" << variable.name << "((" << variable.update << ')';
+		if (not variable.weight.empty()) {
+			out << " + (" << variable.weight << ")*inputs[i] + (" << variable.weight << ")*noise[i]";
+		}
+		out << ");\n";
+	}
+	out << "\t\t" << potential.name << "_values[i] = active*new_" << potential.name << " + (1.0 - active)*" << potential.name << ";\n";
+	for (unsigned int k(1) ; k<model.variables.size() ; ++k) {
+		out << "\t\t" << model.variables[k].name << "_values[i] = new_" << model.variables[k].name << ";\n";
+	}
+	out << "\t\tinputs[i] = 0.0;\n";
+	out << "\t}\n}\n\n";
+
+	//threshold
+	out << "double " << model.name << "::get_threshold() const\n{\n";
+	write_values(out, model, names_in(model.threshold));
+	out << "\treturn " << model.threshold << ";\n}\n\n";
+
+	//reset
+	names.clear();
+	for (const auto& variable : model.variables) {
+		for (const auto& used : names_in(variable.reset)) {
+			names.insert(used);
+		}
+	}
+	bool uses_nb_neurons(false);
+	for (unsigned int k(1) ; k<model.variables.size() ; ++k) {
+		uses_nb_neurons = uses_nb_neurons or not model.variables[k].reset.empty() or names.count(model.variables[k].name) > 0;
+	}
+	out << "void " << model.name << "::reset(double* state, unsigned long" << (uses_nb_neurons ? " nb_neurons" : "") << ", unsigned long neuron_index) const\n{\n";
+	for (unsigned int k(0) ; k<model.variables.size() ; ++k) {
+		if (names.count(model.variables[k].name) > 0) {
+			out << "\tconst double " << model.variables[k].name << "(state[";
+			if (k > 0) {
+				out << k << "*nb_neurons + ";
+			}
+			out << "neuron_index]);\n";
+		}
+	}
+	write_values(out, model, names);
+	for (unsigned int k(0) ; k<model.variables.size() ; ++k) {
+		if (not model.variables[k].reset.empty()) {
+			out << "\tstate[";
+			if (k > 0) {
+				out << k << "*nb_neurons + ";
+			}
+			out << "neuron_index] = " << model.variables[k].reset << ";\n";
+		}
+	}
+	out << "}\n\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 4) {
+		std::cerr << "Usage: model_generator description header source" << std::endl;
+		return 1;
+	}
+
+	std::ifstream description(argv[1]);
+	if (not description.is_open()) {
+		std::cerr << "The model description " << argv[1] << " can not be opened." << std::endl;
+		return 1;
+	}
+	std::vector<Model> models;
+	if (not read(description, models, std::cerr)) {
+		return 1;
+	}
+
+	const std::string description_name(argv[1]);
+	const std::string file_name(description_name.substr(description_name.find_last_of('/') + 1));
+	std::ofstream header(argv[2]), source(argv[3]);
+	if (not header.is_open() or not source.is_open()) {
+		std::cerr << "The generated files can not be written." << std::endl;
+		return 1;
+	}
+
+	header << "#ifndef GENERATED_MODELS_H\n#define GENERATED_MODELS_H\n\n";
+	header << "//written by model_generator from " << file_name << " (the models have to be changed there)\n\n";
+	for (const auto& model : models) {
+		write_declaration(header, model);
+	}
+	header << "///calls X with each generated model.\n#define GENERATED_MODELS(X)";
+	for (const auto& model : models) {
+		header << " X(" << model.name << ')';
+	}
+	header << "\n\n#endif\n";
+
+	source << "#include \"generated_models.h\"\n#include \"kernel_math.h\"\n#include <cmath>\n\n";
+	source << "//written by model_generator from " << file_name << " (the models have to be changed there)\n\n";
+	for (const auto& model : models) {
+		write_definition(source, model);
+	}
+	return 0;
+}
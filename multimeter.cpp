@@ -0,0 +1,57 @@
+#include "multimeter.h"
+#include <cstdint>
+
+//-----------------------------CONSTRUCTOR----------------------------//
+Multimeter::Multimeter(const std::vector<unsigned long>& neurons, unsigned int interval, double dt, AsyncWriter& writer, unsigned long nb_samples_in_buffer)
+: neurons_(neurons), interval_(interval > 0 ? interval : 1), dt_(dt), writer_(writer)
+, row_size_(neurons.size()+1), buffer_(row_size_ * (nb_samples_in_buffer > 0 ? nb_samples_in_buffer : 1)), buffer_size_(0), nb_samples_(0)
+{
+	//header of the file
+	std::vector<std::uint64_t> header;
+	header.push_back(neurons_.size());
+	for (auto neuron : neurons_) {
+		header.push_back(neuron);
+	}
+	writer_.write(header.data(), header.size()*sizeof(std::uint64_t));
+}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long Multimeter::get_nb_samples() const
+{
+	return nb_samples_;
+}
+
+//------------------------------RECORDING-----------------------------//
+void Multimeter::record_spike(unsigned long, unsigned long)
+{}
+
+void Multimeter::end_of_step(const RecordedNetwork& brain, unsigned long T)
+{
+	if (T % interval_ != 0) {
+		return;
+	}
+
+	double* row(&buffer_[buffer_size_]);
+	row[0] = T*dt_;
+	brain.gather_membrane_potentials(neurons_, row+1);
+	buffer_size_ += row_size_;
+	++nb_samples_;
+
+	if (buffer_size_ == buffer_.size()) {
+		flush();
+	}
+}
+
+void Multimeter::flush()
+{
+	if (buffer_size_ > 0) {
+		writer_.write(buffer_.data(), buffer_size_*sizeof(double));
+		buffer_size_ = 0;
+	}
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+Multimeter::~Multimeter()
+{
+	flush();
+}
@@ -0,0 +1,60 @@
+#ifndef MULTIMETER_H
+#define MULTIMETER_H
+#include <vector>
+#include "async_writer.h"
+#include "recorder.h"
+
+///records the membrane potential of some neurons every interval steps.
+/**
+  The file written begins with the number of neurons recorded and their indexes (unsigned 64 bits integers),
+  then each sample is a row of doubles: the time in ms followed by the membrane potential (mV) of each recorded neuron.
+*/
+class Multimeter : public Recorder {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param neurons contains the indexes of the neurons recorded.
+      \param interval is the number of steps between two samples.
+      \param dt is the time step in ms.
+      \param writer is the writer used to save the samples.
+      \param nb_samples_in_buffer is the number of samples kept in memory before they are given to the writer.
+    */
+	Multimeter(const std::vector<unsigned long>& neurons, unsigned int interval, double dt, AsyncWriter& writer, unsigned long nb_samples_in_buffer = 1024);
+
+		//getters
+	///getter for the number of samples taken.
+	/**
+      \return the number of samples taken since the beginning.
+    */
+	unsigned long get_nb_samples() const;
+
+		//recording
+	///the multimeter doesn't use the spikes.
+	void record_spike(unsigned long neuron_index, unsigned long T) override;
+
+	///takes a sample if T is a multiple of the interval (the buffer is given to the writer when it is full).
+	/**
+      \param brain is the brain which has been updated.
+      \param T is the time of the update (in number of steps).
+    */
+	void end_of_step(const RecordedNetwork& brain, unsigned long T) override;
+
+	///gives the samples in memory to the writer.
+	void flush();
+
+	///DESTRUCTOR (the samples still in memory are given to the writer)
+	~Multimeter();
+
+	private:
+	const std::vector<unsigned long> neurons_; /**< indexes of the neurons recorded */
+	const unsigned int interval_; /**< number of steps between two samples */
+	const double dt_; /**< time step */
+	AsyncWriter& writer_; /**< writer used to save the samples */
+
+	const unsigned long row_size_; /**< number of doubles in a sample (time and membrane potentials) */
+	std::vector<double> buffer_; /**< samples in memory, allocated once with room for nb_samples_in_buffer samples */
+	unsigned long buffer_size_; /**< number of doubles used in the buffer */
+	unsigned long nb_samples_; /**< number of samples taken since the beginning */
+};
+
+#endif
@@ -1,15 +1,13 @@
 #include "neuron.h"
+#include "binary_io.h"
 #include <cmath>
 
 //-----------------------------CONSTRUCTOR----------------------------//
-Neuron::Neuron(bool excitatory, double dt, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double JE, double JI, double J, double TAU, double R, double Iext)
-: dt_(dt), Delay_Steps_(Delay_Steps), Refractory_Time_Steps_(Refractory_Time_Steps)
-, Vthr_(Vthr), Vreset_(Vreset)
-, JE_(JE), JI_(JI), J_(J)
-, TAU_(TAU), R_(R)
-, excitatory_(excitatory), membrane_potential_(0.0), refractory_(false), Iext_(Iext)
+Neuron::Neuron(std::shared_ptr<const NeuronParameters> parameters, unsigned int Delay_Steps, double Iext)
+: parameters_(parameters)
+, membrane_potential_(0.0), refractory_(false), Iext_(Iext)
 , time_(0)
-, nb_of_spikes_(0)
+, nb_of_spikes_(0), last_spike_time_(0)
 , size_of_buffer_(Delay_Steps+1), current_index_(0)
 {
 	for (unsigned int i(0); i<size_of_buffer_+1 ; ++i) {
@@ -28,6 +26,11 @@ int Neuron::get_nb_of_spikes() const
 	return nb_of_spikes_;
 }
 
+unsigned long Neuron::get_last_spike_time() const
+{
+	return last_spike_time_;
+}
+
 unsigned int Neuron::get_nb_of_signals(unsigned int buffer_index) const
 {
 	return signals_buffer_[buffer_index];
@@ -40,7 +43,7 @@ void Neuron::set_Iext(double Iext)
 }
 
 //--------------------------------UPDATE------------------------------//
-bool Neuron::update(unsigned long T, unsigned int random_input)
+bool Neuron::update(unsigned long T, double random_input)
 {
 	unsigned int t(T-time_);
 	
@@ -53,7 +56,7 @@ bool Neuron::update(unsigned long T, unsigned int random_input)
 	bool spike(false);
 	
 	//a spike appears
-	if (membrane_potential_ > Vthr_) {
+	if (membrane_potential_ > parameters_->Vthr) {
 		spike_update(T);
 		spike = true;
 	}
@@ -70,10 +73,10 @@ bool Neuron::add_signals()
 	
 	if (not refractory_) {
 		//modifying the membrane potential, counting the signals received
-		membrane_potential_ += signals_buffer_[current_index_]*J_;
+		membrane_potential_ += signals_buffer_[current_index_]*parameters_->J;
 		
 		//checking new spikes
-		if (membrane_potential_ > Vthr_) {
+		if (membrane_potential_ > parameters_->Vthr) {
 			spike_update(time_);
 			spike = true;
 		}
@@ -115,14 +118,15 @@ void Neuron::signals_update(unsigned int t)
 	}
 }
 
-void Neuron::membrane_update(unsigned int t, unsigned int random_input)
+void Neuron::membrane_update(unsigned int t, double random_input)
 {
+	const double J(parameters_->J);
 	if (not refractory_) {
-		membrane_potential_ = equation(t) + J_*signals_buffer_[current_index_] + J_*random_input;
+		membrane_potential_ = equation(t) + J*signals_buffer_[current_index_] + J*random_input;
 	} else {
-		if ((t+time_ - spike_times_.back()) >= Refractory_Time_Steps_) {
+		if ((t+time_ - last_spike_time_) >= parameters_->Refractory_Time_Steps) {
 			refractory_ = false;
-			membrane_potential_ = equation(t) + J_*signals_buffer_[current_index_] + J_*random_input;
+			membrane_potential_ = equation(t) + J*signals_buffer_[current_index_] + J*random_input;
 		}
 	}
 	signals_buffer_[current_index_] = 0;
@@ -131,46 +135,85 @@ void Neuron::membrane_update(unsigned int t, unsigned int random_input)
 void Neuron::spike_update(unsigned long T)
 {
 	nb_of_spikes_ += 1;
-	spike_times_.push_back(T);
+	last_spike_time_ = T;
 	refractory_ = true;
-	membrane_potential_ = Vreset_;
+	membrane_potential_ = parameters_->Vreset;
 }
 
 //--------------------------OTHER-METHODS-----------------------------//
 
-void Neuron::receive_signal(unsigned long T, bool excitatory)
+void Neuron::receive_signal(unsigned long T, double weight, unsigned int Delay_Steps)
 {
-	unsigned int delay(Delay_Steps_ + T-time_);
+	unsigned int delay(Delay_Steps + T-time_);
 	
 		//we're still in the array
 	if (current_index_+delay<size_of_buffer_) {
-		if (excitatory) {
-			signals_buffer_[current_index_+delay] += JE_;
-		} else {
-			signals_buffer_[current_index_+delay] += JI_;
-		}
+		signals_buffer_[current_index_+delay] += weight;
 		
 		//we're out of the array
 	} else {
-		if (excitatory) {
-			signals_buffer_[current_index_+delay-size_of_buffer_] += JE_;
-		} else {
-			signals_buffer_[current_index_+delay-size_of_buffer_] += JI_;
-		}
+		signals_buffer_[current_index_+delay-size_of_buffer_] += weight;
 	}
 }
 
 double Neuron::equation(unsigned int t) const
 {
-	double exponential(exp(-(t*dt_)/TAU_));
-	return exponential * membrane_potential_ + Iext_*R_*(1-exponential);
+	double exponential(exp(-(t*parameters_->dt)/parameters_->TAU));
+	return exponential * membrane_potential_ + Iext_*parameters_->R*(1-exponential);
+}
+
+void Neuron::save(std::ostream& out) const
+{
+	write_binary(out, membrane_potential_);
+	write_binary(out, refractory_);
+	write_binary(out, Iext_);
+	write_binary(out, time_);
+	write_binary(out, nb_of_spikes_);
+	write_binary(out, last_spike_time_);
+	write_binary(out, current_index_);
+	write_binary_vector(out, signals_buffer_);
+}
+
+bool Neuron::load(std::istream& in)
+{
+	std::vector<double> signals_buffer;
+	bool good(read_binary(in, membrane_potential_)
+		and read_binary(in, refractory_)
+		and read_binary(in, Iext_)
+		and read_binary(in, time_)
+		and read_binary(in, nb_of_spikes_)
+		and read_binary(in, last_spike_time_)
+		and read_binary(in, current_index_)
+		and read_binary_vector(in, signals_buffer, signals_buffer_.size()));
+	
+	//the delay (size of the buffer) has to be the same
+	if (not good or signals_buffer.size() != signals_buffer_.size() or current_index_ >= size_of_buffer_) {
+		return false;
+	}
+	signals_buffer_.swap(signals_buffer);
+	return true;
+}
+
+bool Neuron::copy_state(const Neuron& other)
+{
+	if (other.size_of_buffer_ != size_of_buffer_) {
+		return false;
+	}
+	membrane_potential_ = other.membrane_potential_;
+	refractory_ = other.refractory_;
+	time_ = other.time_;
+	nb_of_spikes_ = 0;
+	last_spike_time_ = other.last_spike_time_;
+	current_index_ = other.current_index_;
+	signals_buffer_ = other.signals_buffer_;
+	return true;
 }
 
 void Neuron::printSpikes() const
 {
-	std::cout << nb_of_spikes_ << " spikes : ";
-	for (unsigned int i(0); i < nb_of_spikes_ ; ++i) {
-		std::cout << spike_times_[i] * dt_ << '\t';
+	std::cout << nb_of_spikes_ << " spikes";
+	if (nb_of_spikes_ > 0) {
+		std::cout << ", last one at " << last_spike_time_ * parameters_->dt;
 	}
 	std::cout << std::endl;
 }
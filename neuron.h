@@ -1,26 +1,29 @@
 #ifndef NEURON_H
 #define NEURON_H
 #include <iostream>
+#include <memory>
 #include <vector>
 
+///the parameters shared by the neurons of a population (see population.h).
+struct NeuronParameters {
+	double dt = 0.1; /**< time step for each update (ms) */
+	unsigned int Refractory_Time_Steps = 20; /**< refractrory time (the neurons don't have any activity during this time after spiking) in number of time steps */
+	double Vthr = 20.0; /**< potential (mV) to exceed for a spike to appear */
+	double Vreset = 0.0; /**< refractory potential (mV) */
+	double J = 0.1; /**< "potential step" transmitted between neurons (mV) */
+	double TAU = 20.0; /**< membrane time constant (ms) */
+	double R = 20.0; /**< membrane resistance */
+};
+
 class Neuron {
 	public:
 	///CONSTRUCTOR
 	/**
-      \param excitatory is a boolean which says if the neuron is excitatory or not.
-      \param dt is the time step for each update in ms.
-      \param Delay_Steps is the delay to receive a signal in number of time steps.
-      \param Refractory_Time_Steps is the refractrory time for the neurons (they don't have any activity during this time after spiking) in number of time steps.
-      \param Vthr is the potential (mV) to exceed for a spike to appear.
-      \param Vreset is the initial and refractory potential (mV).
-      \param JE is the potential transmited when an excitatory neuron has a spike in number of J.
-      \param JI is the potential transmited when an inhibitory neuron has a spike in number of J.
-      \param J is the "potential step" transmitted between neurons in mV.
-      \param TAU is the membrane time constant (ms).
-      \param R is the neuron membrane resistance.
+      \param parameters are the parameters of the neuron, shared with the other neurons of its population.
+      \param Delay_Steps is the longest delay of the signals received in number of time steps (the size of the signals buffer).
       \param Iext is the external current received by the neuron.
     */
-	Neuron(bool excitatory, double dt = 0.1, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double Vthr = 20.0, double Vreset = 0.0, double JE = 1.0, double JI = -5.0, double J = 0.1, double TAU = 20, double R = 20.0, double Iext = 0);
+	Neuron(std::shared_ptr<const NeuronParameters> parameters, unsigned int Delay_Steps = 15, double Iext = 0);
 	
 		//getters
 	///getter for the membrane potential.
@@ -35,6 +38,12 @@ class Neuron {
     */
 	int get_nb_of_spikes() const;
 	
+	///getter for the time of the last spike.
+	/**
+      \return the time (in number of steps) of the last spike, 0 if the neuron never spiked.
+    */
+	unsigned long get_last_spike_time() const;
+	
 	///getter for the number of signals at a certain index in the signals_buffer.
 	/**
 	  \param buffer_index is the index of the signals_buffer where we will look for the number of signals received.
@@ -53,10 +62,10 @@ class Neuron {
 	///updates the neuron with time T, calculate a new membrane potential and see if there is a spike.
 	/**
       \param T is the new time (in numer of steps).
-      \param random_input is a random number of excitatory signals received from "outside" the brain.
+      \param random_input is the input received from "outside" the brain in number of J (a random number of excitatory signals, or a continuous value with the Gaussian background noise).
       \return a boolean which says if the neurons has spikes during the update.
     */
-	bool update(unsigned long T, unsigned int random_input);
+	bool update(unsigned long T, double random_input);
 	
 	///take the number of signals received for the current time into account to calculate the new membrane potential.
 	/**
@@ -73,9 +82,9 @@ class Neuron {
 	///updates the membrane potential.
 	/**
       \param t is the number of time steps since the last update (usually 1).
-      \param random_input is a random number of excitatory signals received from "outside" the brain.
+      \param random_input is the input received from "outside" the brain in number of J.
     */
-	void membrane_update(unsigned int t, unsigned int random_input);
+	void membrane_update(unsigned int t, double random_input);
 	
 	///upates the neuron as a result of a spike.
 	/**
@@ -84,21 +93,43 @@ class Neuron {
 	void spike_update(unsigned long T);
 	
 		//other methods
-	///add in the appropriate index in the signals_ vector the signal received (JE or JI).
+	///add in the appropriate index in the signals_ vector the signal received.
 	/**
       \param T is the time of the transmitter neuron when it had the spike.
-      \param excitatory is a boolean which says if the transmitter neuron is excitatory or not.
+      \param weight is the signal in number of J (JE or JI in N. Brunel's network).
+      \param Delay_Steps is the delay of the signal in number of time steps (at most the delay given to the constructor).
     */
-	void receive_signal(unsigned long T, bool excitatory);
+	void receive_signal(unsigned long T, double weight, unsigned int Delay_Steps);
 	
-	///calculate the equation : exp(-(t*dt_)/TAU_) * membrane_potential_ + Iext_*R_*(1- exp(-(t*dt_)/TAU_))
+	///calculate the equation : exp(-(t*dt)/TAU) * membrane_potential_ + Iext_*R*(1- exp(-(t*dt)/TAU))
 	/**
 	  \param t is the number of time steps since the last update (usually 1).
 	  \return the result of the calculation.
 	*/
 	double equation(unsigned int t) const;
 	
-	///print the number of spikes.
+	///writes the state of the neuron (membrane potential, refractory state, clock, spikes and signals buffer) in a binary stream.
+	/**
+	  \param out is the stream.
+	*/
+	void save(std::ostream& out) const;
+	
+	///reads the state of the neuron written by save() (the parameters of the neuron are not changed).
+	/**
+	  \param in is the stream.
+	  \return true if the state could be read and is compatible with the parameters of the neuron.
+	*/
+	bool load(std::istream& in);
+	
+	///takes the dynamic state of another neuron (membrane potential, refractory period and signals on the way), to start a simulation from an equilibrated network.
+	/**
+	  The parameters of the neuron are not changed (the signals already received keep the weights of the other neuron) and its number of spikes is counted again from 0.
+	  \param other is the neuron copied.
+	  \return false if the neurons don't have the same longest delay.
+	*/
+	bool copy_state(const Neuron& other);
+	
+	///print the number of spikes and the time of the last one (the full history can be kept by a SpikeRecorder).
 	void printSpikes() const; 
 	
 	///DESTRUCTOR
@@ -106,22 +137,9 @@ class Neuron {
 	
 	private:
 		//Parameters
-	const double dt_; /**< time step */
-	const unsigned int Delay_Steps_; /**< delay to receive a signal in number of time steps */
-	const unsigned int Refractory_Time_Steps_; /**< time (in number of time steps) after a spike during which the neuron won't have any activity */
-	
-	const double Vthr_; /**< potential (mV) to exceed for a spike	to appear */
-	const double Vreset_; /**< initial and refractory potential (mV) */
-	
-	const double JE_; /**< potential transmited when an excitatory neuron has a spike in number of J_ */ 
-	const double JI_; /**< potential transmited when an inhibitory neuron has a spike in number of J_ */ 
-	const double J_; /**< (mV) */
-
-	const double TAU_; /**< constant (ms) */
-	const double R_; /**< resistance of the membrane */
+	std::shared_ptr<const NeuronParameters> parameters_; /**< parameters of the population of the neuron */
 	
 		//Basic attributs
-	const bool excitatory_; /**< a boolean saying if the neuron is excitatory or not */
 	double membrane_potential_; /**< the membrane potential in mV */
 	bool refractory_; /**< a boolean saying if the neuron is currently refractory which means that it doesn't have any activity (membrane potential = 0) */	
 	double Iext_; /**< the external current received by the neuron */
@@ -131,7 +149,7 @@ class Neuron {
 	
 		//Spikes
 	unsigned int nb_of_spikes_; /**< the number of spikes that the neuron had since the begining of the simulation */
-	std::vector<unsigned long> spike_times_; /**< vector containing the times of every spike since the beginning of the simulation */
+	unsigned long last_spike_time_; /**< time (in number of steps) of the last spike, used for the refractory period */
 		
 		//Signals received
 	std::vector<double> signals_buffer_; /**< array containing the number of JE received from other neurons for a specific time step */
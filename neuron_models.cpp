@@ -0,0 +1,159 @@
+#include "neuron_models.h"
+#include "kernel_math.h"
+#include <cmath>
+
+namespace {
+
+///exp(x) as a constant expression (the Taylor series gives the same double as std::exp for the small x of a decay).
+constexpr long double exponential_series(long double x, long double term, unsigned int k)
+{
+	return k > 30 ? 0.0L : term + exponential_series(x, term*x/k, k+1);
+}
+
+constexpr double constant_exponential(double x)
+{
+	return static_cast<double>(exponential_series(x, 1.0L, 1));
+}
+
+///the parameters of a leaky integrate-and-fire neuron of N. Brunel's network, known at compile time.
+struct BrunelLif {
+	static constexpr double dt() { return 0.1; }
+	static constexpr double Vthr() { return 20.0; }
+	static constexpr double Vreset() { return 0.0; }
+	static constexpr double J() { return 0.1; }
+	static constexpr double TAU() { return 20.0; }
+	static constexpr double decay() { return constant_exponential(-(1*dt())/TAU()); }
+};
+
+///the parameters of any leaky integrate-and-fire neuron, read when the kernel runs.
+struct RuntimeLif {
+	double J_;
+	double decay_;
+	double J() const { return J_; }
+	double decay() const { return decay_; }
+};
+
+///the kernel of LifModel::step().
+template<class Parameters>
+void lif_step(const Parameters& parameters, double* __restrict potentials, double* __restrict signals, const double* __restrict random_inputs, const double* __restrict refractory_ends, double time, unsigned long nb_neurons)
+{
+	for (unsigned long i(0) ; i<nb_neurons ; ++i) {
+		//active is 1 if refractory_ends[i] <= time, 0 otherwise
+		const double active(below(refractory_ends[i], time));
+		const double potential(parameters.decay()*potentials[i] + parameters.J()*signals[i] + parameters.J()*random_inputs[i]);
+		potentials[i] = active*potential + (1.0 - active)*potentials[i];
+		signals[i] = 0.0;
+	}
+}
+
+}
+
+//------------------------------LIF-MODEL-----------------------------//
+LifModel::LifModel(double dt, double Vthr, double Vreset, double J, double TAU)
+: dt_(dt), Vthr_(Vthr), Vreset_(Vreset), J_(J), TAU_(TAU), decay_(std::exp(-(1*dt)/TAU))
+, specialized_(dt == BrunelLif::dt() and Vthr == BrunelLif::Vthr() and Vreset == BrunelLif::Vreset() and J == BrunelLif::J() and TAU == BrunelLif::TAU())
+{}
+
+double LifModel::get_dt() const
+{
+	return dt_;
+}
+
+bool LifModel::is_specialized() const
+{
+	return specialized_;
+}
+
+void LifModel::step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const
+{
+	if (specialized_) {
+		lif_step(BrunelLif(), state, signals, random_inputs, refractory_ends, time, nb_neurons);
+	} else {
+		lif_step(RuntimeLif{J_, decay_}, state, signals, random_inputs, refractory_ends, time, nb_neurons);
+	}
+}
+
+double LifModel::get_threshold() const
+{
+	return Vthr_;
+}
+
+void LifModel::reset(double* state, unsigned long, unsigned long neuron_index) const
+{
+	state[neuron_index] = Vreset_;
+}
+
+//--------------------------EXPONENTIAL-MODEL-------------------------//
+ExponentialModel::ExponentialModel(double dt, double VT, double Delta_T, double Vpeak, double Vreset, double J, double TAU)
+: dt_(dt), VT_(VT), Delta_T_(Delta_T), Vpeak_(Vpeak), Vreset_(Vreset), J_(J), TAU_(TAU)
+{}
+
+double ExponentialModel::get_dt() const
+{
+	return dt_;
+}
+
+void ExponentialModel::step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const
+{
+	double* __restrict potentials(state);
+	double* __restrict inputs(signals);
+	const double* __restrict noise(random_inputs);
+	const double* __restrict ends(refractory_ends);
+	const double rate(dt_/TAU_);
+	for (unsigned long i(0) ; i<nb_neurons ; ++i) {
+		const double active(below(ends[i], time));
+		const double V(potentials[i]);
+		const double potential(V + rate*(-V + Delta_T_*exponential((V - VT_)/Delta_T_)) + J_*inputs[i] + J_*noise[i]);
+		potentials[i] = active*potential + (1.0 - active)*V;
+		inputs[i] = 0.0;
+	}
+}
+
+double ExponentialModel::get_threshold() const
+{
+	return Vpeak_;
+}
+
+void ExponentialModel::reset(double* state, unsigned long, unsigned long neuron_index) const
+{
+	state[neuron_index] = Vreset_;
+}
+
+//--------------------ADAPTIVE-EXPONENTIAL-MODEL----------------------//
+AdaptiveExponentialModel::AdaptiveExponentialModel(double dt, double VT, double Delta_T, double Vpeak, double Vreset, double J, double TAU, double a, double b, double TAU_w)
+: dt_(dt), VT_(VT), Delta_T_(Delta_T), Vpeak_(Vpeak), Vreset_(Vreset), J_(J), TAU_(TAU), a_(a), b_(b), TAU_w_(TAU_w)
+{}
+
+double AdaptiveExponentialModel::get_dt() const
+{
+	return dt_;
+}
+
+void AdaptiveExponentialModel::step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const
+{
+	double* __restrict potentials(state);
+	double* __restrict adaptations(state + nb_neurons);
+	double* __restrict inputs(signals);
+	const double* __restrict noise(random_inputs);
+	const double* __restrict ends(refractory_ends);
+	const double rate(dt_/TAU_), adaptation_rate(dt_/TAU_w_);
+	for (unsigned long i(0) ; i<nb_neurons ; ++i) {
+		const double active(below(ends[i], time));
+		const double V(potentials[i]), w(adaptations[i]);
+		const double potential(V + rate*(-V + Delta_T_*exponential((V - VT_)/Delta_T_) - w) + J_*inputs[i] + J_*noise[i]);
+		potentials[i] = active*potential + (1.0 - active)*V;
+		inputs[i] = 0.0;
+		adaptations[i] = w + adaptation_rate*(a_*V - w);
+	}
+}
+
+double AdaptiveExponentialModel::get_threshold() const
+{
+	return Vpeak_;
+}
+
+void AdaptiveExponentialModel::reset(double* state, unsigned long nb_neurons, unsigned long neuron_index) const
+{
+	state[neuron_index] = Vreset_;
+	state[nb_neurons + neuron_index] += b_;
+}
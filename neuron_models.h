@@ -0,0 +1,163 @@
+#ifndef NEURON_MODELS_H
+#define NEURON_MODELS_H
+
+/**
+  The models of neurons simulated by a FastBrain (the brain is a template on its model, so there is no virtual call).
+  A model gives:
+   - nb_variables, the number of state variables of a neuron. The state of the brain is nb_variables arrays of
+     nb_neurons values (variable k of neuron i is state[k*nb_neurons + i]); the variable 0 is the membrane
+     potential (mV), and every variable starts at 0 (the rest).
+   - get_dt(), the time step (ms).
+   - step(), which computes one step of every neuron in one loop (which the compiler vectorizes). The refractory
+     neurons keep their membrane potential and lose their inputs; the inputs are in number of J and change the
+     membrane potential at once (J*input mV).
+   - get_threshold(), the membrane potential to exceed for a spike (compared by the brain after each step), and
+     reset(), the reset of one neuron after a spike.
+*/
+
+///the leaky integrate-and-fire neuron of N. Brunel (the same equation as a Neuron, without Iext).
+/**
+  With the parameters of N. Brunel's network (dt = 0.1 ms, Vthr = 20 mV, Vreset = 0 mV, J = 0.1 mV, TAU = 20 ms),
+  the kernel which has them as constants (the decay exp(-dt/TAU) too) is used. Both give exactly the same results
+  as a Brain.
+*/
+class LifModel {
+	public:
+	static const unsigned int nb_variables = 1; /**< the membrane potential */
+
+	///CONSTRUCTOR
+	/**
+      \param dt is the time step for each update in ms.
+      \param Vthr is the potential (mV) to exceed for a spike to appear.
+      \param Vreset is the refractory potential (mV).
+      \param J is the "potential step" transmitted between neurons in mV.
+      \param TAU is the membrane time constant (ms).
+    */
+	LifModel(double dt = 0.1, double Vthr = 20.0, double Vreset = 0.0, double J = 0.1, double TAU = 20);
+
+	///getter for the time step (ms).
+	double get_dt() const;
+
+	///says if the kernel with the parameters known at compile time is used.
+	bool is_specialized() const;
+
+	///computes one step of the neurons.
+	/**
+      \param state contains the variables of the neurons (nb_variables arrays of nb_neurons values).
+      \param signals contains the inputs received from the other neurons (number of J), they are cleared.
+      \param random_inputs contains the background inputs (number of J).
+      \param refractory_ends contains the first step at which each neuron is not refractory any more.
+      \param time is the new time (in number of steps).
+      \param nb_neurons is the number of neurons.
+    */
+	void step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const;
+
+	///getter for the membrane potential to exceed for a spike to appear (mV).
+	double get_threshold() const;
+
+	///resets a neuron after a spike.
+	void reset(double* state, unsigned long nb_neurons, unsigned long neuron_index) const;
+
+	private:
+	const double dt_; /**< time step (ms) */
+	const double Vthr_; /**< potential to exceed for a spike to appear (mV) */
+	const double Vreset_; /**< potential after a spike (mV) */
+	const double J_; /**< "potential step" transmitted between neurons (mV) */
+	const double TAU_; /**< membrane time constant (ms) */
+	const double decay_; /**< exp(-dt/TAU) */
+	const bool specialized_; /**< says if the parameters are the ones of N. Brunel's network */
+};
+
+///the exponential integrate-and-fire neuron: TAU*dV/dt = -V + Delta_T*exp((V - VT)/Delta_T).
+/**
+  The spike is initiated by the exponential term when V is close to VT and happens when V exceeds Vpeak.
+  The equation is integrated with the Euler method, the exponential is a polynomial (exact to about 1e-8).
+*/
+class ExponentialModel {
+	public:
+	static const unsigned int nb_variables = 1; /**< the membrane potential */
+
+	///CONSTRUCTOR
+	/**
+      \param dt is the time step for each update in ms.
+      \param VT is the potential (mV) at which the exponential term starts the spike.
+      \param Delta_T is the sharpness of the spike initiation (mV).
+      \param Vpeak is the potential (mV) to exceed for a spike to be counted.
+      \param Vreset is the refractory potential (mV).
+      \param J is the "potential step" transmitted between neurons in mV.
+      \param TAU is the membrane time constant (ms).
+    */
+	ExponentialModel(double dt = 0.1, double VT = 18.0, double Delta_T = 1.0, double Vpeak = 30.0, double Vreset = 0.0, double J = 0.1, double TAU = 20);
+
+	///getter for the time step (ms).
+	double get_dt() const;
+
+	///computes one step of the neurons (see LifModel::step()).
+	void step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const;
+
+	///getter for the membrane potential to exceed for a spike to appear (mV).
+	double get_threshold() const;
+
+	///resets a neuron after a spike.
+	void reset(double* state, unsigned long nb_neurons, unsigned long neuron_index) const;
+
+	private:
+	const double dt_; /**< time step (ms) */
+	const double VT_; /**< potential at which the spike starts (mV) */
+	const double Delta_T_; /**< sharpness of the spike initiation (mV) */
+	const double Vpeak_; /**< potential to exceed for a spike to be counted (mV) */
+	const double Vreset_; /**< potential after a spike (mV) */
+	const double J_; /**< "potential step" transmitted between neurons (mV) */
+	const double TAU_; /**< membrane time constant (ms) */
+};
+
+///the adaptive exponential integrate-and-fire neuron (AdEx): an exponential neuron with an adaptation current w (in mV).
+/**
+  TAU*dV/dt = -V + Delta_T*exp((V - VT)/Delta_T) - w and TAU_w*dw/dt = a*V - w, w increases by b after each spike.
+  The variable 1 is w, which is not clamped during the refractory period. With a = b = 0 it is an exponential neuron.
+*/
+class AdaptiveExponentialModel {
+	public:
+	static const unsigned int nb_variables = 2; /**< the membrane potential and the adaptation */
+
+	///CONSTRUCTOR
+	/**
+      \param dt is the time step for each update in ms.
+      \param VT is the potential (mV) at which the exponential term starts the spike.
+      \param Delta_T is the sharpness of the spike initiation (mV).
+      \param Vpeak is the potential (mV) to exceed for a spike to be counted.
+      \param Vreset is the refractory potential (mV).
+      \param J is the "potential step" transmitted between neurons in mV.
+      \param TAU is the membrane time constant (ms).
+      \param a is the subthreshold adaptation (no unit).
+      \param b is the increase of the adaptation after a spike (mV).
+      \param TAU_w is the time constant of the adaptation (ms).
+    */
+	AdaptiveExponentialModel(double dt = 0.1, double VT = 18.0, double Delta_T = 1.0, double Vpeak = 30.0, double Vreset = 0.0, double J = 0.1, double TAU = 20, double a = 0.0, double b = 1.0, double TAU_w = 100.0);
+
+	///getter for the time step (ms).
+	double get_dt() const;
+
+	///computes one step of the neurons (see LifModel::step()).
+	void step(double* state, double* signals, const double* random_inputs, const double* refractory_ends, double time, unsigned long nb_neurons) const;
+
+	///getter for the membrane potential to exceed for a spike to appear (mV).
+	double get_threshold() const;
+
+	///resets a neuron after a spike (and increases its adaptation).
+	void reset(double* state, unsigned long nb_neurons, unsigned long neuron_index) const;
+
+	private:
+	const double dt_; /**< time step (ms) */
+	const double VT_; /**< potential at which the spike starts (mV) */
+	const double Delta_T_; /**< sharpness of the spike initiation (mV) */
+	const double Vpeak_; /**< potential to exceed for a spike to be counted (mV) */
+	const double Vreset_; /**< potential after a spike (mV) */
+	const double J_; /**< "potential step" transmitted between neurons (mV) */
+	const double TAU_; /**< membrane time constant (ms) */
+	const double a_; /**< subthreshold adaptation */
+	const double b_; /**< increase of the adaptation after a spike (mV) */
+	const double TAU_w_; /**< time constant of the adaptation (ms) */
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+#include <memory>
+#include "neuron.h"
+
+///a group of neurons with the same parameters (the neurons of the populations of a brain have contiguous indexes, in the order of the populations).
+struct Population {
+	unsigned long size; /**< number of neurons */
+	std::shared_ptr<const NeuronParameters> parameters; /**< parameters of the neurons (one block for the whole population, which can be shared with other populations) */
+};
+
+///the weight and the delay of the connections from the neurons of a population to the neurons of another one (the connections themselves are in the Connectivity).
+struct Projection {
+	unsigned int source; /**< index of the population of the transmitter neurons */
+	unsigned int target; /**< index of the population of the receiver neurons */
+	double weight; /**< potential transmited by a spike in number of J */
+	unsigned int Delay_Steps; /**< delay to receive a signal in number of time steps */
+};
+
+#endif
@@ -0,0 +1,221 @@
+#include "population_analyzer.h"
+#include <cmath>
+#include <complex>
+#include <fstream>
+
+namespace {
+
+const double PI(3.14159265358979323846);
+
+///in place iterative radix-2 FFT (the size of the vector has to be a power of 2).
+void fft(std::vector<std::complex<double>>& data)
+{
+	const unsigned long n(data.size());
+
+	//bit reversal permutation
+	for (unsigned long i(1), j(0) ; i<n ; ++i) {
+		unsigned long bit(n >> 1);
+		for ( ; j & bit ; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			std::swap(data[i], data[j]);
+		}
+	}
+
+	//butterflies
+	for (unsigned long length(2) ; length<=n ; length <<= 1) {
+		const std::complex<double> root(std::polar(1.0, -2*PI/length));
+		for (unsigned long start(0) ; start<n ; start += length) {
+			std::complex<double> w(1.0);
+			for (unsigned long k(0) ; k<length/2 ; ++k) {
+				const std::complex<double> even(data[start+k]);
+				const std::complex<double> odd(data[start+k+length/2] * w);
+				data[start+k] = even + odd;
+				data[start+k+length/2] = even - odd;
+				w *= root;
+			}
+		}
+	}
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+PopulationAnalyzer::PopulationAnalyzer(unsigned long NE, unsigned long NI, double dt, unsigned int bin_steps, unsigned int block_size)
+: NE_(NE), NI_(NI), dt_(dt), bin_steps_(bin_steps > 0 ? bin_steps : 1)
+, block_size_(block_size < 2 ? 2 : 1u << static_cast<unsigned int>(std::ceil(std::log2(block_size))))
+, bin_counts_{0.0, 0.0}, steps_in_bin_(0), total_counts_{0.0, 0.0}, nb_bins_(0)
+, window_(block_size_), nb_blocks_(0)
+{
+	for (unsigned int p(0) ; p<2 ; ++p) {
+		block_[p].reserve(block_size_);
+		power_[p].assign(block_size_/2+1, 0.0);
+	}
+	for (unsigned int k(0) ; k<block_size_ ; ++k) {
+		window_[k] = 0.5 - 0.5*std::cos(2*PI*k/block_size_);
+	}
+}
+
+//-------------------------------GETTERS------------------------------//
+double PopulationAnalyzer::get_mean_rate(bool excitatory) const
+{
+	const unsigned long nb_neurons(excitatory ? NE_ : NI_);
+	if (nb_neurons == 0 or nb_bins_ == 0) {
+		return 0.0;
+	}
+	//dt_ is in ms
+	return total_counts_[excitatory] / (nb_neurons * nb_bins_*bin_steps_*dt_*1e-3);
+}
+
+unsigned long PopulationAnalyzer::get_nb_blocks() const
+{
+	return nb_blocks_;
+}
+
+std::vector<double> PopulationAnalyzer::get_frequencies() const
+{
+	const double bin_length(bin_steps_*dt_*1e-3);
+	std::vector<double> frequencies(block_size_/2+1);
+	for (unsigned int k(0) ; k<frequencies.size() ; ++k) {
+		frequencies[k] = k / (block_size_*bin_length);
+	}
+	return frequencies;
+}
+
+std::vector<double> PopulationAnalyzer::get_power_spectrum(bool excitatory) const
+{
+	std::vector<double> spectrum(power_[excitatory]);
+	if (nb_blocks_ > 0) {
+		for (auto& power : spectrum) {
+			power /= nb_blocks_;
+		}
+	}
+	return spectrum;
+}
+
+double PopulationAnalyzer::get_peak_frequency(bool excitatory) const
+{
+	if (nb_blocks_ == 0) {
+		return 0.0;
+	}
+	unsigned int peak(1);
+	for (unsigned int k(2) ; k<power_[excitatory].size() ; ++k) {
+		if (power_[excitatory][k] > power_[excitatory][peak]) {
+			peak = k;
+		}
+	}
+	return get_frequencies()[peak];
+}
+
+double PopulationAnalyzer::get_peak_ratio(bool excitatory) const
+{
+	double maximum(0.0);
+	double sum(0.0);
+	for (unsigned int k(1) ; k<power_[excitatory].size() ; ++k) {
+		maximum = std::max(maximum, power_[excitatory][k]);
+		sum += power_[excitatory][k];
+	}
+	if (sum <= 0.0) {
+		return 0.0;
+	}
+	return maximum * (power_[excitatory].size()-1) / sum;
+}
+
+//------------------------------RECORDING-----------------------------//
+void PopulationAnalyzer::record_spike(unsigned long neuron_index, unsigned long)
+{
+	bin_counts_[neuron_index < NE_] += 1.0;
+}
+
+void PopulationAnalyzer::record_population_activity(double nb_excitatory, double nb_inhibitory, unsigned long)
+{
+	bin_counts_[1] += nb_excitatory;
+	bin_counts_[0] += nb_inhibitory;
+}
+
+void PopulationAnalyzer::end_of_step(const RecordedNetwork&, unsigned long)
+{
+	++steps_in_bin_;
+	if (steps_in_bin_ == bin_steps_) {
+		add_bin(bin_counts_[1], bin_counts_[0]);
+		bin_counts_[0] = 0.0;
+		bin_counts_[1] = 0.0;
+		steps_in_bin_ = 0;
+	}
+}
+
+void PopulationAnalyzer::add_bin(double nb_excitatory, double nb_inhibitory)
+{
+	const double bin_length(bin_steps_*dt_*1e-3);
+	const double counts[2] = {nb_inhibitory, nb_excitatory};
+	const unsigned long nb_neurons[2] = {NI_, NE_};
+
+	for (unsigned int p(0) ; p<2 ; ++p) {
+		total_counts_[p] += counts[p];
+		block_[p].push_back(nb_neurons[p] > 0 ? counts[p] / (nb_neurons[p]*bin_length) : 0.0);
+	}
+	++nb_bins_;
+
+	if (block_[0].size() == block_size_) {
+		analyze_block();
+	}
+}
+
+void PopulationAnalyzer::analyze_block()
+{
+	const double bin_length(bin_steps_*dt_*1e-3);
+	double window_power(0.0);
+	for (auto w : window_) {
+		window_power += w*w;
+	}
+
+	std::vector<std::complex<double>> data(block_size_);
+	for (unsigned int p(0) ; p<2 ; ++p) {
+		//the mean of the block is removed so that the 0 Hz component doesn't leak into the low frequencies
+		double mean(0.0);
+		for (auto rate : block_[p]) {
+			mean += rate;
+		}
+		mean /= block_size_;
+
+		for (unsigned int k(0) ; k<block_size_ ; ++k) {
+			data[k] = (block_[p][k] - mean) * window_[k];
+		}
+		fft(data);
+
+		//one-sided power spectral density
+		for (unsigned int k(0) ; k<power_[p].size() ; ++k) {
+			double power(std::norm(data[k]) * bin_length / window_power);
+			if (k > 0 and k < block_size_/2) {
+				power *= 2;
+			}
+			power_[p][k] += power;
+		}
+		block_[p].clear();
+	}
+	++nb_blocks_;
+}
+
+bool PopulationAnalyzer::save(const std::string& file_name) const
+{
+	std::ofstream file(file_name);
+	if (not file.is_open()) {
+		return false;
+	}
+
+	file << "# excitatory: rate = " << get_mean_rate(true) << " Hz, peak = " << get_peak_frequency(true) << " Hz, peak ratio = " << get_peak_ratio(true) << '\n';
+	file << "# inhibitory: rate = " << get_mean_rate(false) << " Hz, peak = " << get_peak_frequency(false) << " Hz, peak ratio = " << get_peak_ratio(false) << '\n';
+	file << "# blocks = " << nb_blocks_ << '\n';
+	file << "# frequency (Hz)\tPSD excitatory\tPSD inhibitory\n";
+
+	const std::vector<double> frequencies(get_frequencies());
+	const std::vector<double> excitatory(get_power_spectrum(true));
+	const std::vector<double> inhibitory(get_power_spectrum(false));
+	for (unsigned int k(0) ; k<frequencies.size() ; ++k) {
+		file << frequencies[k] << '\t' << excitatory[k] << '\t' << inhibitory[k] << '\n';
+	}
+
+	return file.good();
+}
@@ -0,0 +1,111 @@
+#ifndef POPULATION_ANALYZER_H
+#define POPULATION_ANALYZER_H
+#include <string>
+#include <vector>
+#include "recorder.h"
+
+///computes during the simulation the rate and the power spectrum of the excitatory and inhibitory populations.
+/**
+  The spikes are counted in bins of bin_steps steps. Every block of block_size bins, the population rate of the
+  block goes through an FFT (with a Hann window) and its power is added to the spectrum (Welch's method),
+  so only the current block is kept in memory.
+*/
+class PopulationAnalyzer : public Recorder {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param NE is the number of excitatory neurons (indexes from 0 to NE-1).
+      \param NI is the number of inhibitory neurons (indexes from NE to NE+NI-1).
+      \param dt is the time step in ms.
+      \param bin_steps is the length of a bin in number of steps.
+      \param block_size is the number of bins in each FFT block (rounded up to a power of 2).
+    */
+	PopulationAnalyzer(unsigned long NE, unsigned long NI, double dt = 0.1, unsigned int bin_steps = 10, unsigned int block_size = 256);
+
+		//getters
+	///getter for the mean rate of a population.
+	/**
+      \param excitatory says which population is wanted.
+      \return the mean firing rate of one neuron of the population in Hz.
+    */
+	double get_mean_rate(bool excitatory) const;
+
+	///getter for the number of blocks in the spectrum.
+	/**
+      \return the number of FFT blocks averaged in the spectrum.
+    */
+	unsigned long get_nb_blocks() const;
+
+	///getter for the frequencies of the spectrum.
+	/**
+      \return the frequencies (Hz) of the spectrum from 0 to the Nyquist frequency.
+    */
+	std::vector<double> get_frequencies() const;
+
+	///getter for the power spectral density of a population.
+	/**
+      \param excitatory says which population is wanted.
+      \return the power spectral density of the population rate (Hz^2/Hz) averaged over the blocks.
+    */
+	std::vector<double> get_power_spectrum(bool excitatory) const;
+
+	///getter for the frequency where the spectrum has its maximum (the 0 Hz component is ignored).
+	/**
+      \param excitatory says which population is wanted.
+      \return the frequency of the peak in Hz (0 if no block has been analyzed yet).
+    */
+	double get_peak_frequency(bool excitatory) const;
+
+	///getter for the height of the peak compared to the mean of the spectrum (the 0 Hz component is ignored).
+	/**
+      \param excitatory says which population is wanted.
+      \return the ratio between the maximum and the mean of the spectrum (close to 1 for a flat spectrum, large for an oscillation).
+    */
+	double get_peak_ratio(bool excitatory) const;
+
+		//recording
+	///counts the spike in the bin of its population.
+	void record_spike(unsigned long neuron_index, unsigned long T) override;
+
+	///adds the activity of the populations to the current bin.
+	void record_population_activity(double nb_excitatory, double nb_inhibitory, unsigned long T) override;
+
+	///closes the current bin if it is full.
+	void end_of_step(const RecordedNetwork& brain, unsigned long T) override;
+
+	///adds a full bin to the analysis (used by end_of_step, or directly by a model which only knows the population activity).
+	/**
+      \param nb_excitatory is the number of excitatory spikes in the bin.
+      \param nb_inhibitory is the number of inhibitory spikes in the bin.
+    */
+	void add_bin(double nb_excitatory, double nb_inhibitory);
+
+	///writes the mean rates, the peaks and the spectra in a small text file.
+	/**
+      \param file_name is the name of the file.
+      \return true if the file could be written.
+    */
+	bool save(const std::string& file_name) const;
+
+	private:
+	///analyzes the current block and adds its power to the spectra.
+	void analyze_block();
+
+	const unsigned long NE_; /**< number of excitatory neurons */
+	const unsigned long NI_; /**< number of inhibitory neurons */
+	const double dt_; /**< time step */
+	const unsigned int bin_steps_; /**< length of a bin in number of steps */
+	const unsigned int block_size_; /**< number of bins in each FFT block */
+
+	double bin_counts_[2]; /**< number of spikes in the current bin (inhibitory, excitatory) */
+	unsigned int steps_in_bin_; /**< number of steps already in the current bin */
+	double total_counts_[2]; /**< number of spikes since the beginning (inhibitory, excitatory) */
+	unsigned long nb_bins_; /**< number of full bins since the beginning */
+
+	std::vector<double> block_[2]; /**< population rates (Hz) of the bins of the current block (inhibitory, excitatory) */
+	std::vector<double> power_[2]; /**< sum of the power spectra of the blocks (inhibitory, excitatory) */
+	std::vector<double> window_; /**< Hann window */
+	unsigned long nb_blocks_; /**< number of blocks analyzed */
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "population_density.h"
+#include <algorithm>
+#include <cmath>
+
+//-----------------------------CONSTRUCTOR----------------------------//
+PopulationDensity::PopulationDensity(unsigned long NE, unsigned long NI, unsigned long CE, unsigned long CI, double g, double ETA, double dt, unsigned int Delay_Steps, unsigned int Refractory_Time_Steps, double Vthr, double Vreset, double J, double TAU, double Vmin, unsigned int nb_cells)
+: NE_(NE), NI_(NI), CE_(CE), CI_(CI), g_(g), ETA_(ETA), dt_(dt)
+, Delay_Steps_(Delay_Steps > 0 ? Delay_Steps : 1), Refractory_Time_Steps_(Refractory_Time_Steps > 0 ? Refractory_Time_Steps : 1)
+, size_of_history_(std::max(Delay_Steps_, Refractory_Time_Steps_) + 1)
+, Vthr_(Vthr), Vreset_(Vreset), J_(J), TAU_(TAU), Vmin_(std::min(Vmin, Vreset)), nb_cells_(nb_cells > 1 ? nb_cells : 2)
+, h_((Vthr_-Vmin_) / nb_cells_), reset_cell_(std::min(nb_cells_-1, static_cast<unsigned int>((Vreset_-Vmin_) / h_)))
+, time_(0)
+, lower_(nb_cells_), diagonal_(nb_cells_), upper_(nb_cells_)
+{
+	for (unsigned int population(0) ; population<2 ; ++population) {
+		//every neuron starts at Vreset, as in a brain
+		densities_[population].assign(nb_cells_, 0.0);
+		densities_[population][reset_cell_] = 1.0 / h_;
+		rates_[population].assign(size_of_history_, 0.0);
+		refractory_[population] = 0.0;
+	}
+}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long PopulationDensity::get_nb_neurons() const
+{
+	return NE_ + NI_;
+}
+
+unsigned long PopulationDensity::get_nb_excitatory() const
+{
+	return NE_;
+}
+
+unsigned long PopulationDensity::get_nb_inhibitory() const
+{
+	return NI_;
+}
+
+unsigned long PopulationDensity::get_clock() const
+{
+	return time_;
+}
+
+double PopulationDensity::get_rate(bool excitatory) const
+{
+	return rates_[excitatory][time_ % size_of_history_] * 1000.0;
+}
+
+const std::vector<double>& PopulationDensity::get_density(bool excitatory) const
+{
+	return densities_[excitatory];
+}
+
+double PopulationDensity::get_refractory_fraction(bool excitatory) const
+{
+	return refractory_[excitatory];
+}
+
+double PopulationDensity::get_mean_potential(bool excitatory) const
+{
+	const std::vector<double>& density(densities_[excitatory]);
+	double mean(refractory_[excitatory] * Vreset_);
+	for (unsigned int k(0) ; k<nb_cells_ ; ++k) {
+		mean += density[k] * h_ * (Vmin_ + (k+0.5)*h_);
+	}
+	return mean;
+}
+
+void PopulationDensity::gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const
+{
+	const double means[2] = {get_mean_potential(false), get_mean_potential(true)};
+	const unsigned long nb_indexes(neuron_indexes.size());
+	for (unsigned long k(0) ; k<nb_indexes ; ++k) {
+		membrane_potentials[k] = means[neuron_indexes[k] < NE_];
+	}
+}
+
+//--------------------------------UPDATE------------------------------//
+void PopulationDensity::attach_recorder(Recorder* recorder)
+{
+	if (recorder != nullptr) {
+		recorders_.push_back(recorder);
+	}
+}
+
+double PopulationDensity::step(unsigned int population, double mu, double sigma2, double reset_rate)
+{
+	//implicit step: p + dt/h*(F(k+1/2) - F(k-1/2)) = p_old + dt*source with F(k+1/2) = a(k)*p(k) + b(k)*p(k+1)
+	const double diffusion(sigma2 / (2.0*TAU_*h_)), ratio(dt_ / h_);
+	double previous_a(0.0), previous_b(0.0);
+	for (unsigned int k(0) ; k+1<nb_cells_ ; ++k) {
+		//upwind drift at the upper side of the cell
+		const double drift((mu - (Vmin_ + (k+1)*h_)) / TAU_);
+		const double a(std::max(drift, 0.0) + diffusion), b(std::min(drift, 0.0) - diffusion);
+		lower_[k] = -ratio*previous_a;
+		diagonal_[k] = 1.0 + ratio*(a - previous_b);
+		upper_[k] = ratio*b;
+		previous_a = a;
+		previous_b = b;
+	}
+
+	//the density is 0 at the threshold (half a cell above the last center) and the flux through it is the rate
+	const unsigned int last(nb_cells_-1);
+	const double threshold_a(std::max((mu - Vthr_) / TAU_, 0.0) + 2.0*diffusion);
+	lower_[last] = -ratio*previous_a;
+	diagonal_[last] = 1.0 + ratio*(threshold_a - previous_b);
+	upper_[last] = 0.0;
+
+	std::vector<double>& density(densities_[population]);
+	density[reset_cell_] += dt_*reset_rate / h_;
+
+	//Thomas algorithm (the matrix is diagonally dominant)
+	for (unsigned int k(1) ; k<nb_cells_ ; ++k) {
+		const double factor(lower_[k] / diagonal_[k-1]);
+		diagonal_[k] -= factor*upper_[k-1];
+		density[k] -= factor*density[k-1];
+	}
+	density[last] /= diagonal_[last];
+	for (unsigned int k(last) ; k-->0 ;) {
+		density[k] = (density[k] - upper_[k]*density[k+1]) / diagonal_[k];
+	}
+
+	const double rate(threshold_a * density[last]);
+	refractory_[population] += dt_*(rate - reset_rate);
+	return rate;
+}
+
+void PopulationDensity::update(unsigned long T, std::ostream& file)
+{
+	//the rates are in spikes per ms, the input is the one of MeanField with the rates of one delay before
+	const double rate_E(T >= Delay_Steps_ ? rates_[1][(T - Delay_Steps_) % size_of_history_] : 0.0);
+	const double rate_I(T >= Delay_Steps_ ? rates_[0][(T - Delay_Steps_) % size_of_history_] : 0.0);
+	const double mu(TAU_*J_*(CE_*rate_E - g_*CI_*rate_I) + ETA_*Vthr_);
+	const double sigma2(TAU_*J_*J_*(CE_*rate_E + g_*g_*CI_*rate_I) + J_*ETA_*Vthr_);
+
+	double nb_spikes[2];
+	for (unsigned int population(0) ; population<2 ; ++population) {
+		const double reset_rate(T >= Refractory_Time_Steps_ ? rates_[population][(T - Refractory_Time_Steps_) % size_of_history_] : 0.0);
+		const double rate(step(population, mu, sigma2, reset_rate));
+		rates_[population][T % size_of_history_] = rate;
+		nb_spikes[population] = rate*dt_ * (population == 1 ? NE_ : NI_);
+	}
+
+	time_ = T;
+	file << T*dt_ << '\t' << get_rate(true) << '\t' << get_rate(false) << '\n';
+
+	for (auto recorder : recorders_) {
+		recorder->record_population_activity(nb_spikes[1], nb_spikes[0], T);
+		recorder->end_of_step(*this, T);
+	}
+}
+
+void PopulationDensity::run(unsigned long Tstop, std::ostream& file)
+{
+	while (time_ < Tstop) {
+		update(time_+1, file);
+	}
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+PopulationDensity::~PopulationDensity()
+{}
@@ -0,0 +1,158 @@
+#ifndef POPULATION_DENSITY_H
+#define POPULATION_DENSITY_H
+#include <iostream>
+#include <vector>
+#include "recorder.h"
+
+///simulates the distribution of the membrane potentials of each population instead of the neurons (Fokker-Planck equation).
+/**
+  In the limit of many weak connections each neuron receives a Gaussian input of mean mu(t) and variance
+  sigma^2(t) given by the rates of the populations one delay before (the same input as in MeanField):
+  mu = TAU*J*(CE*rate_E - g*CI*rate_I) + ETA*Vthr and sigma^2 = TAU*J^2*(CE*rate_E + g^2*CI*rate_I) + J*ETA*Vthr.
+  The density p(V, t) of the membrane potentials of a population then follows
+  dp/dt = -dF/dV with the flux F = (mu - V)/TAU*p - sigma^2/(2*TAU)*dp/dV.
+  The flux through the threshold is the rate of the population, this probability comes back at Vreset
+  after the refractory time. The density is 0 at the threshold and the flux is 0 at the lower bound.
+
+  The equation is discretized with finite volumes (upwind drift) and an implicit step, so any time step is
+  stable and the probability is exactly conserved. One step costs a few operations per cell instead of
+  the update of every neuron and their connections, the delay makes the oscillations of the network appear
+  the same way as in a brain. The finite size noise of the network is not simulated: the rates are the
+  ones of a network with an infinite number of neurons.
+  The recorders are told about the expected number of spikes of each population at each step
+  (Recorder::record_population_activity()), not about individual spikes.
+*/
+class PopulationDensity : public RecordedNetwork {
+	public:
+	///CONSTRUCTOR (the default values are the ones of Simulation)
+	/**
+      \param NE is the number of excitatory neurons.
+      \param NI is the number of inhibitory neurons.
+      \param CE is the number of excitatory connections received by each neuron.
+      \param CI is the number of inhibitory connections received by each neuron.
+      \param g is the positive ratio of JI/JE.
+      \param ETA is the ratio v_ext/v_thr.
+      \param dt is the time step for each update in ms.
+      \param Delay_Steps is the delay for a neuron to transmit a signal in number of time steps (at least 1).
+      \param Refractory_Time_Steps is the refractrory time for the neurons in number of time steps (at least 1).
+      \param Vthr is the potential (mV) to exceed for a spike to appear.
+      \param Vreset is the initial and refractory potential (mV).
+      \param J is the potential (mV) transmitted by an excitatory connection.
+      \param TAU is the membrane time constant (ms).
+      \param Vmin is the lower bound of the potentials (mV), the density has to be negligible there.
+      \param nb_cells is the number of cells between Vmin and Vthr.
+    */
+	PopulationDensity(unsigned long NE = 10000, unsigned long NI = 2500, unsigned long CE = 1000, unsigned long CI = 250, double g = 5.0, double ETA = 2.0, double dt = 0.1, unsigned int Delay_Steps = 15, unsigned int Refractory_Time_Steps = 20, double Vthr = 20.0, double Vreset = 0.0, double J = 0.1, double TAU = 20.0, double Vmin = -40.0, unsigned int nb_cells = 600);
+
+		//getters
+	///getter for the number of neurons.
+	unsigned long get_nb_neurons() const;
+
+	///getter for the number of excitatory neurons.
+	unsigned long get_nb_excitatory() const;
+
+	///getter for the number of inhibitory neurons.
+	unsigned long get_nb_inhibitory() const;
+
+	///getter for the time of the last update (in number of steps).
+	unsigned long get_clock() const;
+
+	///getter for the rate of a population during the last update.
+	/**
+      \param excitatory says if the population is the excitatory one.
+      \return the rate in Hz.
+    */
+	double get_rate(bool excitatory) const;
+
+	///getter for the density of the membrane potentials of a population.
+	/**
+      \param excitatory says if the population is the excitatory one.
+      \return the probability density (1/mV) in each cell, the cell k is centered on Vmin + (k+0.5)*(Vthr-Vmin)/nb_cells.
+    */
+	const std::vector<double>& get_density(bool excitatory) const;
+
+	///getter for the fraction of a population which is refractory.
+	double get_refractory_fraction(bool excitatory) const;
+
+	///getter for the mean membrane potential of a population (the refractory neurons are at Vreset).
+	double get_mean_potential(bool excitatory) const;
+
+	///gives the mean membrane potential of the population of each neuron (the neurons are not simulated).
+	/**
+	  \param neuron_indexes contains the indexes of the neurons wanted (the first NE ones are excitatory).
+	  \param membrane_potentials is the array (of size neuron_indexes.size()) which receives the membrane potentials in mV.
+	*/
+	void gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const override;
+
+		//update
+	///attach a recorder which will be told about the activity of the populations at every update (the model doesn't own it).
+	/**
+	  \param recorder is the recorder to attach.
+	*/
+	void attach_recorder(Recorder* recorder);
+
+	///updates the densities with time T.
+	/**
+      \param T is the new time (in number of steps, the next one after the clock).
+      \param file receives the time and the rates (Hz) of the excitatory and inhibitory populations.
+    */
+	void update(unsigned long T, std::ostream& file);
+
+	///updates the densities until a given time.
+	/**
+      \param Tstop is the time of the last update (in number of steps).
+      \param file receives the time and the rates of each update.
+    */
+	void run(unsigned long Tstop, std::ostream& file);
+
+	///DESTRUCTOR
+	~PopulationDensity();
+
+	private:
+	///makes one implicit step of the density of a population.
+	/**
+      \param population is 1 for the excitatory population, 0 for the inhibitory one.
+      \param mu is the mean input (mV).
+      \param sigma2 is the variance of the input (mV^2).
+      \param reset_rate is the rate (1/ms) of the neurons which come back at Vreset.
+      \return the rate (1/ms) through the threshold.
+    */
+	double step(unsigned int population, double mu, double sigma2, double reset_rate);
+
+		//Parameters
+	const unsigned long NE_; /**< number of excitatory neurons */
+	const unsigned long NI_; /**< number of inhibitory neurons */
+	const double CE_; /**< number of excitatory connections received by each neuron */
+	const double CI_; /**< number of inhibitory connections received by each neuron */
+	const double g_; /**< positive ratio of JI/JE */
+	const double ETA_; /**< ratio v_ext/v_thr */
+	const double dt_; /**< time step (ms) */
+	const unsigned int Delay_Steps_; /**< delay to receive a signal in number of time steps */
+	const unsigned int Refractory_Time_Steps_; /**< refractrory time in number of time steps */
+	const unsigned int size_of_history_; /**< number of rates kept for each population */
+	const double Vthr_; /**< potential to exceed for a spike to appear (mV) */
+	const double Vreset_; /**< potential after a spike (mV) */
+	const double J_; /**< potential transmitted by an excitatory connection (mV) */
+	const double TAU_; /**< membrane time constant (ms) */
+	const double Vmin_; /**< lower bound of the potentials (mV) */
+	const unsigned int nb_cells_; /**< number of cells */
+	const double h_; /**< width of the cells (mV) */
+	const unsigned int reset_cell_; /**< cell which contains Vreset */
+
+		//Time
+	unsigned long time_; /**< clock */
+
+		//State ([0] inhibitory, [1] excitatory)
+	std::vector<double> densities_[2]; /**< probability density in each cell (1/mV) */
+	std::vector<double> rates_[2]; /**< rates (1/ms) of the last steps, indexed by the time */
+	double refractory_[2]; /**< fraction of the population which is refractory */
+
+		//Work arrays of the tridiagonal system
+	std::vector<double> lower_; /**< coefficients of the cell below */
+	std::vector<double> diagonal_; /**< coefficients of the cell */
+	std::vector<double> upper_; /**< coefficients of the cell above */
+
+	std::vector<Recorder*> recorders_; /**< the recorders attached (empty by default) */
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+#include <vector>
+
+///what a recorder can read of a network at the end of an update (a brain, or one trial of an ensemble).
+class RecordedNetwork {
+	public:
+	///copies the membrane potentials of some neurons in an array.
+	/**
+	  \param neuron_indexes contains the indexes of the neurons wanted.
+	  \param membrane_potentials is the array (of size neuron_indexes.size()) which receives the membrane potentials in mV.
+	*/
+	virtual void gather_membrane_potentials(const std::vector<unsigned long>& neuron_indexes, double* membrane_potentials) const = 0;
+
+	///DESTRUCTOR
+	virtual ~RecordedNetwork();
+};
+
+inline RecordedNetwork::~RecordedNetwork()
+{}
+
+class Recorder {
+	public:
+	///called by the brain for every spike.
+	/**
+      \param neuron_index is the index of the neuron which had a spike.
+      \param T is the time of the spike (in number of steps).
+    */
+	virtual void record_spike(unsigned long neuron_index, unsigned long T) = 0;
+
+	///called by the models which only know the activity of the populations (instead of record_spike()).
+	/**
+      \param nb_excitatory is the expected number of excitatory spikes during the step.
+      \param nb_inhibitory is the expected number of inhibitory spikes during the step.
+      \param T is the time of the step (in number of steps).
+    */
+	virtual void record_population_activity(double nb_excitatory, double nb_inhibitory, unsigned long T);
+
+	///called by the brain once every neuron has been updated for the time T.
+	/**
+      \param brain is the network which has been updated.
+      \param T is the time of the update (in number of steps).
+    */
+	virtual void end_of_step(const RecordedNetwork& brain, unsigned long T);
+
+	///DESTRUCTOR
+	virtual ~Recorder();
+};
+
+inline void Recorder::record_population_activity(double, double, unsigned long)
+{}
+
+inline void Recorder::end_of_step(const RecordedNetwork&, unsigned long)
+{}
+
+inline Recorder::~Recorder()
+{}
+
+#endif
@@ -0,0 +1,41 @@
+#include "regime.h"
+
+Regime classify_regime(double rate, double cv, double correlation, double min_rate, double min_cv, double min_correlation)
+{
+	if (rate < min_rate) {
+		return QUIESCENT;
+	}
+	if (cv < min_cv) {
+		return SYNCHRONOUS_REGULAR;
+	}
+	if (correlation > min_correlation) {
+		return SYNCHRONOUS_IRREGULAR;
+	}
+	return ASYNCHRONOUS_IRREGULAR;
+}
+
+std::string regime_name(Regime regime)
+{
+	switch (regime) {
+		case QUIESCENT:
+			return "Q";
+		case SYNCHRONOUS_REGULAR:
+			return "SR";
+		case SYNCHRONOUS_IRREGULAR:
+			return "SI";
+		case ASYNCHRONOUS_IRREGULAR:
+			return "AI";
+	}
+	return "?";
+}
+
+bool regime_from_name(const std::string& name, Regime& regime)
+{
+	for (Regime known : {QUIESCENT, SYNCHRONOUS_REGULAR, SYNCHRONOUS_IRREGULAR, ASYNCHRONOUS_IRREGULAR}) {
+		if (regime_name(known) == name) {
+			regime = known;
+			return true;
+		}
+	}
+	return false;
+}
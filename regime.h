@@ -0,0 +1,40 @@
+#ifndef REGIME_H
+#define REGIME_H
+#include <string>
+
+///the states of the network described by N. Brunel.
+enum Regime {
+	QUIESCENT, /**< (almost) no activity */
+	SYNCHRONOUS_REGULAR, /**< SR: the neurons spike regularly and together */
+	SYNCHRONOUS_IRREGULAR, /**< SI: the neurons spike irregularly but the population activity oscillates */
+	ASYNCHRONOUS_IRREGULAR /**< AI: the neurons spike irregularly and independently */
+};
+
+///classifies the regime of the network from its spike statistics.
+/**
+  \param rate is the mean firing rate in Hz.
+  \param cv is the mean coefficient of variation of the interspike intervals.
+  \param correlation is the mean correlation coefficient between the spike counts of pairs of neurons.
+  \param min_rate is the rate (Hz) under which the network is considered quiescent.
+  \param min_cv is the CV over which the neurons are considered irregular.
+  \param min_correlation is the correlation over which the network is considered synchronous.
+  \return the regime of the network.
+*/
+Regime classify_regime(double rate, double cv, double correlation, double min_rate = 0.1, double min_cv = 0.5, double min_correlation = 0.1);
+
+///gives the usual abbreviation of a regime.
+/**
+  \param regime is the regime.
+  \return "Q", "SR", "SI" or "AI".
+*/
+std::string regime_name(Regime regime);
+
+///gives the regime of an abbreviation.
+/**
+  \param name is "Q", "SR", "SI" or "AI".
+  \param regime receives the regime.
+  \return false if the name is not known.
+*/
+bool regime_from_name(const std::string& name, Regime& regime);
+
+#endif
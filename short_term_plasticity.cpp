@@ -0,0 +1,80 @@
+#include "short_term_plasticity.h"
+#include "binary_io.h"
+#include <cmath>
+
+namespace {
+
+///decay of a variable during a time (0 if the time constant is 0).
+double decay(double time, double TAU)
+{
+	return TAU > 0.0 ? std::exp(-time/TAU) : 0.0;
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+ShortTermPlasticity::ShortTermPlasticity()
+: dt_(0.1), first_transmitter_(0), end_transmitter_(0)
+{}
+
+ShortTermPlasticity::ShortTermPlasticity(unsigned long first_transmitter, unsigned long end_transmitter, double dt, const ShortTermParameters& parameters)
+: parameters_(parameters), dt_(dt), first_transmitter_(first_transmitter), end_transmitter_(end_transmitter)
+, releases_(end_transmitter - first_transmitter, Release({0.0, 1.0, 1.0, 0}))
+{}
+
+//-------------------------------GETTERS------------------------------//
+bool ShortTermPlasticity::is_enabled() const
+{
+	return end_transmitter_ > first_transmitter_;
+}
+
+const ShortTermParameters& ShortTermPlasticity::get_parameters() const
+{
+	return parameters_;
+}
+
+double ShortTermPlasticity::get_efficacy(unsigned long neuron_index) const
+{
+	if (neuron_index < first_transmitter_ or neuron_index >= end_transmitter_) {
+		return 1.0;
+	}
+	return releases_[neuron_index - first_transmitter_].efficacy;
+}
+
+//--------------------------------UPDATE------------------------------//
+double ShortTermPlasticity::spike(unsigned long neuron_index, unsigned long T)
+{
+	if (neuron_index < first_transmitter_ or neuron_index >= end_transmitter_) {
+		return 1.0;
+	}
+	Release& release(releases_[neuron_index - first_transmitter_]);
+	const double time((T - release.last_spike)*dt_);
+
+	//u and x just before the spike (u=0 and x=1 at rest give u=U and x=1)
+	const double decayed_u(release.u*decay(time, parameters_.TAU_facil));
+	const double u(decayed_u + parameters_.U*(1.0 - decayed_u));
+	const double x(1.0 + (release.x - 1.0)*decay(time, parameters_.TAU_rec));
+
+	release = Release({u, x*(1.0 - u), u*x/parameters_.U, T});
+	return release.efficacy;
+}
+
+//--------------------------------FILES-------------------------------//
+void ShortTermPlasticity::save(std::ostream& out) const
+{
+	write_binary_vector(out, releases_);
+}
+
+bool ShortTermPlasticity::load(std::istream& in)
+{
+	std::vector<Release> releases;
+	if (not read_binary_vector(in, releases, releases_.size()) or releases.size() != releases_.size()) {
+		return false;
+	}
+	releases_.swap(releases);
+	return true;
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+ShortTermPlasticity::~ShortTermPlasticity()
+{}
@@ -0,0 +1,92 @@
+#ifndef SHORT_TERM_PLASTICITY_H
+#define SHORT_TERM_PLASTICITY_H
+#include <iostream>
+#include <vector>
+
+///the parameters of the short-term plasticity (see ShortTermPlasticity).
+struct ShortTermParameters {
+	unsigned int source = 0; /**< population of the transmitters of the connections (the excitatory one) */
+	unsigned int target = 0; /**< population of the receivers of the connections */
+	double U = 0.5; /**< fraction of the resources used by a spike when the connections are at rest */
+	double TAU_rec = 800.0; /**< time constant of the recovery of the resources (ms) */
+	double TAU_facil = 0.0; /**< time constant of the facilitation (ms), no facilitation if it is 0 */
+};
+
+///the short-term plasticity (Tsodyks-Markram) of the connections from a range of neurons to a population.
+/**
+  Each transmitter has resources x (1 at rest) of which a spike uses a fraction u: the connections transmit
+  u*x/U times their weight, so they transmit their weight at rest. The resources recover towards 1 with TAU_rec,
+  u decays towards 0 with TAU_facil and increases by U*(1-u) at each spike (u = U without facilitation).
+  The connections of a transmitter to the population all have the same state, so it is kept for the
+  transmitter at its last spike and computed once at its next spike: the work is the same for every spike,
+  whatever the number of its connections.
+*/
+class ShortTermPlasticity {
+	public:
+	///CONSTRUCTOR (no connections with short-term plasticity)
+	ShortTermPlasticity();
+
+	///CONSTRUCTOR
+	/**
+      \param first_transmitter and end_transmitter are the range of the transmitters.
+      \param dt is the time step (ms).
+      \param parameters are the parameters of the plasticity.
+    */
+	ShortTermPlasticity(unsigned long first_transmitter, unsigned long end_transmitter, double dt, const ShortTermParameters& parameters);
+
+		//getters
+	///says if there are connections with short-term plasticity.
+	bool is_enabled() const;
+
+	///getter for the parameters.
+	const ShortTermParameters& get_parameters() const;
+
+	///getter for the efficacy of the last spike of a transmitter.
+	/**
+      \param neuron_index is the index of the neuron.
+      \return u*x/U at its last spike, 1 if it has not spiked or is not a transmitter.
+    */
+	double get_efficacy(unsigned long neuron_index) const;
+
+		//update
+	///updates the state of a transmitter which spikes.
+	/**
+      \param neuron_index is the index of the neuron.
+      \param T is the time of the spike (in number of steps).
+      \return the factor of the weights of its connections to the population (1 if it is not a transmitter).
+    */
+	double spike(unsigned long neuron_index, unsigned long T);
+
+		//files
+	///writes the states of the transmitters in a binary stream.
+	void save(std::ostream& out) const;
+
+	///reads the states written by save().
+	/**
+      \return true if they could be read and have the same number of transmitters.
+    */
+	bool load(std::istream& in);
+
+	///DESTRUCTOR
+	~ShortTermPlasticity();
+
+	private:
+	///the state of a transmitter just after its last spike.
+	struct Release {
+		double u; /**< fraction of the resources used by the last spike (0 at rest) */
+		double x; /**< resources left after the last spike (1 at rest) */
+		double efficacy; /**< u*x/U at the last spike (1 at rest) */
+		unsigned long last_spike; /**< time of the last spike */
+	};
+
+		//Parameters
+	ShortTermParameters parameters_; /**< parameters of the plasticity */
+	double dt_; /**< time step (ms) */
+	unsigned long first_transmitter_; /**< first transmitter */
+	unsigned long end_transmitter_; /**< index after the last transmitter */
+
+		//States
+	std::vector<Release> releases_; /**< state of each transmitter */
+};
+
+#endif
@@ -1,8 +1,20 @@
 #include "simulation.h"
+#include "binary_io.h"
+
+const unsigned long long Simulation::Checkpoint_Magic_;
+const unsigned int Simulation::Checkpoint_Version_;
 
 //-----------------------------CONSTRUCTOR----------------------------//
 Simulation::Simulation(unsigned long NE, unsigned long NI, double dt, double t_stop, double g, double ETA)
-: NE_(NE), NI_(NI), CE_(NE/10), CI_(NI/10), dt_(dt), g_(g), ETA_(ETA), clock_(0), Tstop_( static_cast<int>(t_stop*10) / static_cast<int>(dt*10)), brain_(Brain(NE_, NI_, CE_, CI_, dt_, v_ext_, Delay_Steps_, Refractory_Time_Steps_, Vthr_, Vreset_, JE_, JI_, J_, TAU_, R_))
+: NE_(NE), NI_(NI), CE_(NE/10), CI_(NI/10), dt_(dt), g_(g), ETA_(ETA), clock_(0), Tstop_(nb_steps(t_stop, dt)), brain_(Brain(NE_, NI_, CE_, CI_, dt_, v_ext_, Delay_Steps_, Refractory_Time_Steps_, Vthr_, Vreset_, JE_, JI_, J_, TAU_, R_))
+{}
+
+Simulation::Simulation(unsigned long NE, unsigned long NI, double dt, double t_stop, double g, double ETA, unsigned int seed, const std::string& cache_directory)
+: Simulation(cache_directory.empty() ? Connectivity::random(NE, NI, NE/10, NI/10, seed) : Connectivity::cached_random(NE, NI, NE/10, NI/10, seed, cache_directory), NE, dt, t_stop, g, ETA)
+{}
+
+Simulation::Simulation(std::shared_ptr<Connectivity> network, unsigned long NE, double dt, double t_stop, double g, double ETA)
+: NE_(NE), NI_(network->get_nb_neurons()-NE), CE_(NE/10), CI_(NI_/10), dt_(dt), g_(g), ETA_(ETA), clock_(0), Tstop_(nb_steps(t_stop, dt)), brain_(Brain(network, NE_, dt_, v_ext_, Delay_Steps_, Refractory_Time_Steps_, Vthr_, Vreset_, JE_, JI_, J_, TAU_, R_))
 {}
 
 //-------------------------------GETTERS------------------------------//
@@ -41,13 +53,173 @@ double Simulation::get_v_ext() const
 	return v_ext_;
 }
 
+MeanField Simulation::get_mean_field() const
+{
+	return mean_field(NE_, NI_);
+}
+
+MeanField Simulation::mean_field(unsigned long NE, unsigned long NI)
+{
+	return MeanField(NE/10, NI/10, J_*JE_, D_, Refractory_Time_, Vthr_, Vreset_, TAU_);
+}
+
+PopulationDensity Simulation::get_population_density() const
+{
+	return population_density(NE_, NI_, dt_, g_, ETA_);
+}
+
+PopulationDensity Simulation::population_density(unsigned long NE, unsigned long NI, double dt, double g, double ETA)
+{
+	return PopulationDensity(NE, NI, NE/10, NI/10, g, ETA, dt, nb_steps(D_, dt), nb_steps(Refractory_Time_, dt), Vthr_, Vreset_, J_*JE_, TAU_);
+}
+
+unsigned int Simulation::nb_steps(double time, double dt)
+{
+	return static_cast<int>(time*10) / static_cast<int>(dt*10);
+}
+
+unsigned long Simulation::get_clock() const
+{
+	return clock_;
+}
+
+const Brain& Simulation::get_brain() const
+{
+	return brain_;
+}
+
+const ConvergenceMonitor* Simulation::get_convergence_monitor() const
+{
+	return monitor_.get();
+}
+
+void Simulation::set_noise_seed(unsigned int seed)
+{
+	brain_.set_noise_seed(seed);
+}
+
+void Simulation::set_background_noise(BackgroundNoise noise)
+{
+	brain_.set_background_noise(noise);
+}
+
+void Simulation::set_t_stop(double t_stop)
+{
+	Tstop_ = nb_steps(t_stop, dt_);
+}
+
+void Simulation::set_remaining_time(double time)
+{
+	Tstop_ = clock_ + nb_steps(time, dt_);
+}
+
+void Simulation::enable_background_checkpoints(const std::string& prefix, double interval, unsigned int retention)
+{
+	unsigned long interval_steps(nb_steps(interval, dt_));
+	checkpointer_.reset(new BackgroundCheckpointer(prefix, interval_steps, retention));
+}
+
+const BackgroundCheckpointer* Simulation::get_background_checkpointer() const
+{
+	return checkpointer_.get();
+}
+
+void Simulation::enable_early_stopping(const StoppingCriteria& criteria)
+{
+	if (monitor_ == nullptr) {
+		monitor_.reset(new ConvergenceMonitor(NE_+NI_, dt_, criteria));
+		brain_.attach_recorder(monitor_.get());
+	}
+}
+
+void Simulation::attach_recorder(Recorder* recorder)
+{
+	brain_.attach_recorder(recorder);
+}
+
+void Simulation::detach_recorder(Recorder* recorder)
+{
+	brain_.detach_recorder(recorder);
+}
+
 //---------------------------------RUN--------------------------------//
-void Simulation::run(std::ofstream& file)
+void Simulation::run(std::ostream& file)
 {
 	while (clock_ < Tstop_) {
 		clock_ += 1;
 		brain_.update(clock_, file);
+		
+		if (checkpointer_ != nullptr) {
+			checkpointer_->step(*this, clock_);
+		}
+		if (monitor_ != nullptr and monitor_->should_stop()) {
+			break;
+		}
+	}
+	
+	//the checkpoints are complete when run() ends
+	if (checkpointer_ != nullptr) {
+		checkpointer_->poll(true);
+	}
+}
+
+//------------------------------CHECKPOINTS---------------------------//
+bool Simulation::save(const std::string& file_name) const
+{
+	std::ofstream file(file_name, std::ios::binary);
+	if (not file.is_open()) {
+		return false;
+	}
+	
+	write_binary(file, Checkpoint_Magic_);
+	write_binary(file, Checkpoint_Version_);
+	write_binary(file, NE_);
+	write_binary(file, NI_);
+	write_binary(file, dt_);
+	write_binary(file, g_);
+	write_binary(file, ETA_);
+	write_binary(file, clock_);
+	brain_.save(file);
+	
+	file.close();
+	return file.good();
+}
+
+bool Simulation::restore(const std::string& file_name)
+{
+	std::ifstream file(file_name, std::ios::binary);
+	
+	unsigned long long magic;
+	unsigned int version;
+	unsigned long NE, NI, clock;
+	double dt, g, ETA;
+	if (not read_binary(file, magic) or magic != Checkpoint_Magic_ or not read_binary(file, version) or version != Checkpoint_Version_) {
+		return false;
+	}
+	if (not read_binary(file, NE) or not read_binary(file, NI) or not read_binary(file, dt) or not read_binary(file, g) or not read_binary(file, ETA) or not read_binary(file, clock)) {
+		return false;
+	}
+	if (NE != NE_ or NI != NI_ or dt != dt_ or g != g_ or ETA != ETA_) {
+		return false;
+	}
+	if (not brain_.load(file)) {
+		return false;
+	}
+	
+	clock_ = clock;
+	return true;
+}
+
+bool Simulation::continue_from(const Simulation& previous)
+{
+	if (previous.NE_ != NE_ or previous.NI_ != NI_ or previous.dt_ != dt_ or not brain_.copy_state(previous.brain_)) {
+		return false;
 	}
+	
+	const unsigned long length(Tstop_ > clock_ ? Tstop_ - clock_ : 0);
+	clock_ = previous.clock_;
+	Tstop_ = clock_ + length;
+	return true;
 }
 
 //------------------------------DESTRUCTOR----------------------------//	
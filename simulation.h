@@ -2,7 +2,13 @@
 #define SIMULATION_H
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <string>
+#include "background_checkpointer.h"
 #include "brain.h"
+#include "convergence_monitor.h"
+#include "mean_field.h"
+#include "population_density.h"
 
 class Simulation {
 	public:
@@ -17,6 +23,30 @@ class Simulation {
     */
 	Simulation(unsigned long NE, unsigned long NI, double dt, double t_stop, double g, double ETA);
 	
+	///CONSTRUCTOR with reproducible connections.
+	/**
+      \param NE is the number of excitatory neurons wanted for the simulation.
+      \param NI is the number of inhibitory neurons wanted for the simulation.
+      \param dt is the time step for each update in ms.
+      \param t_stop is the length of the simulation in ms.
+      \param g is the positive ratio of JI/JE.
+      \param ETA is the ratio for one connection and one second of v_ext/v_thr.
+      \param seed is the seed used to create the connections.
+      \param cache_directory is the directory where the connections are cached (mapped if they already exist, saved otherwise), no cache if it is empty.
+    */
+	Simulation(unsigned long NE, unsigned long NI, double dt, double t_stop, double g, double ETA, unsigned int seed, const std::string& cache_directory = "");
+	
+	///CONSTRUCTOR with connections already created (shared with the other simulations using them).
+	/**
+      \param network contains the connections, NI is its number of neurons minus NE.
+      \param NE is the number of excitatory neurons wanted for the simulation.
+      \param dt is the time step for each update in ms.
+      \param t_stop is the length of the simulation in ms.
+      \param g is the positive ratio of JI/JE.
+      \param ETA is the ratio for one connection and one second of v_ext/v_thr.
+    */
+	Simulation(std::shared_ptr<Connectivity> network, unsigned long NE, double dt, double t_stop, double g, double ETA);
+	
 		//getters
 	///getter for the CE constant (number of excitatory connections received by each neuron).
 	/**
@@ -60,17 +90,152 @@ class Simulation {
     */
 	double get_v_ext() const;
 	
+	///getter for the mean-field theory of the network (built with the parameters of the simulation).
+	/**
+      \return the mean-field theory, whose predict(g, ETA) gives the stationary rate and the stability.
+    */
+	MeanField get_mean_field() const;
+
+	///getter for a population-density model of the network (built with the parameters of the simulation).
+	/**
+      \return the model, which simulates the rates of the populations much faster than the brain.
+    */
+	PopulationDensity get_population_density() const;
+	
+	///the mean-field theory of the network of a simulation, without creating the simulation (and its connections).
+	/**
+      \param NE is the number of excitatory neurons.
+      \param NI is the number of inhibitory neurons.
+      \return the same theory as get_mean_field() of a simulation with these numbers of neurons.
+    */
+	static MeanField mean_field(unsigned long NE, unsigned long NI);
+	
+	///a population-density model of the network of a simulation, without creating the simulation (and its connections).
+	/**
+      \param NE is the number of excitatory neurons.
+      \param NI is the number of inhibitory neurons.
+      \param dt is the time step in ms.
+      \param g is the positive ratio of JI/JE.
+      \param ETA is the ratio for one connection and one second of v_ext/v_thr.
+      \return the same model as get_population_density() of a simulation with these parameters.
+    */
+	static PopulationDensity population_density(unsigned long NE, unsigned long NI, double dt, double g, double ETA);
+	
+	///getter for the clock.
+	/**
+      \return the current time of the simulation in number of steps.
+    */
+	unsigned long get_clock() const;
+	
+	///getter for the brain (its state can be read through RecordedNetwork).
+	const Brain& get_brain() const;
+	
+	///getter for the convergence monitor.
+	/**
+      \return the monitor of the early termination (null pointer if the early termination is not enabled).
+    */
+	const ConvergenceMonitor* get_convergence_monitor() const;
+	
+	///attach a recorder to the brain of the simulation (the simulation doesn't own it).
+	/**
+      \param recorder is the recorder to attach.
+    */
+	void attach_recorder(Recorder* recorder);
+	
+	///detach a recorder attached before (it won't be told about the next updates).
+	/**
+      \param recorder is the recorder to detach.
+    */
+	void detach_recorder(Recorder* recorder);
+	
+	///sets the seed of the background noise (by default it is random).
+	/**
+      \param seed is the seed of the random generator of the background noise.
+    */
+	void set_noise_seed(unsigned int seed);
+	
+	///chooses the kind of background noise (Poisson by default, see Brain::set_background_noise()).
+	/**
+      \param noise is the kind of background noise.
+    */
+	void set_background_noise(BackgroundNoise noise);
+	
+	///changes the end of the simulation (for example to extend a finished or restored simulation).
+	/**
+      \param t_stop is the new length of the simulation in ms.
+    */
+	void set_t_stop(double t_stop);
+	
+	///changes the end of the simulation to a time after the current clock.
+	/**
+      \param time is the time (ms) which remains to be simulated.
+    */
+	void set_remaining_time(double time);
+	
+	///enables periodic checkpoints written in the background by a forked process while run() goes on.
+	/**
+      \param prefix is the beginning of the names of the files (the clock and ".chk" are added).
+      \param interval is the time between two checkpoints in ms.
+      \param retention is the number of complete checkpoint files kept (0 to keep all of them).
+    */
+	void enable_background_checkpoints(const std::string& prefix, double interval, unsigned int retention = 2);
+	
+	///getter for the background checkpointer.
+	/**
+      \return the checkpointer (null pointer if the periodic checkpoints are not enabled).
+    */
+	const BackgroundCheckpointer* get_background_checkpointer() const;
+	
+	///enables the early termination: run() will stop before t_stop if the statistics of the network have converged.
+	/**
+      \param criteria contains the parameters of the early termination.
+    */
+	void enable_early_stopping(const StoppingCriteria& criteria);
+	
 		//run
-	///run the simulation from time = 0 to time = t_stop with a time step of dt_
+	///run the simulation from time = 0 to time = t_stop with a time step of dt_ (or until the statistics have converged if the early termination is enabled)
 	/**
       \param file is the file in which the data are printed
     */
-	void run(std::ofstream& file);
+	void run(std::ostream& file);
+	
+		//checkpoints
+	///writes the complete state of the simulation (clock, parameters and brain) in a binary file.
+	/**
+      \param file_name is the name of the file.
+      \return true if the file could be written.
+    */
+	bool save(const std::string& file_name) const;
+	
+	///restores a state written by save(): the simulation then continues with exactly the same spikes.
+	/**
+	  The simulation has to be created with the same parameters (NE, NI, dt, g and ETA), t_stop can be different.
+	  The recorders attached are not restored.
+      \param file_name is the name of the file.
+      \return true if the state could be restored (if false, the simulation has to be restored again before being used).
+    */
+	bool restore(const std::string& file_name);
+	
+	///starts from the last state of another simulation (warm start of a continuation sweep, where the network is already equilibrated).
+	/**
+	  The neurons take the state of the other simulation but keep the parameters (g, ETA) and the background noise of this one.
+	  The clock goes on from the clock of the other simulation, and the simulation then runs for t_stop.
+      \param previous is the simulation copied (same number of neurons and same time step).
+      \return true if the state could be copied.
+    */
+	bool continue_from(const Simulation& previous);
 	
 	///DESTRUCTOR
 	~Simulation();
 	
 	private:
+	///number of time steps of a duration (the same rounding for every duration of the simulation).
+	/**
+      \param time is the duration in ms.
+      \param dt is the time step in ms.
+    */
+	static unsigned int nb_steps(double time, double dt);
+	
 		//Parameters
 	const unsigned long NE_; /**< number of excitatory neurons */
 	const unsigned long NI_; /**< number of inhibitory neurons */
@@ -79,33 +244,42 @@ class Simulation {
 
 	const double dt_; /**< time step */	
 	
-	const double D_ = 1.5; /**< delay to transmit a signal in ms */	
-	const unsigned int Delay_Steps_ = static_cast<int>(D_*10) / static_cast<int>(dt_*10); /**< delay in number of time steps */
+	static constexpr double D_ = 1.5; /**< delay to transmit a signal in ms */	
+	const unsigned int Delay_Steps_ = nb_steps(D_, dt_); /**< delay in number of time steps */
 	
-	const double Refractory_Time_ = 2.0; /**< time (ms) after a spike during which the neuron won't have any activity */
-	const unsigned int Refractory_Time_Steps_ = static_cast<int>(Refractory_Time_*10) / static_cast<int>(dt_*10); /**< refractrory time in number of time steps */
+	static constexpr double Refractory_Time_ = 2.0; /**< time (ms) after a spike during which the neuron won't have any activity */
+	const unsigned int Refractory_Time_Steps_ = nb_steps(Refractory_Time_, dt_); /**< refractrory time in number of time steps */
 	
-	const double Vthr_ = 20.0; /**< potential (mV) to exceed for a spike to appear */
-	const double Vreset_ = 0.0; /**< initial and refractory potential (mV) */
+	static constexpr double Vthr_ = 20.0; /**< potential (mV) to exceed for a spike to appear */
+	static constexpr double Vreset_ = 0.0; /**< initial and refractory potential (mV) */
 	
 	const double g_; /**< positive ratio of JI/JE */
-	const double JE_ = 1.0; /**< potential transmited when an excitatory neuron has a spike in number of J_ */ 
+	static constexpr double JE_ = 1.0; /**< potential transmited when an excitatory neuron has a spike in number of J_ */ 
 	const double JI_ = -g_ * JE_; /**< potential transmited when an inhibitory neuron has a spike in number of J_ */ 
-	const double J_ = 0.1; /**< (mV) */
+	static constexpr double J_ = 0.1; /**< (mV) */
 	
-	const double TAU_ = 20.0; /**< membrane time constant (ms) */
-	const double C_ = 1.0; /**< constant */
-	const double R_ = TAU_/C_; /**< resistance of the membrane */
+	static constexpr double TAU_ = 20.0; /**< membrane time constant (ms) */
+	static constexpr double C_ = 1.0; /**< constant */
+	static constexpr double R_ = TAU_/C_; /**< resistance of the membrane */
 	
 	const double ETA_; /**< ratio for one connection and one second of v_ext/v_thr */
 	const double v_ext_ = ETA_*Vthr_*dt_ / (J_*TAU_) ; /**< the frequency of the external input needed to reach Vthr */
 	
+	static const unsigned long long Checkpoint_Magic_ = 0x4b434c454e555242ull; /**< first bytes of a checkpoint file ("BRUNELCK") */
+	static const unsigned int Checkpoint_Version_ = 6; /**< version of the checkpoint format */
+	
 		//Time
 	unsigned long clock_; /**< clock */
 	unsigned long Tstop_; /**< length of the simulation */
 	
 		//Brain
 	Brain brain_; /**< brain of the simulation */
+	
+		//Early termination
+	std::unique_ptr<ConvergenceMonitor> monitor_; /**< monitor of the early termination (null if it is not enabled) */
+	
+		//Checkpoints
+	std::unique_ptr<BackgroundCheckpointer> checkpointer_; /**< writer of the periodic checkpoints (null if they are not enabled) */
 };
 
 #endif
@@ -0,0 +1,71 @@
+#include "spike_recorder.h"
+
+//-----------------------------CONSTRUCTOR----------------------------//
+SpikeRecorder::SpikeRecorder(unsigned long capacity, double dt, std::ostream* spill, unsigned long first_neuron, unsigned long last_neuron)
+: capacity_(capacity), dt_(dt), spill_(spill), first_neuron_(first_neuron), last_neuron_(last_neuron)
+, nb_recorded_(0), nb_dropped_(0)
+{
+	times_.reserve(capacity_);
+	neurons_.reserve(capacity_);
+}
+
+//-------------------------------GETTERS------------------------------//
+unsigned long SpikeRecorder::get_nb_recorded() const
+{
+	return nb_recorded_;
+}
+
+unsigned long SpikeRecorder::get_nb_dropped() const
+{
+	return nb_dropped_;
+}
+
+std::vector<unsigned long> SpikeRecorder::get_spike_times(unsigned long neuron_index) const
+{
+	std::vector<unsigned long> spike_times;
+	for (unsigned long i(0) ; i<neurons_.size() ; ++i) {
+		if (neurons_[i] == neuron_index) {
+			spike_times.push_back(times_[i]);
+		}
+	}
+	return spike_times;
+}
+
+//------------------------------RECORDING-----------------------------//
+void SpikeRecorder::record_spike(unsigned long neuron_index, unsigned long T)
+{
+	if (neuron_index < first_neuron_ or neuron_index >= last_neuron_) {
+		return;
+	}
+
+	//the memory is full: we empty it in the spill stream or we stop recording
+	if (times_.size() >= capacity_) {
+		if (spill_ == nullptr) {
+			++nb_dropped_;
+			return;
+		}
+		flush();
+	}
+
+	times_.push_back(T);
+	neurons_.push_back(neuron_index);
+	++nb_recorded_;
+}
+
+void SpikeRecorder::flush()
+{
+	if (spill_ == nullptr) {
+		return;
+	}
+	for (unsigned long i(0) ; i<times_.size() ; ++i) {
+		*spill_ << times_[i]*dt_ << '\t' << neurons_[i] << '\n';
+	}
+	times_.clear();
+	neurons_.clear();
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+SpikeRecorder::~SpikeRecorder()
+{
+	flush();
+}
@@ -0,0 +1,66 @@
+#ifndef SPIKE_RECORDER_H
+#define SPIKE_RECORDER_H
+#include <iostream>
+#include <vector>
+#include "recorder.h"
+
+class SpikeRecorder : public Recorder {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param capacity is the maximal number of spikes kept in memory.
+      \param dt is the time step in ms (used to write the spike times in ms).
+      \param spill is the stream where the spikes are written when the memory is full, if it is a null pointer the recorder stops recording instead.
+      \param first_neuron is the index of the first neuron recorded.
+      \param last_neuron is the index after the last neuron recorded (by default every neuron is recorded).
+    */
+	SpikeRecorder(unsigned long capacity, double dt = 0.1, std::ostream* spill = nullptr, unsigned long first_neuron = 0, unsigned long last_neuron = -1);
+
+		//getters
+	///getter for the number of spikes recorded (in memory and written in the spill stream).
+	/**
+      \return the number of spikes recorded since the beginning.
+    */
+	unsigned long get_nb_recorded() const;
+
+	///getter for the number of spikes which could not be recorded because the memory was full.
+	/**
+      \return the number of spikes lost.
+    */
+	unsigned long get_nb_dropped() const;
+
+	///getter for the times of the spikes of a neuron which are still in memory.
+	/**
+      \param neuron_index is the index of the neuron.
+      \return the spike times (in number of steps) of the neuron.
+    */
+	std::vector<unsigned long> get_spike_times(unsigned long neuron_index) const;
+
+		//recording
+	///keeps the spike if the neuron is recorded (writes the memory in the spill stream first if it is full).
+	/**
+      \param neuron_index is the index of the neuron which had a spike.
+      \param T is the time of the spike (in number of steps).
+    */
+	void record_spike(unsigned long neuron_index, unsigned long T) override;
+
+	///writes the spikes in memory in the spill stream (with the same format as "spikes.txt") and empties the memory.
+	void flush();
+
+	///DESTRUCTOR (the spikes still in memory are written in the spill stream)
+	~SpikeRecorder();
+
+	private:
+	const unsigned long capacity_; /**< maximal number of spikes kept in memory */
+	const double dt_; /**< time step */
+	std::ostream* spill_; /**< stream where the spikes are written when the memory is full (can be a null pointer) */
+	const unsigned long first_neuron_; /**< index of the first neuron recorded */
+	const unsigned long last_neuron_; /**< index after the last neuron recorded */
+
+	std::vector<unsigned long> times_; /**< times of the spikes in memory */
+	std::vector<unsigned long> neurons_; /**< indexes of the neurons for the spikes in memory */
+	unsigned long nb_recorded_; /**< number of spikes recorded since the beginning */
+	unsigned long nb_dropped_; /**< number of spikes lost because the memory was full */
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "spike_statistics.h"
+#include <cmath>
+#include <random>
+
+//----------------------------ACCUMULATOR-----------------------------//
+void Accumulator::add(double x)
+{
+	++n;
+	const double delta(x - mean);
+	mean += delta / n;
+	m2 += delta * (x - mean);
+}
+
+double Accumulator::variance() const
+{
+	if (n < 2) {
+		return 0.0;
+	}
+	return m2 / (n-1);
+}
+
+double Accumulator::error() const
+{
+	if (n < 2) {
+		return INFINITY;
+	}
+	return 1.96 * std::sqrt(variance() / n);
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+SpikeStatistics::SpikeStatistics(unsigned long nb_neurons, double dt, unsigned int window_steps, unsigned int nb_pairs, unsigned int seed)
+: nb_neurons_(nb_neurons), dt_(dt), window_steps_(window_steps > 0 ? window_steps : 1)
+, nb_steps_(0), nb_spikes_(0)
+, last_spike_times_(nb_neurons, 0), has_spiked_(nb_neurons, false), intervals_(nb_neurons, Accumulator({0, 0.0, 0.0}))
+, steps_in_window_(0), window_counts_(nb_neurons, 0), counts_(nb_neurons, Accumulator({0, 0.0, 0.0})), nb_windows_(0)
+{
+	//reservoir sampling of 2*nb_pairs different neurons
+	const unsigned long nb_sampled(std::min<unsigned long>(2*nb_pairs, nb_neurons_ - nb_neurons_%2));
+	std::mt19937 generator(seed);
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		if (i < nb_sampled) {
+			pairs_.push_back(i);
+		} else {
+			std::uniform_int_distribution<unsigned long> random_index(0, i);
+			unsigned long k(random_index(generator));
+			if (k < nb_sampled) {
+				pairs_[k] = i;
+			}
+		}
+	}
+	products_.assign(pairs_.size()/2, 0.0);
+}
+
+//-------------------------------GETTERS------------------------------//
+double SpikeStatistics::get_mean_rate() const
+{
+	if (nb_neurons_ == 0 or nb_steps_ == 0) {
+		return 0.0;
+	}
+	//dt_ is in ms
+	return nb_spikes_ / (nb_neurons_ * nb_steps_*dt_*1e-3);
+}
+
+double SpikeStatistics::get_mean_cv() const
+{
+	return neuron_cvs().mean;
+}
+
+double SpikeStatistics::get_cv_error() const
+{
+	return neuron_cvs().error();
+}
+
+Accumulator SpikeStatistics::neuron_cvs() const
+{
+	Accumulator cvs({0, 0.0, 0.0});
+	for (const auto& intervals : intervals_) {
+		if (intervals.n >= 2 and intervals.mean > 0.0) {
+			cvs.add(std::sqrt(intervals.variance()) / intervals.mean);
+		}
+	}
+	return cvs;
+}
+
+double SpikeStatistics::get_mean_fano_factor() const
+{
+	double sum(0.0);
+	unsigned long nb(0);
+	for (const auto& counts : counts_) {
+		if (counts.n >= 2 and counts.mean > 0.0) {
+			sum += counts.variance() / counts.mean;
+			++nb;
+		}
+	}
+	return nb > 0 ? sum/nb : 0.0;
+}
+
+double SpikeStatistics::get_mean_correlation() const
+{
+	double sum(0.0);
+	unsigned long nb(0);
+	for (unsigned long k(0) ; k<products_.size() ; ++k) {
+		const Accumulator& x(counts_[pairs_[2*k]]);
+		const Accumulator& y(counts_[pairs_[2*k+1]]);
+		if (x.n < 2 or x.m2 <= 0.0 or y.m2 <= 0.0) {
+			continue;
+		}
+		const double covariance(products_[k] - x.n * x.mean * y.mean);
+		sum += covariance / std::sqrt(x.m2 * y.m2);
+		++nb;
+	}
+	return nb > 0 ? sum/nb : 0.0;
+}
+
+unsigned long SpikeStatistics::get_nb_windows() const
+{
+	return nb_windows_;
+}
+
+const std::vector<unsigned long>& SpikeStatistics::get_pairs() const
+{
+	return pairs_;
+}
+
+//------------------------------RECORDING-----------------------------//
+void SpikeStatistics::record_spike(unsigned long neuron_index, unsigned long T)
+{
+	if (has_spiked_[neuron_index]) {
+		intervals_[neuron_index].add(T - last_spike_times_[neuron_index]);
+	}
+	has_spiked_[neuron_index] = true;
+	last_spike_times_[neuron_index] = T;
+
+	++window_counts_[neuron_index];
+	++nb_spikes_;
+}
+
+void SpikeStatistics::end_of_step(const RecordedNetwork&, unsigned long)
+{
+	++nb_steps_;
+	++steps_in_window_;
+	if (steps_in_window_ == window_steps_) {
+		close_window();
+	}
+}
+
+void SpikeStatistics::close_window()
+{
+	for (unsigned long k(0) ; k<products_.size() ; ++k) {
+		products_[k] += static_cast<double>(window_counts_[pairs_[2*k]]) * window_counts_[pairs_[2*k+1]];
+	}
+	for (unsigned long i(0) ; i<nb_neurons_ ; ++i) {
+		counts_[i].add(window_counts_[i]);
+		window_counts_[i] = 0;
+	}
+	steps_in_window_ = 0;
+	++nb_windows_;
+}
+
+void SpikeStatistics::reset()
+{
+	has_spiked_.assign(nb_neurons_, false);
+	intervals_.assign(nb_neurons_, Accumulator({0, 0.0, 0.0}));
+	reset_counts();
+}
+
+void SpikeStatistics::reset_counts()
+{
+	nb_steps_ = 0;
+	nb_spikes_ = 0;
+	steps_in_window_ = 0;
+	window_counts_.assign(nb_neurons_, 0);
+	counts_.assign(nb_neurons_, Accumulator({0, 0.0, 0.0}));
+	nb_windows_ = 0;
+	products_.assign(products_.size(), 0.0);
+}
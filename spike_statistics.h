@@ -0,0 +1,122 @@
+#ifndef SPIKE_STATISTICS_H
+#define SPIKE_STATISTICS_H
+#include <vector>
+#include "recorder.h"
+
+///running mean and variance (Welford's algorithm).
+struct Accumulator {
+	unsigned long n; /**< number of values */
+	double mean; /**< mean of the values */
+	double m2; /**< sum of the squared differences to the mean */
+
+	///adds a value.
+	void add(double x);
+	///the sample variance (0 with less than 2 values).
+	double variance() const;
+	///half-width of the 95% confidence interval of the mean (infinite with less than 2 values).
+	double error() const;
+};
+
+///computes during the simulation the statistics used to classify the regime of the network.
+/**
+  - the coefficient of variation (CV) of the interspike intervals, from the last spike time of each neuron and a running (Welford) mean and variance of its intervals,
+  - the Fano factor of the spike counts in windows of window_steps steps, with a running mean and variance of the counts of each neuron,
+  - the correlation coefficient between the spike counts of pairs of neurons, the neurons being chosen by reservoir sampling.
+  The memory is proportional to the number of neurons and each spike costs O(1).
+*/
+class SpikeStatistics : public Recorder {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param nb_neurons is the number of neurons of the brain.
+      \param dt is the time step in ms.
+      \param window_steps is the length of the counting windows (Fano factor and correlations) in number of steps.
+      \param nb_pairs is the number of pairs of neurons used for the correlations.
+      \param seed is the seed used to choose the pairs.
+    */
+	SpikeStatistics(unsigned long nb_neurons, double dt = 0.1, unsigned int window_steps = 500, unsigned int nb_pairs = 100, unsigned int seed = 0);
+
+		//getters
+	///getter for the mean firing rate.
+	/**
+      \return the mean firing rate of one neuron in Hz.
+    */
+	double get_mean_rate() const;
+
+	///getter for the mean coefficient of variation of the interspike intervals.
+	/**
+      \return the mean of the CV of the neurons which have at least 2 intervals (0 if there are none).
+    */
+	double get_mean_cv() const;
+
+	///getter for the uncertainty of the mean CV, from the spread of the CVs of the neurons (independent samples).
+	/**
+      \return the half-width of the 95% confidence interval of get_mean_cv() (infinite with less than 2 neurons which have a CV).
+    */
+	double get_cv_error() const;
+
+	///getter for the mean Fano factor of the spike counts.
+	/**
+      \return the mean of the Fano factor of the neurons which spiked in at least one window (0 if there are none).
+    */
+	double get_mean_fano_factor() const;
+
+	///getter for the mean correlation coefficient of the spike counts of the sampled pairs.
+	/**
+      \return the mean of the correlation coefficients of the pairs whose neurons both have a variable count (0 if there are none).
+    */
+	double get_mean_correlation() const;
+
+	///getter for the number of full counting windows.
+	/**
+      \return the number of windows since the beginning.
+    */
+	unsigned long get_nb_windows() const;
+
+	///getter for the pairs of neurons used for the correlations.
+	/**
+      \return the indexes of the neurons, the pair k being the neurons 2k and 2k+1.
+    */
+	const std::vector<unsigned long>& get_pairs() const;
+
+		//recording
+	///updates the interval statistics and the count of the neuron.
+	void record_spike(unsigned long neuron_index, unsigned long T) override;
+
+	///closes the counting window if it is full.
+	void end_of_step(const RecordedNetwork& brain, unsigned long T) override;
+
+	///forgets everything which has been recorded (for example at the end of a transient), the pairs are kept.
+	void reset();
+
+	///forgets the rate, the counts and the correlations but keeps the interspike intervals and the last spikes (the CV goes on).
+	void reset_counts();
+
+	private:
+	///the statistics of the CVs of the neurons which have at least 2 intervals.
+	Accumulator neuron_cvs() const;
+
+	///updates the Fano factors and the correlations with the counts of the window.
+	void close_window();
+
+	const unsigned long nb_neurons_; /**< number of neurons */
+	const double dt_; /**< time step */
+	const unsigned int window_steps_; /**< length of the counting windows in number of steps */
+
+	unsigned long nb_steps_; /**< number of steps recorded */
+	unsigned long nb_spikes_; /**< number of spikes recorded */
+
+	std::vector<unsigned long> last_spike_times_; /**< time of the last spike of each neuron */
+	std::vector<bool> has_spiked_; /**< says if each neuron already had a spike */
+	std::vector<Accumulator> intervals_; /**< statistics of the interspike intervals (in steps) of each neuron */
+
+	unsigned int steps_in_window_; /**< number of steps in the current window */
+	std::vector<unsigned int> window_counts_; /**< number of spikes of each neuron in the current window */
+	std::vector<Accumulator> counts_; /**< statistics of the window counts of each neuron */
+	unsigned long nb_windows_; /**< number of full windows */
+
+	std::vector<unsigned long> pairs_; /**< neurons of the sampled pairs (2k and 2k+1) */
+	std::vector<double> products_; /**< sum over the windows of the product of the counts of each pair */
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "stdp.h"
+#include "binary_io.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+///decay of a trace during the first steps (until it is about 1e-4).
+std::vector<double> trace_decays(double dt, double TAU)
+{
+	std::vector<double> decays(static_cast<unsigned long>(std::ceil(9.0*TAU/dt)) + 1);
+	for (unsigned long k(0) ; k<decays.size() ; ++k) {
+		decays[k] = std::exp(-(k*dt)/TAU);
+	}
+	return decays;
+}
+
+}
+
+//-----------------------------CONSTRUCTOR----------------------------//
+Stdp::Stdp()
+: dt_(0.1), first_transmitter_(0), end_transmitter_(0), first_receiver_(0), end_receiver_(0), first_connection_(0)
+{}
+
+Stdp::Stdp(std::shared_ptr<const Connectivity> network, unsigned long first_transmitter, unsigned long end_transmitter, unsigned long first_receiver, unsigned long end_receiver, double weight, double dt, const StdpParameters& parameters)
+: parameters_(parameters), dt_(dt)
+, first_transmitter_(first_transmitter), end_transmitter_(end_transmitter), first_receiver_(first_receiver), end_receiver_(end_receiver)
+, decays_plus_(trace_decays(dt, parameters.TAU_plus)), decays_minus_(trace_decays(dt, parameters.TAU_minus))
+, network_(network), first_connection_(network->begin(first_transmitter) - network->begin(0))
+, incoming_offsets_(end_receiver - first_receiver + 1, 0)
+, transmitter_traces_(end_transmitter - first_transmitter, Trace({0.0, 0}))
+, receiver_traces_(end_receiver - first_receiver, Trace({0.0, 0}))
+{
+	const std::uint32_t* receivers(network_->begin(0));
+	const unsigned long end_connection(network_->begin(end_transmitter) - receivers);
+	weights_.resize(end_connection - first_connection_);
+	for (unsigned long k(first_connection_) ; k<end_connection ; ++k) {
+		weights_[k - first_connection_] = weight*network_->get_weight(k);
+	}
+
+	//the transposed index is made in two passes: first the number of connections received by each receiver, then their place
+	for (unsigned int pass(0) ; pass<2 ; ++pass) {
+		for (unsigned long i(first_transmitter) ; i<end_transmitter ; ++i) {
+			for (const std::uint32_t* receiver(network_->begin(i)) ; receiver != network_->end(i) ; ++receiver) {
+				if (*receiver >= first_receiver and *receiver < end_receiver) {
+					const unsigned long j(*receiver - first_receiver);
+					if (pass == 0) {
+						++incoming_offsets_[j+1];
+					} else {
+						incoming_connections_[incoming_offsets_[j]] = (receiver - receivers) - first_connection_;
+						incoming_transmitters_[incoming_offsets_[j]++] = i;
+					}
+				}
+			}
+		}
+
+		const unsigned long nb_receivers(end_receiver - first_receiver);
+		if (pass == 0) {
+			for (unsigned long j(0) ; j<nb_receivers ; ++j) {
+				incoming_offsets_[j+1] += incoming_offsets_[j];
+			}
+			incoming_connections_.resize(incoming_offsets_[nb_receivers]);
+			incoming_transmitters_.resize(incoming_offsets_[nb_receivers]);
+		} else {
+			//incoming_offsets_[j] now points at the end of the connections of j, which is the beginning of the connections of j+1
+			for (unsigned long j(nb_receivers) ; j>0 ; --j) {
+				incoming_offsets_[j] = incoming_offsets_[j-1];
+			}
+			incoming_offsets_[0] = 0;
+		}
+	}
+}
+
+//-------------------------------GETTERS------------------------------//
+bool Stdp::is_enabled() const
+{
+	return network_ != nullptr;
+}
+
+const StdpParameters& Stdp::get_parameters() const
+{
+	return parameters_;
+}
+
+const float* Stdp::get_weights(unsigned long transmitter_neuron) const
+{
+	if (transmitter_neuron < first_transmitter_ or transmitter_neuron >= end_transmitter_) {
+		return nullptr;
+	}
+	return weights_.data() + (network_->begin(transmitter_neuron) - network_->begin(0)) - first_connection_;
+}
+
+double Stdp::get_weight(unsigned long transmitter_neuron, unsigned long receiver_neuron) const
+{
+	const float* weights(get_weights(transmitter_neuron));
+	if (weights != nullptr) {
+		const std::uint32_t* begin(network_->begin(transmitter_neuron));
+		const std::uint32_t* receiver(std::find(begin, network_->end(transmitter_neuron), receiver_neuron));
+		if (receiver != network_->end(transmitter_neuron) and receiver_neuron >= first_receiver_ and receiver_neuron < end_receiver_) {
+			return weights[receiver - begin];
+		}
+	}
+	return 0.0;
+}
+
+double Stdp::get_mean_weight() const
+{
+	double sum(0.0);
+	for (auto connection : incoming_connections_) {
+		sum += weights_[connection];
+	}
+	return incoming_connections_.empty() ? 0.0 : sum/incoming_connections_.size();
+}
+
+//--------------------------------UPDATE------------------------------//
+void Stdp::spikes(const std::vector<unsigned long>& neuron_indexes, unsigned long T)
+{
+	//no trace changes before every weight has changed
+	for (auto neuron_index : neuron_indexes) {
+		depress(neuron_index, T);
+		potentiate(neuron_index, T);
+	}
+	for (auto neuron_index : neuron_indexes) {
+		add_spike(neuron_index, T);
+	}
+}
+
+void Stdp::depress(unsigned long neuron_index, unsigned long T)
+{
+	if (neuron_index < first_transmitter_ or neuron_index >= end_transmitter_) {
+		return;
+	}
+	const double depression(parameters_.A_minus*parameters_.w_max);
+	float* weights(weights_.data() + (network_->begin(neuron_index) - network_->begin(0)) - first_connection_);
+	const std::uint32_t* begin(network_->begin(neuron_index));
+	const std::uint32_t* end(network_->end(neuron_index));
+	for (const std::uint32_t* receiver(begin) ; receiver != end ; ++receiver) {
+		if (*receiver >= first_receiver_ and *receiver < end_receiver_) {
+			const unsigned long j(*receiver - first_receiver_);
+			float& weight(weights[receiver - begin]);
+			weight = std::max(0.0, weight - depression*value(receiver_traces_[j], T, decays_minus_, parameters_.TAU_minus));
+		}
+	}
+}
+
+void Stdp::potentiate(unsigned long neuron_index, unsigned long T)
+{
+	if (neuron_index < first_receiver_ or neuron_index >= end_receiver_) {
+		return;
+	}
+	const unsigned long j(neuron_index - first_receiver_);
+	const double potentiation(parameters_.A_plus*parameters_.w_max);
+	for (unsigned long k(incoming_offsets_[j]) ; k<incoming_offsets_[j+1] ; ++k) {
+		const unsigned long i(incoming_transmitters_[k] - first_transmitter_);
+		float& weight(weights_[incoming_connections_[k]]);
+		weight = std::min(parameters_.w_max, weight + potentiation*value(transmitter_traces_[i], T, decays_plus_, parameters_.TAU_plus));
+	}
+}
+
+void Stdp::add_spike(unsigned long neuron_index, unsigned long T)
+{
+	if (neuron_index >= first_transmitter_ and neuron_index < end_transmitter_) {
+		const unsigned long i(neuron_index - first_transmitter_);
+		transmitter_traces_[i] = Trace({value(transmitter_traces_[i], T, decays_plus_, parameters_.TAU_plus) + 1.0, T});
+	}
+	if (neuron_index >= first_receiver_ and neuron_index < end_receiver_) {
+		const unsigned long j(neuron_index - first_receiver_);
+		receiver_traces_[j] = Trace({value(receiver_traces_[j], T, decays_minus_, parameters_.TAU_minus) + 1.0, T});
+	}
+}
+
+double Stdp::value(const Trace& trace, unsigned long T, const std::vector<double>& decays, double TAU) const
+{
+	const unsigned long nb_steps(T - trace.last_spike);
+	return trace.value * (nb_steps < decays.size() ? decays[nb_steps] : std::exp(-(nb_steps*dt_)/TAU));
+}
+
+//--------------------------------FILES-------------------------------//
+void Stdp::save(std::ostream& out) const
+{
+	write_binary_vector(out, weights_);
+	write_binary_vector(out, transmitter_traces_);
+	write_binary_vector(out, receiver_traces_);
+}
+
+bool Stdp::load(std::istream& in)
+{
+	std::vector<float> weights;
+	std::vector<Trace> transmitter_traces, receiver_traces;
+	if (not read_binary_vector(in, weights, weights_.size()) or weights.size() != weights_.size()
+		or not read_binary_vector(in, transmitter_traces, transmitter_traces_.size()) or transmitter_traces.size() != transmitter_traces_.size()
+		or not read_binary_vector(in, receiver_traces, receiver_traces_.size()) or receiver_traces.size() != receiver_traces_.size()) {
+		return false;
+	}
+	weights_.swap(weights);
+	transmitter_traces_.swap(transmitter_traces);
+	receiver_traces_.swap(receiver_traces);
+	return true;
+}
+
+//---------------------------DESTRUCTOR-------------------------------//
+Stdp::~Stdp()
+{}
@@ -0,0 +1,143 @@
+#ifndef STDP_H
+#define STDP_H
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "connectivity.h"
+
+///the parameters of the spike-timing-dependent plasticity (see Stdp).
+struct StdpParameters {
+	unsigned int source = 0; /**< population of the transmitters of the plastic connections (the excitatory one) */
+	unsigned int target = 0; /**< population of the receivers of the plastic connections */
+	double A_plus = 0.01; /**< increase of a weight (fraction of w_max) when the receiver spikes just after the transmitter */
+	double A_minus = 0.0105; /**< decrease of a weight (fraction of w_max) when the transmitter spikes just after the receiver */
+	double TAU_plus = 20.0; /**< time constant of the traces of the transmitters (ms) */
+	double TAU_minus = 20.0; /**< time constant of the traces of the receivers (ms) */
+	double w_max = 2.0; /**< largest weight (number of J), the smallest one is 0 */
+};
+
+///the spike-timing-dependent plasticity of the connections from a range of neurons to another one (additive, with all the pairs of spikes).
+/**
+  Each neuron has a trace which increases by 1 at each of its spikes and decays exponentially: x for the
+  transmitters (TAU_plus) and y for the receivers (TAU_minus). When a transmitter spikes, the weight of each of
+  its plastic connections decreases by A_minus*w_max*y(receiver); when a receiver spikes, the weight of each of
+  its plastic connections increases by A_plus*w_max*x(transmitter). The weights stay between 0 and w_max.
+  The traces are only kept at the last spike of their neuron and computed at the time they are read, so nothing
+  is done between two spikes, and a spike of a receiver finds its connections through a transposed index of the
+  connections. The work of a spike is then about the work of its delivery. The spikes are taken at their time
+  (without the delay of the connections), and the spikes of a step are treated together: the weights change with
+  the traces of before the step, then the traces take the spikes of the step, so the result doesn't depend on the
+  order of the neurons (two spikes in the same step don't change the weight between them).
+*/
+class Stdp {
+	public:
+	///CONSTRUCTOR (no plastic connections)
+	Stdp();
+
+	///CONSTRUCTOR
+	/**
+      \param network contains the connections (they must not change while the plasticity is used).
+      \param first_transmitter and end_transmitter are the range of the transmitters of the plastic connections.
+      \param first_receiver and end_receiver are the range of the receivers of the plastic connections.
+      \param weight is the initial weight of the connections in number of J, multiplied by the weight of each connection in the network.
+      \param dt is the time step (ms).
+      \param parameters are the parameters of the plasticity.
+    */
+	Stdp(std::shared_ptr<const Connectivity> network, unsigned long first_transmitter, unsigned long end_transmitter, unsigned long first_receiver, unsigned long end_receiver, double weight, double dt, const StdpParameters& parameters);
+
+		//getters
+	///says if there are plastic connections.
+	bool is_enabled() const;
+
+	///getter for the parameters.
+	const StdpParameters& get_parameters() const;
+
+	///getter for the weights of the connections of a transmitter.
+	/**
+      \param transmitter_neuron is the index of the transmitter neuron.
+      \return the weight of each of its connections (number of J) in the order of its receivers in the network (those which are not in the range of the receivers are not used), a null pointer if it is not a transmitter of plastic connections.
+    */
+	const float* get_weights(unsigned long transmitter_neuron) const;
+
+	///getter for the weight of a plastic connection.
+	/**
+      \param transmitter_neuron is the index of the transmitter neuron.
+      \param receiver_neuron is the index of the receiver neuron.
+      \return the weight (number of J) of the first connection between them, 0 if there is none.
+    */
+	double get_weight(unsigned long transmitter_neuron, unsigned long receiver_neuron) const;
+
+	///getter for the mean weight of the plastic connections (number of J).
+	double get_mean_weight() const;
+
+		//update
+	///changes the weights with the spikes of a step, then adds them to the traces.
+	/**
+      \param neuron_indexes contains the neurons which spiked during the step (in any order).
+      \param T is the time of the step (in number of steps).
+    */
+	void spikes(const std::vector<unsigned long>& neuron_indexes, unsigned long T);
+
+		//files
+	///writes the weights and the traces in a binary stream.
+	void save(std::ostream& out) const;
+
+	///reads the weights and the traces written by save().
+	/**
+      \return true if they could be read and have the same number of connections and neurons.
+    */
+	bool load(std::istream& in);
+
+	///DESTRUCTOR
+	~Stdp();
+
+	private:
+	///depresses the plastic connections of a transmitter which spikes (nothing if it is not a transmitter).
+	void depress(unsigned long neuron_index, unsigned long T);
+
+	///potentiates the plastic connections of a receiver which spikes (nothing if it is not a receiver).
+	void potentiate(unsigned long neuron_index, unsigned long T);
+
+	///adds a spike to the traces of a neuron.
+	void add_spike(unsigned long neuron_index, unsigned long T);
+
+	///the trace of a neuron at its last spike (both are read together).
+	struct Trace {
+		double value; /**< value of the trace just after the last spike */
+		unsigned long last_spike; /**< time of the last spike */
+	};
+
+	///value of a trace at a time.
+	/**
+      \param trace is the trace at the last spike.
+      \param T is the time (in number of steps, not before the last spike).
+      \param decays contains the decay of the trace during the first steps.
+      \param TAU is the time constant of the trace (ms).
+    */
+	double value(const Trace& trace, unsigned long T, const std::vector<double>& decays, double TAU) const;
+
+		//Parameters
+	StdpParameters parameters_; /**< parameters of the plasticity */
+	double dt_; /**< time step (ms) */
+	unsigned long first_transmitter_; /**< first transmitter of the plastic connections */
+	unsigned long end_transmitter_; /**< index after the last transmitter */
+	unsigned long first_receiver_; /**< first receiver of the plastic connections */
+	unsigned long end_receiver_; /**< index after the last receiver */
+	std::vector<double> decays_plus_; /**< decay of the traces of the transmitters during k steps for the small k */
+	std::vector<double> decays_minus_; /**< decay of the traces of the receivers during k steps for the small k */
+
+		//Connections
+	std::shared_ptr<const Connectivity> network_; /**< connections */
+	unsigned long first_connection_; /**< index of the first connection of the first transmitter */
+	std::vector<float> weights_; /**< weights of the connections of the transmitters (number of J), from first_connection_ */
+	std::vector<std::uint64_t> incoming_offsets_; /**< transposed index: the plastic connections received by the receiver j are incoming_connections_[incoming_offsets_[j-first_receiver_]] to [incoming_offsets_[j-first_receiver_+1]-1] */
+	std::vector<std::uint32_t> incoming_connections_; /**< index in weights_ of each connection received */
+	std::vector<std::uint32_t> incoming_transmitters_; /**< transmitter of each connection received */
+
+		//Traces
+	std::vector<Trace> transmitter_traces_; /**< traces of the transmitters */
+	std::vector<Trace> receiver_traces_; /**< traces of the receivers */
+};
+
+#endif
@@ -0,0 +1,419 @@
+#include "sweep.h"
+#include "population_analyzer.h"
+#include "spike_statistics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+
+//-----------------------------CONSTRUCTOR----------------------------//
+Sweep::Sweep(const SweepSettings& settings)
+: settings_(settings)
+{}
+
+//-------------------------------GETTERS------------------------------//
+const SweepSettings& Sweep::get_settings() const
+{
+	return settings_;
+}
+
+const std::vector<SweepPoint>& Sweep::get_points() const
+{
+	return points_;
+}
+
+const std::vector<SweepResult>& Sweep::get_results() const
+{
+	return results_;
+}
+
+//-----------------------------DESCRIPTION----------------------------//
+bool Sweep::read(std::istream& in, std::ostream& errors)
+{
+	bool good(true);
+	std::string line;
+	unsigned int line_number(0);
+	while (std::getline(in, line)) {
+		++line_number;
+		line = line.substr(0, line.find('#'));
+		std::istringstream words(line);
+		std::string command;
+		if (not (words >> command)) {
+			continue;
+		}
+
+		bool valid(false);
+		if (command == "NE") {
+			valid = static_cast<bool>(words >> settings_.NE);
+		} else if (command == "NI") {
+			valid = static_cast<bool>(words >> settings_.NI);
+		} else if (command == "dt") {
+			valid = (words >> settings_.dt) and settings_.dt > 0.0;
+		} else if (command == "t_stop") {
+			valid = (words >> settings_.t_stop) and settings_.t_stop >= 0.0;
+		} else if (command == "transient") {
+			valid = (words >> settings_.transient) and settings_.transient >= 0.0;
+		} else if (command == "threads") {
+			valid = static_cast<bool>(words >> settings_.threads);
+		} else if (command == "output") {
+			valid = static_cast<bool>(words >> settings_.output_directory);
+		} else if (command == "cache") {
+			valid = static_cast<bool>(words >> settings_.cache_directory);
+		} else if (command == "spikes" or command == "early_stopping") {
+			std::string answer;
+			valid = (words >> answer) and (answer == "yes" or answer == "no");
+			(command == "spikes" ? settings_.write_spikes : settings_.early_stopping) = (answer == "yes");
+		} else if (command == "noise") {
+			std::string answer;
+			valid = (words >> answer) and (answer == "poisson" or answer == "gaussian");
+			settings_.noise = (answer == "gaussian" ? GAUSSIAN_NOISE : POISSON_NOISE);
+		} else if (command == "continuation") {
+			std::string answer;
+			valid = (words >> answer) and (answer == "yes" or answer == "no");
+			settings_.continuation = (answer == "yes");
+			double transient;
+			if (words >> transient) {
+				valid = valid and transient >= 0.0;
+				settings_.continuation_transient = transient;
+			}
+		} else if (command == "skip_predicted") {
+			valid = true;
+			settings_.skipped_regimes.clear();
+			std::string name;
+			while (words >> name) {
+				Regime regime;
+				valid = valid and regime_from_name(name, regime);
+				settings_.skipped_regimes.push_back(regime);
+			}
+		} else if (command == "point") {
+			double g, ETA;
+			unsigned int seed(1);
+			valid = (words >> g >> ETA) and g > 0.0 and ETA >= 0.0;
+			words >> seed;
+			if (valid) {
+				add_point(g, ETA, seed);
+			}
+		} else if (command == "grid") {
+			double g_min, g_max, ETA_min, ETA_max;
+			unsigned int nb_g, nb_ETA, seed(1);
+			valid = (words >> g_min >> g_max >> nb_g >> ETA_min >> ETA_max >> nb_ETA) and g_min > 0.0 and ETA_min >= 0.0;
+			words >> seed;
+			if (valid) {
+				add_grid(g_min, g_max, nb_g, ETA_min, ETA_max, nb_ETA, seed);
+			}
+		} else if (command == "adaptive") {
+			double g_min, g_max, ETA_min, ETA_max;
+			unsigned int nb_g, nb_ETA, levels, seed(1);
+			valid = (words >> g_min >> g_max >> nb_g >> ETA_min >> ETA_max >> nb_ETA >> levels) and g_min > 0.0 and ETA_min >= 0.0 and nb_g >= 2 and nb_ETA >= 2 and levels < 16;
+			words >> seed;
+			if (valid) {
+				add_adaptive_grid(g_min, g_max, nb_g, ETA_min, ETA_max, nb_ETA, levels, seed);
+			}
+		}
+
+		if (not valid) {
+			errors << "Sweep description, line " << line_number << " can not be read: " << line << std::endl;
+			good = false;
+		}
+	}
+	return good;
+}
+
+bool Sweep::read_file(const std::string& file_name)
+{
+	std::ifstream file(file_name);
+	if (not file.is_open()) {
+		std::cerr << "The sweep description " << file_name << " can not be opened." << std::endl;
+		return false;
+	}
+	return read(file);
+}
+
+void Sweep::add_point(double g, double ETA, unsigned int seed)
+{
+	points_.push_back({g, ETA, seed, 0.0, 0.0});
+}
+
+void Sweep::add_grid(double g_min, double g_max, unsigned int nb_g, double ETA_min, double ETA_max, unsigned int nb_ETA, unsigned int seed)
+{
+	const double g_step(nb_g > 1 ? (g_max-g_min)/(nb_g-1) : 0.0), ETA_step(nb_ETA > 1 ? (ETA_max-ETA_min)/(nb_ETA-1) : 0.0);
+	for (unsigned int i(0) ; i<nb_g ; ++i) {
+		double g(nb_g > 1 ? g_min + i*(g_max-g_min)/(nb_g-1) : g_min);
+		for (unsigned int j(0) ; j<nb_ETA ; ++j) {
+			double ETA(nb_ETA > 1 ? ETA_min + j*(ETA_max-ETA_min)/(nb_ETA-1) : ETA_min);
+			points_.push_back({g, ETA, seed, g_step, ETA_step});
+		}
+	}
+}
+
+void Sweep::add_adaptive_grid(double g_min, double g_max, unsigned int nb_g, double ETA_min, double ETA_max, unsigned int nb_ETA, unsigned int levels, unsigned int seed)
+{
+	if (nb_g < 2 or nb_ETA < 2) {
+		add_grid(g_min, g_max, nb_g, ETA_min, ETA_max, nb_ETA, seed);
+		return;
+	}
+
+	const unsigned long coarse_step(1ul << levels);
+	AdaptiveGrid grid;
+	grid.g_min = g_min;
+	grid.g_step = (g_max-g_min) / ((nb_g-1)*coarse_step);
+	grid.ETA_min = ETA_min;
+	grid.ETA_step = (ETA_max-ETA_min) / ((nb_ETA-1)*coarse_step);
+	grid.cell_size = coarse_step;
+	grid.seed = seed;
+
+	//the first grid is added in the same order as add_grid() (lines of ETA for each g)
+	for (unsigned long i(0) ; i<nb_g ; ++i) {
+		for (unsigned long j(0) ; j<nb_ETA ; ++j) {
+			adaptive_point(grid, i*coarse_step, j*coarse_step, coarse_step);
+			if (i+1<nb_g and j+1<nb_ETA) {
+				grid.cells.push_back({i*coarse_step, j*coarse_step});
+			}
+		}
+	}
+	adaptive_grids_.push_back(grid);
+}
+
+unsigned long Sweep::adaptive_point(AdaptiveGrid& grid, unsigned long x, unsigned long y, unsigned long spacing)
+{
+	auto position(grid.points.find({x, y}));
+	if (position != grid.points.end()) {
+		return position->second;
+	}
+	points_.push_back({grid.g_min + x*grid.g_step, grid.ETA_min + y*grid.ETA_step, grid.seed, spacing*grid.g_step, spacing*grid.ETA_step});
+	grid.points[{x, y}] = points_.size()-1;
+	return points_.size()-1;
+}
+
+bool Sweep::refine()
+{
+	const unsigned long nb_points(points_.size());
+	for (auto& grid : adaptive_grids_) {
+		if (grid.cell_size < 2) {
+			grid.cells.clear();
+			continue;
+		}
+
+		const unsigned long size(grid.cell_size), half(size/2);
+		std::vector<std::pair<unsigned long, unsigned long>> cells;
+		for (const auto& cell : grid.cells) {
+			const unsigned long x(cell.first), y(cell.second);
+			const Regime regime(results_[grid.points.at({x, y})].regime);
+			if (results_[grid.points.at({x+size, y})].regime == regime
+				and results_[grid.points.at({x, y+size})].regime == regime
+				and results_[grid.points.at({x+size, y+size})].regime == regime) {
+				continue;
+			}
+
+			//the cell crosses a boundary: its 4 quarters are checked at the next refinement
+			//(the new points are half a cell apart: the points of other cells, maybe across the boundary, are not their neighbours)
+			for (unsigned long dx(0) ; dx<=size ; dx += half) {
+				for (unsigned long dy(0) ; dy<=size ; dy += half) {
+					adaptive_point(grid, x+dx, y+dy, half);
+				}
+			}
+			cells.push_back({x, y});
+			cells.push_back({x+half, y});
+			cells.push_back({x, y+half});
+			cells.push_back({x+half, y+half});
+		}
+		grid.cells.swap(cells);
+		grid.cell_size = half;
+	}
+	return points_.size() > nb_points;
+}
+
+//---------------------------------RUN--------------------------------//
+void Sweep::run(std::ostream& log)
+{
+	mkdir(settings_.output_directory.c_str(), 0755);
+
+	//one copy of the connections for each seed, shared by the simulations (the points added by the refinements use the seeds of their grids)
+	std::map<unsigned int, std::shared_ptr<Connectivity>> networks;
+	for (const auto& point : points_) {
+		if (networks.count(point.seed) == 0) {
+			if (settings_.cache_directory.empty()) {
+				networks[point.seed] = Connectivity::random(settings_.NE, settings_.NI, settings_.NE/10, settings_.NI/10, point.seed);
+			} else {
+				networks[point.seed] = Connectivity::cached_random(settings_.NE, settings_.NI, settings_.NE/10, settings_.NI/10, point.seed, settings_.cache_directory);
+			}
+		}
+	}
+
+	results_.clear();
+	run_new_points(networks, log);
+	while (refine()) {
+		log << "Refinement: " << points_.size() - results_.size() << " new points" << std::endl;
+		run_new_points(networks, log);
+	}
+
+	save_summary(settings_.output_directory + "/sweep_summary.txt");
+}
+
+void Sweep::run_new_points(const std::map<unsigned int, std::shared_ptr<Connectivity>>& networks, std::ostream& log)
+{
+	const unsigned long first_point(results_.size());
+	unsigned int nb_threads(settings_.threads > 0 ? settings_.threads : std::thread::hardware_concurrency());
+	nb_threads = std::max(1u, nb_threads);
+
+	//beginning of each chain of points simulated one after the other (every point is a chain without continuation),
+	//the chains are not longer than the share of a thread so that every thread has work
+	const unsigned long max_length((points_.size() - first_point + nb_threads - 1) / nb_threads);
+	std::vector<unsigned long> chains;
+	for (unsigned long index(first_point) ; index<points_.size() ; ++index) {
+		if (not settings_.continuation or index == first_point or index - chains.back() >= max_length or not are_neighbours(points_[index-1], points_[index])) {
+			chains.push_back(index);
+		}
+	}
+	chains.push_back(points_.size());
+
+	results_.resize(points_.size());
+	std::atomic<unsigned long> next_chain(0);
+	std::mutex log_mutex;
+
+	//each thread takes the next chain which has not been simulated yet
+	auto worker = [&]() {
+		for (unsigned long chain(next_chain++) ; chain+1<chains.size() ; chain = next_chain++) {
+			std::unique_ptr<Simulation> simulation;
+			for (unsigned long index(chains[chain]) ; index<chains[chain+1] ; ++index) {
+				results_[index] = run_point(index, networks.at(points_[index].seed), simulation);
+
+				std::lock_guard<std::mutex> lock(log_mutex);
+				log << "Run " << index << ": g = " << points_[index].g << ", ETA = " << points_[index].ETA << ", rate = " << results_[index].excitatory_rate << " Hz, regime " << regime_name(results_[index].regime) << std::endl;
+			}
+		}
+	};
+
+	nb_threads = std::max(1u, std::min<unsigned int>(nb_threads, chains.size()-1));
+	std::vector<std::thread> threads;
+	for (unsigned int t(1) ; t<nb_threads ; ++t) {
+		threads.push_back(std::thread(worker));
+	}
+	worker();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+bool Sweep::are_neighbours(const SweepPoint& first, const SweepPoint& second)
+{
+	//the coordinates of the points of a grid are computed, so the distance is compared with a margin
+	const double margin(1.0 + 1e-9);
+	return first.seed == second.seed
+		and ((first.g == second.g and second.ETA_step > 0.0 and std::abs(second.ETA - first.ETA) <= margin*second.ETA_step)
+			or (first.ETA == second.ETA and second.g_step > 0.0 and std::abs(second.g - first.g) <= margin*second.g_step));
+}
+
+SweepResult Sweep::run_point(unsigned long index, std::shared_ptr<Connectivity> network, std::unique_ptr<Simulation>& simulation) const
+{
+	const SweepPoint& point(points_[index]);
+	const std::string prefix(settings_.output_directory + "/run_" + std::to_string(index));
+
+	//the prediction takes less than a millisecond, the points in the regimes which are not interesting are not simulated
+	const MeanFieldPrediction prediction(Simulation::mean_field(settings_.NE, settings_.NI).predict(point.g, point.ETA));
+	if (std::find(settings_.skipped_regimes.begin(), settings_.skipped_regimes.end(), prediction.regime) != settings_.skipped_regimes.end()) {
+		SweepResult result;
+		result.point = point;
+		result.excitatory_rate = prediction.rate;
+		result.inhibitory_rate = prediction.rate;
+		result.cv = prediction.cv;
+		result.fano_factor = 0.0;
+		result.correlation = 0.0;
+		result.peak_frequency = 0.0;
+		result.peak_ratio = 0.0;
+		result.regime = prediction.regime;
+		result.simulated_time = 0.0;
+		result.continued = false;
+		result.predicted_rate = prediction.rate;
+		result.predicted_regime = prediction.regime;
+		result.simulated = false;
+
+		//the chain of continuation is broken
+		simulation.reset();
+		return result;
+	}
+
+	std::unique_ptr<Simulation> sim(new Simulation(network, settings_.NE, settings_.dt, settings_.t_stop, point.g, point.ETA));
+	sim->set_noise_seed(point.seed);
+	sim->set_background_noise(settings_.noise);
+
+	//warm start: the network of the previous point is already equilibrated, so the transient is shorter
+	const bool continued(simulation != nullptr and sim->continue_from(*simulation));
+	simulation.reset();
+	double transient(settings_.transient);
+	StoppingCriteria criteria(settings_.criteria);
+	if (continued) {
+		transient = std::min(transient, settings_.continuation_transient);
+		criteria.transient = std::min(criteria.transient, settings_.continuation_transient);
+	}
+	const unsigned long first_step(sim->get_clock());
+
+	//without spikes file, the stream is never opened and nothing is written
+	std::ofstream spikes;
+	if (settings_.write_spikes) {
+		spikes.open(prefix + "_spikes.txt");
+	}
+
+	//the transient is simulated before the recorders are attached
+	sim->set_remaining_time(transient);
+	sim->run(spikes);
+
+	//the convergence monitor starts with the recorders, so that it can't stop the simulation during the transient
+	PopulationAnalyzer analyzer(settings_.NE, settings_.NI, settings_.dt);
+	SpikeStatistics statistics(settings_.NE + settings_.NI, settings_.dt);
+	sim->attach_recorder(&analyzer);
+	sim->attach_recorder(&statistics);
+	if (settings_.early_stopping) {
+		sim->enable_early_stopping(criteria);
+	}
+	sim->set_remaining_time(settings_.t_stop);
+	sim->run(spikes);
+	sim->detach_recorder(&analyzer);
+	sim->detach_recorder(&statistics);
+	analyzer.save(prefix + "_population.txt");
+
+	SweepResult result;
+	result.point = point;
+	result.excitatory_rate = analyzer.get_mean_rate(true);
+	result.inhibitory_rate = analyzer.get_mean_rate(false);
+	result.cv = statistics.get_mean_cv();
+	result.fano_factor = statistics.get_mean_fano_factor();
+	result.correlation = statistics.get_mean_correlation();
+	result.peak_frequency = analyzer.get_peak_frequency(true);
+	result.peak_ratio = analyzer.get_peak_ratio(true);
+	result.regime = classify_regime(statistics.get_mean_rate(), result.cv, result.correlation);
+	result.simulated_time = (sim->get_clock() - first_step) * settings_.dt;
+	result.continued = continued;
+	result.predicted_rate = prediction.rate;
+	result.predicted_regime = prediction.regime;
+	result.simulated = true;
+
+	//the last state is kept for the next point of the chain
+	if (settings_.continuation) {
+		simulation = std::move(sim);
+	}
+	return result;
+}
+
+bool Sweep::save_summary(const std::string& file_name) const
+{
+	std::ofstream file(file_name);
+	if (not file.is_open()) {
+		return false;
+	}
+	file << "# run\tg\tETA\tseed\trate E (Hz)\trate I (Hz)\tCV\tFano\tcorrelation\tpeak (Hz)\tpeak ratio\tregime\ttime (ms)\tcontinued\tpredicted rate (Hz)\tpredicted regime\tsimulated\n";
+	for (unsigned long k(0) ; k<results_.size() ; ++k) {
+		const SweepResult& result(results_[k]);
+		file << k << '\t' << result.point.g << '\t' << result.point.ETA << '\t' << result.point.seed << '\t'
+			<< result.excitatory_rate << '\t' << result.inhibitory_rate << '\t' << result.cv << '\t' << result.fano_factor << '\t'
+			<< result.correlation << '\t' << result.peak_frequency << '\t' << result.peak_ratio << '\t'
+			<< regime_name(result.regime) << '\t' << result.simulated_time << '\t' << (result.continued ? "yes" : "no") << '\t'
+			<< result.predicted_rate << '\t' << regime_name(result.predicted_regime) << '\t' << (result.simulated ? "yes" : "no") << '\n';
+	}
+	return file.good();
+}
@@ -0,0 +1,198 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "connectivity.h"
+#include "convergence_monitor.h"
+#include "regime.h"
+#include "simulation.h"
+
+///parameters shared by all the simulations of a sweep.
+struct SweepSettings {
+	unsigned long NE = 10000; /**< number of excitatory neurons */
+	unsigned long NI = 2500; /**< number of inhibitory neurons */
+	double dt = 0.1; /**< time step (ms) */
+	double t_stop = 1000.0; /**< time analyzed in each simulation, after the transient (ms) */
+	double transient = 0.0; /**< time simulated at the beginning of each simulation before the statistics start (ms) */
+	unsigned int threads = 0; /**< number of simulations run at the same time (0 for one per core) */
+	std::string output_directory = "."; /**< directory of the output files */
+	std::string cache_directory = ""; /**< directory of the connections cache (no cache if empty) */
+	bool write_spikes = false; /**< says if the spikes of each simulation are written */
+	bool early_stopping = false; /**< says if the simulations stop when their statistics have converged */
+	BackgroundNoise noise = POISSON_NOISE; /**< kind of background noise of the simulations */
+	bool continuation = false; /**< says if each point starts from the last state of the previous one when they are neighbours */
+	double continuation_transient = 20.0; /**< transient of the points which start from the state of the previous one (ms, at most transient) */
+	StoppingCriteria criteria; /**< parameters of the early termination (its monitoring starts after the transient) */
+	std::vector<Regime> skipped_regimes; /**< the points whose predicted regime is one of them are not simulated */
+};
+
+///a point of the sweep.
+struct SweepPoint {
+	double g; /**< positive ratio of JI/JE */
+	double ETA; /**< ratio v_ext/v_thr */
+	unsigned int seed; /**< seed of the connections and of the background noise */
+	double g_step; /**< distance along g to the next point of its grid (0 if it is not on a grid) */
+	double ETA_step; /**< distance along ETA to the next point of its grid (0 if it is not on a grid) */
+};
+
+///the statistics of one simulation of the sweep.
+struct SweepResult {
+	SweepPoint point; /**< parameters of the simulation */
+	double excitatory_rate; /**< mean rate of the excitatory neurons (Hz) */
+	double inhibitory_rate; /**< mean rate of the inhibitory neurons (Hz) */
+	double cv; /**< mean CV of the interspike intervals */
+	double fano_factor; /**< mean Fano factor of the spike counts */
+	double correlation; /**< mean correlation between pairs of neurons */
+	double peak_frequency; /**< frequency of the peak of the excitatory spectrum (Hz) */
+	double peak_ratio; /**< height of the peak of the excitatory spectrum compared to its mean */
+	Regime regime; /**< regime of the network */
+	double simulated_time; /**< time simulated (ms) with the transient, shorter than transient+t_stop if the simulation stopped early */
+	bool continued; /**< says if the simulation started from the last state of the previous point */
+	double predicted_rate; /**< stationary rate predicted by the mean-field theory (Hz) */
+	Regime predicted_regime; /**< regime predicted by the mean-field theory */
+	bool simulated; /**< says if the point was simulated (otherwise the statistics are the prediction) */
+};
+
+///runs many simulations with different (g, ETA) on a pool of threads.
+/**
+  The sweep is described by a text file, one command per line ('#' starts a comment):
+  - "NE n", "NI n", "dt x", "t_stop x", "transient x", "threads n": parameters of the simulations,
+  - "output directory", "cache directory": directories of the outputs and of the connections cache,
+  - "spikes yes|no", "early_stopping yes|no", "noise poisson|gaussian": options of the simulations,
+  - "continuation yes|no [transient]": warm start of each point from the last state of the previous one,
+  - "skip_predicted [Q] [SR] [SI] [AI]": the points whose regime predicted by the mean-field theory is one
+    of these are not simulated, their statistics are the predicted ones (the prediction of every point is in the summary),
+  - "point g ETA [seed]": adds a point,
+  - "grid g_min g_max nb_g ETA_min ETA_max nb_ETA [seed]": adds a regular grid of points,
+  - "adaptive g_min g_max nb_g ETA_min ETA_max nb_ETA levels [seed]": adds a grid refined where the regimes change.
+  The simulations with the same seed share one read-only copy of the connections.
+  With the continuation, the points are cut in chains of neighbours (consecutive points of a grid with the same seed,
+  one step of the grid apart along g or along ETA): the points of a chain are simulated one after the other,
+  each one starting from the equilibrated network of the previous one with a shorter transient, and the chains
+  are shared between the threads (they are cut so that there are at least as many chains as threads).
+  The points added one by one are not on a grid, so they always start from a new network.
+  An adaptive grid starts as a regular grid. Each cell whose corners are not all in the same regime is cut in
+  4 cells (5 new points), up to "levels" times, so the boundaries between the regimes are found with the
+  resolution of a grid 2^levels times finer while the points far from them are not simulated. The new points
+  of each level are run together on the pool of threads.
+  Each simulation i writes "run_i_population.txt" (and "run_i_spikes.txt" if the spikes are written) in the output directory,
+  and the statistics of every simulation are written in "sweep_summary.txt".
+*/
+class Sweep {
+	public:
+	///CONSTRUCTOR
+	/**
+      \param settings contains the parameters shared by the simulations.
+    */
+	Sweep(const SweepSettings& settings = SweepSettings());
+
+		//getters
+	///getter for the parameters of the simulations.
+	const SweepSettings& get_settings() const;
+
+	///getter for the points of the sweep.
+	const std::vector<SweepPoint>& get_points() const;
+
+	///getter for the results (in the same order as the points, empty before run()).
+	const std::vector<SweepResult>& get_results() const;
+
+		//description
+	///reads the description of a sweep.
+	/**
+      \param in is the stream containing the description.
+      \param errors is the stream where the wrong lines are reported.
+      \return true if every line could be read.
+    */
+	bool read(std::istream& in, std::ostream& errors = std::cerr);
+
+	///reads the description of a sweep in a file.
+	/**
+      \param file_name is the name of the file.
+      \return true if the file could be opened and every line could be read.
+    */
+	bool read_file(const std::string& file_name);
+
+	///adds a point to the sweep.
+	void add_point(double g, double ETA, unsigned int seed = 1);
+
+	///adds a regular grid of nb_g x nb_ETA points (the bounds are included).
+	void add_grid(double g_min, double g_max, unsigned int nb_g, double ETA_min, double ETA_max, unsigned int nb_ETA, unsigned int seed = 1);
+
+	///adds a grid of nb_g x nb_ETA points (at least 2 x 2) whose cells are refined by run() where the regimes of their corners disagree.
+	/**
+      \param levels is the number of refinements (each one halves the size of the cells).
+    */
+	void add_adaptive_grid(double g_min, double g_max, unsigned int nb_g, double ETA_min, double ETA_max, unsigned int nb_ETA, unsigned int levels, unsigned int seed = 1);
+
+		//run
+	///runs every simulation and writes the summary.
+	/**
+      \param log is the stream where the progress is written.
+    */
+	void run(std::ostream& log = std::cout);
+
+	///writes the statistics of every simulation.
+	/**
+      \param file_name is the name of the file.
+      \return true if the file could be written.
+    */
+	bool save_summary(const std::string& file_name) const;
+
+	private:
+	///a grid refined where the regimes of its points disagree.
+	struct AdaptiveGrid {
+		double g_min; /**< smallest g */
+		double g_step; /**< distance between two points of the finest grid along g */
+		double ETA_min; /**< smallest ETA */
+		double ETA_step; /**< distance between two points of the finest grid along ETA */
+		unsigned long cell_size; /**< size of the cells to check at the next refinement, in points of the finest grid (2^levels at first) */
+		std::vector<std::pair<unsigned long, unsigned long>> cells; /**< lower corners of the cells to check at the next refinement */
+		std::map<std::pair<unsigned long, unsigned long>, unsigned long> points; /**< index of the point at each position of the finest grid */
+		unsigned int seed; /**< seed of the points */
+	};
+
+	///gives the index of a point of an adaptive grid, the point is added to the sweep if it is new.
+	/**
+      \param grid is the adaptive grid.
+      \param x is the position of the point along g in the finest grid.
+      \param y is the position of the point along ETA in the finest grid.
+      \param spacing is the distance between the points of its level, in points of the finest grid (a new point is only chained to the points this close).
+      \return the index of the point.
+    */
+	unsigned long adaptive_point(AdaptiveGrid& grid, unsigned long x, unsigned long y, unsigned long spacing);
+
+	///cuts the cells of the adaptive grids whose corners are not all in the same regime.
+	/**
+      \return true if new points have to be simulated.
+    */
+	bool refine();
+
+	///runs the points which haven't been simulated yet on the pool of threads.
+	/**
+      \param networks contains the connections for each seed.
+      \param log is the stream where the progress is written.
+    */
+	void run_new_points(const std::map<unsigned int, std::shared_ptr<Connectivity>>& networks, std::ostream& log);
+
+	///says if two points are neighbours in a continuation (same seed, and one step of the grid of the second one apart along g or ETA).
+	static bool are_neighbours(const SweepPoint& first, const SweepPoint& second);
+
+	///runs the simulation of a point.
+	/**
+      \param index is the index of the point.
+      \param network contains the connections for the seed of the point.
+      \param simulation contains the simulation of the previous point of the chain (null pointer for the first point), it is replaced by the simulation of this point.
+      \return the statistics of the simulation.
+    */
+	SweepResult run_point(unsigned long index, std::shared_ptr<Connectivity> network, std::unique_ptr<Simulation>& simulation) const;
+
+	SweepSettings settings_; /**< parameters shared by the simulations */
+	std::vector<SweepPoint> points_; /**< points of the sweep */
+	std::vector<SweepResult> results_; /**< statistics of the simulations */
+	std::vector<AdaptiveGrid> adaptive_grids_; /**< grids refined by run() */
+};
+
+#endif
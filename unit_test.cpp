@@ -1,11 +1,110 @@
 #include <iostream>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <stdexcept>
 #include "neuron.h"
 #include "brain.h"
 #include "simulation.h"
+#include "spike_recorder.h"
+#include "multimeter.h"
+#include "population_analyzer.h"
+#include "spike_statistics.h"
+#include "regime.h"
+#include "connectivity.h"
+#include "sweep.h"
+#include "ensemble.h"
+#include "mean_field.h"
+#include "population_density.h"
+#include "gaussian_noise.h"
+#include "event_driven_brain.h"
+#include "fast_brain.h"
+#include "generated_models.h"
+#include "short_term_plasticity.h"
+#include "stdp.h"
 #include "gtest/gtest.h"
 
+namespace {
+
+///the connections of the tests which compare brains (1000 excitatory and 250 inhibitory neurons).
+std::shared_ptr<Connectivity> random_network()
+{
+	return Connectivity::random(1000, 250, 100, 25, 3);
+}
+
+///runs brains with the same background noise.
+void run_brains(const std::vector<Brain*>& brains, unsigned int seed = 5, unsigned long nb_steps = 2000)
+{
+	std::ofstream no_file;
+	for (Brain* brain : brains) {
+		brain->set_noise_seed(seed);
+	}
+	for (unsigned long T(1) ; T<=nb_steps ; ++T) {
+		for (Brain* brain : brains) {
+			brain->update(T, no_file);
+		}
+	}
+}
+
+///number of spikes of the 1250 neurons of a brain.
+unsigned long nb_of_spikes(Brain& brain)
+{
+	unsigned long nb_spikes(0);
+	for (unsigned long i(0) ; i<1250 ; ++i) {
+		nb_spikes += brain.get_neuron(i).get_nb_of_spikes();
+	}
+	return nb_spikes;
+}
+
+///checks that two brains run with run_brains() have the same spikes.
+void expect_same_spikes(Brain& brain, Brain& other)
+{
+	for (unsigned long i(0) ; i<1250 ; ++i) {
+		EXPECT_EQ(brain.get_neuron(i).get_nb_of_spikes(), other.get_neuron(i).get_nb_of_spikes());
+	}
+}
+
+///runs a brain and a fast brain with the same background noise and checks that they have the same spikes and potentials.
+template <class Model>
+void expect_same_spikes(Brain& brain, FastBrain<Model>& fast)
+{
+	std::ofstream no_file;
+	run_brains({&brain});
+	fast.set_noise_seed(5);
+	fast.run(2000, no_file);
+	
+	unsigned long nb_spikes(0);
+	for (unsigned long i(0) ; i<1250 ; ++i) {
+		EXPECT_EQ(brain.get_neuron(i).get_nb_of_spikes(), static_cast<int>(fast.get_nb_of_spikes(i)));
+		EXPECT_EQ(brain.get_neuron(i).get_membrane_potential(), fast.get_membrane_potential(i));
+		nb_spikes += fast.get_nb_of_spikes(i);
+	}
+	EXPECT_GT(nb_spikes, 1250u);
+}
+
+///checks that the state of a brain is only loaded by a brain which has the same plasticity.
+/**
+  \param enable enables the plasticity of the restored brain, which can't load the state before.
+*/
+template <class Enable>
+void expect_restored(Brain& brain, Brain& restored, Enable enable)
+{
+	std::stringstream state;
+	brain.save(state);
+	EXPECT_FALSE(restored.load(state));
+	state.seekg(0);
+	enable(restored);
+	ASSERT_TRUE(restored.load(state));
+}
+
+}
+
 TEST (NeuronTest, MembranePotential){
-	Neuron neuron(true, 0.1);
+	Neuron neuron(std::make_shared<NeuronParameters>());
 	neuron.set_Iext(1);
 	
 	neuron.update(1, 0);
@@ -13,7 +112,7 @@ TEST (NeuronTest, MembranePotential){
 }
 
 TEST (NeuronTest, SpikeTimes) {
-	Neuron neuron(true, 0.1);
+	Neuron neuron(std::make_shared<NeuronParameters>());
 	neuron.set_Iext(1.01);
 	
 	for (unsigned long i(1); i<924 ; ++i) {
@@ -32,6 +131,25 @@ TEST (NeuronTest, SpikeTimes) {
 	
 	neuron.update(924+943, 0);
 	EXPECT_EQ(2, neuron.get_nb_of_spikes());
+	EXPECT_EQ(924+943, neuron.get_last_spike_time());
+}
+
+TEST (NeuronTest, RefractoryPeriod) {
+	Neuron neuron(std::make_shared<NeuronParameters>());
+	
+	neuron.update(1, 201);
+	EXPECT_EQ(1, neuron.get_nb_of_spikes());
+	EXPECT_EQ(1, neuron.get_last_spike_time());
+	
+	//the inputs received during the 20 steps of the refractory period are ignored
+	for (unsigned long i(2); i<21 ; ++i) {
+		neuron.update(i, 201);
+		EXPECT_EQ(0.0, neuron.get_membrane_potential());
+	}
+	
+	neuron.update(21, 201);
+	EXPECT_EQ(2, neuron.get_nb_of_spikes());
+	EXPECT_EQ(21, neuron.get_last_spike_time());
 }
 
 TEST (BrainTest, NumberOfNeurons){
@@ -65,6 +183,41 @@ TEST (BrainTest, InhibitorySignal){
 	EXPECT_EQ(-5, (brain.get_neuron(0)).get_nb_of_signals(15));
 }
 
+TEST (BrainTest, Populations){
+	//two populations share their parameters, the third one has its own
+	std::shared_ptr<NeuronParameters> parameters(std::make_shared<NeuronParameters>());
+	std::shared_ptr<NeuronParameters> other_parameters(std::make_shared<NeuronParameters>());
+	other_parameters->Vthr = 10.0;
+	std::vector<Population> populations({{2, parameters}, {1, parameters}, {1, other_parameters}});
+	std::vector<Projection> projections({{0, 1, 2.0, 3}, {2, 0, 3.0, 7}});
+	
+	std::shared_ptr<Connectivity> network(std::make_shared<Connectivity>(4));
+	network->add(0, 2);
+	network->add(3, 1);
+	network->add(2, 3);
+	Brain brain(network, populations, projections);
+	ASSERT_EQ(4, brain.get_nb_neurons());
+	EXPECT_EQ(2, brain.get_nb_excitatory());
+	EXPECT_EQ(brain.get_populations()[0].parameters, brain.get_populations()[1].parameters);
+	
+	//each signal has the weight and the delay of the projection between the two populations
+	brain.send_signals(0, 0);
+	brain.send_signals(3, 0);
+	brain.send_signals(2, 0);
+	EXPECT_EQ(2, brain.get_neuron(2).get_nb_of_signals(3));
+	EXPECT_EQ(3, brain.get_neuron(1).get_nb_of_signals(7));
+	
+	//there is no projection from the population 1 to the population 2 (which receives nothing, so its buffer has no delay)
+	for (unsigned int i(0) ; i<2 ; ++i) {
+		EXPECT_EQ(0, brain.get_neuron(3).get_nb_of_signals(i));
+	}
+	
+	//the populations must have exactly the neurons of the connections
+	populations.pop_back();
+	EXPECT_THROW(Brain(network, populations, projections), std::invalid_argument);
+	EXPECT_THROW(Brain(network, std::vector<Population>(), projections), std::invalid_argument);
+}
+
 TEST (BrainTest, Connections){
 	Brain brain(10000, 2500, 1000, 250);
 	unsigned long CE(0);
@@ -88,6 +241,1315 @@ TEST (BrainTest, Connections){
 	EXPECT_EQ(250, CI);
 }
 
+TEST (BrainTest, SpikeRecorder){
+	//with a background noise of 1000 J per step, the neurons spike as soon as they are not refractory
+	Brain brain(2, 1, 0, 0, 0.1, 1000.0);
+	SpikeRecorder recorder(100, 0.1, nullptr, 0, 2);
+	brain.attach_recorder(&recorder);
+	
+	std::ostringstream file;
+	for (unsigned long T(1) ; T<=50 ; ++T) {
+		brain.update(T, file);
+	}
+	
+	EXPECT_EQ(3, brain.get_neuron(0).get_nb_of_spikes());
+	EXPECT_EQ(6, recorder.get_nb_recorded());
+	EXPECT_EQ(std::vector<unsigned long>({1, 21, 41}), recorder.get_spike_times(0));
+	EXPECT_EQ(0, recorder.get_spike_times(2).size());
+}
+
+TEST (SpikeRecorderTest, Capacity){
+	SpikeRecorder recorder(3, 0.1, nullptr, 10, 20);
+	
+	for (unsigned long T(1) ; T<=5 ; ++T) {
+		recorder.record_spike(12, T);
+		recorder.record_spike(25, T);
+	}
+	
+	EXPECT_EQ(3, recorder.get_nb_recorded());
+	EXPECT_EQ(2, recorder.get_nb_dropped());
+	EXPECT_EQ(3, recorder.get_spike_times(12).size());
+	EXPECT_EQ(0, recorder.get_spike_times(25).size());
+}
+
+TEST (SpikeRecorderTest, Spill){
+	std::ostringstream spill;
+	{
+		SpikeRecorder recorder(2, 0.5, &spill);
+		for (unsigned long T(1) ; T<=5 ; ++T) {
+			recorder.record_spike(T, T);
+		}
+		
+		EXPECT_EQ(5, recorder.get_nb_recorded());
+		EXPECT_EQ(0, recorder.get_nb_dropped());
+		EXPECT_EQ(1, recorder.get_spike_times(5).size());
+		EXPECT_EQ("0.5\t1\n1\t2\n1.5\t3\n2\t4\n", spill.str());
+	}
+	EXPECT_EQ("0.5\t1\n1\t2\n1.5\t3\n2\t4\n2.5\t5\n", spill.str());
+}
+
+TEST (MultimeterTest, Samples){
+	Brain brain(3, 1);
+	std::vector<unsigned long> neurons({0, 2});
+	std::vector<double> expected;
+	
+	{
+		AsyncWriter writer("multimeter_test.bin");
+		Multimeter multimeter(neurons, 5, 0.1, writer, 3);
+		brain.attach_recorder(&multimeter);
+		
+		std::ostringstream file;
+		for (unsigned long T(1) ; T<=42 ; ++T) {
+			brain.update(T, file);
+			if (T%5 == 0) {
+				expected.push_back(T*0.1);
+				expected.push_back(brain.get_neuron(0).get_membrane_potential());
+				expected.push_back(brain.get_neuron(2).get_membrane_potential());
+			}
+		}
+		EXPECT_EQ(8, multimeter.get_nb_samples());
+	}
+	
+	std::ifstream input("multimeter_test.bin", std::ios::binary);
+	std::uint64_t header[3];
+	input.read(reinterpret_cast<char*>(header), sizeof(header));
+	EXPECT_EQ(2, header[0]);
+	EXPECT_EQ(0, header[1]);
+	EXPECT_EQ(2, header[2]);
+	
+	std::vector<double> samples(expected.size());
+	input.read(reinterpret_cast<char*>(samples.data()), samples.size()*sizeof(double));
+	EXPECT_TRUE(input.good());
+	EXPECT_EQ(expected, samples);
+	EXPECT_EQ(EOF, input.peek());
+	input.close();
+	std::remove("multimeter_test.bin");
+}
+
+TEST (PopulationAnalyzerTest, Oscillation){
+	//bins of 1 ms, blocks of 64 ms
+	PopulationAnalyzer analyzer(10, 5, 0.1, 10, 64);
+	Brain brain(1, 0);
+	
+	//the excitatory activity oscillates with a period of 8 ms (125 Hz), one inhibitory neuron spikes every 10 steps
+	for (unsigned long T(1) ; T<=6400 ; ++T) {
+		if (T%10 == 0) {
+			int nb_spikes(5 + std::round(4*std::cos(2*M_PI*T/80.0)));
+			for (int i(0) ; i<nb_spikes ; ++i) {
+				analyzer.record_spike(i, T);
+			}
+			analyzer.record_spike(12, T);
+		}
+		analyzer.end_of_step(brain, T);
+	}
+	
+	EXPECT_EQ(10, analyzer.get_nb_blocks());
+	EXPECT_NEAR(500.0, analyzer.get_mean_rate(true), 1e-9);
+	EXPECT_NEAR(200.0, analyzer.get_mean_rate(false), 1e-9);
+	
+	EXPECT_EQ(125.0, analyzer.get_peak_frequency(true));
+	EXPECT_GT(analyzer.get_peak_ratio(true), 5.0);
+	
+	//a constant rate has no power
+	for (auto power : analyzer.get_power_spectrum(false)) {
+		EXPECT_NEAR(0.0, power, 1e-9);
+	}
+}
+
+TEST (SpikeStatisticsTest, RegularAndBurstyTrains){
+	//windows of 10 steps, the 4 neurons are sampled in the pairs (0,1) and (2,3)
+	SpikeStatistics statistics(4, 0.1, 10, 2);
+	Brain brain(1, 0);
+	EXPECT_EQ(std::vector<unsigned long>({0, 1, 2, 3}), statistics.get_pairs());
+	
+	for (unsigned long T(1) ; T<=2000 ; ++T) {
+		//regular neuron
+		if (T%10 == 0) {
+			statistics.record_spike(0, T);
+		}
+		//intervals of 15 and 5 steps
+		if (T%20 == 5 or T%20 == 0) {
+			statistics.record_spike(1, T);
+		}
+		//2 synchronous neurons spiking in one window out of two
+		if (T%20 == 1) {
+			statistics.record_spike(2, T);
+			statistics.record_spike(3, T);
+		}
+		statistics.end_of_step(brain, T);
+	}
+	
+	EXPECT_EQ(200, statistics.get_nb_windows());
+	EXPECT_NEAR((200.0+200.0+100.0+100.0) / (4*0.2), statistics.get_mean_rate(), 1e-9);
+	EXPECT_NEAR(0.5/4, statistics.get_mean_cv(), 1e-2);
+	EXPECT_NEAR(0.5/2, statistics.get_mean_fano_factor(), 1e-2);
+	EXPECT_NEAR(1.0, statistics.get_mean_correlation(), 1e-9);
+	
+	statistics.reset();
+	EXPECT_EQ(0, statistics.get_nb_windows());
+	EXPECT_EQ(0.0, statistics.get_mean_rate());
+	EXPECT_EQ(0.0, statistics.get_mean_cv());
+	EXPECT_EQ(0.0, statistics.get_mean_correlation());
+}
+
+TEST (SpikeStatisticsTest, ReservoirSampling){
+	SpikeStatistics statistics(1000, 0.1, 10, 50, 3);
+	std::vector<unsigned long> pairs(statistics.get_pairs());
+	
+	ASSERT_EQ(100, pairs.size());
+	std::sort(pairs.begin(), pairs.end());
+	EXPECT_TRUE(std::unique(pairs.begin(), pairs.end()) == pairs.end());
+	EXPECT_LT(pairs.back(), 1000);
+	EXPECT_GT(pairs.back(), 100);
+}
+
+TEST (RegimeTest, Classification){
+	EXPECT_EQ(QUIESCENT, classify_regime(0.01, 1.0, 0.0));
+	EXPECT_EQ(SYNCHRONOUS_REGULAR, classify_regime(50.0, 0.1, 0.5));
+	EXPECT_EQ(SYNCHRONOUS_IRREGULAR, classify_regime(30.0, 0.9, 0.3));
+	EXPECT_EQ(ASYNCHRONOUS_IRREGULAR, classify_regime(10.0, 0.9, 0.01));
+	EXPECT_EQ("AI", regime_name(ASYNCHRONOUS_IRREGULAR));
+}
+
+TEST (SimulationTest, EarlyStopping){
+	StoppingCriteria criteria;
+	criteria.transient = 50.0;
+	criteria.batch_length = 20.0;
+	criteria.rate_precision = 0.2;
+	criteria.cv_precision = 1.0;
+	criteria.correlation_precision = 1.0;
+	
+	Simulation sim(1000, 250, 0.1, 1000, 5, 2);
+	sim.enable_early_stopping(criteria);
+	std::ofstream file;
+	sim.run(file);
+	
+	const ConvergenceMonitor* monitor(sim.get_convergence_monitor());
+	ASSERT_TRUE(monitor != nullptr);
+	EXPECT_EQ(CONVERGED, monitor->get_stop_reason());
+	EXPECT_GE(monitor->get_nb_batches(), 5);
+	EXPECT_LT(sim.get_clock(), 10000);
+	EXPECT_EQ(500 + monitor->get_nb_batches()*200, sim.get_clock());
+	EXPECT_LE(monitor->get_rate_error(), 0.2*monitor->get_rate());
+	EXPECT_GT(monitor->get_rate(), 0.0);
+}
+
+TEST (ConvergenceMonitorTest, PoissonTrains){
+	//independent Poisson trains at 20 Hz: about one spike per neuron in each batch of 50 ms, a CV of 1 and no correlation
+	StoppingCriteria criteria;
+	criteria.transient = 0.0;
+	criteria.batch_length = 50.0;
+	criteria.rate_precision = 0.0;
+	ConvergenceMonitor monitor(1000, 0.1, criteria);
+	Brain brain(1, 0);
+	std::mt19937 generator(7);
+	std::bernoulli_distribution spike(20.0*0.1e-3);
+	double early_cv_error(0.0);
+	for (unsigned long T(1) ; T<=20000 ; ++T) {
+		for (unsigned long i(0) ; i<1000 ; ++i) {
+			if (spike(generator)) {
+				monitor.record_spike(i, T);
+			}
+		}
+		monitor.end_of_step(brain, T);
+		if (T == 5000) {
+			early_cv_error = monitor.get_cv_error();
+		}
+	}
+	
+	EXPECT_EQ(40, monitor.get_nb_batches());
+	EXPECT_NEAR(20.0, monitor.get_rate(), 1.0);
+	EXPECT_NEAR(1.0, monitor.get_cv(), 0.1);
+	
+	//the CV of a neuron with 40 intervals varies by about 1/sqrt(40) around 1, the CVs of the 1000 neurons are independent
+	EXPECT_NEAR(1.96*std::sqrt(1.0/40.0)/std::sqrt(1000.0), monitor.get_cv_error(), 0.003);
+	EXPECT_GT(early_cv_error, 1.3*monitor.get_cv_error());
+	EXPECT_EQ(ASYNCHRONOUS_IRREGULAR, monitor.get_regime());
+}
+
+TEST (SimulationTest, NoEarlyStopping){
+	StoppingCriteria criteria;
+	criteria.rate_precision = 0.0;
+	criteria.cv_precision = 0.0;
+	criteria.correlation_precision = 0.0;
+	
+	Simulation sim(1000, 250, 0.1, 400, 5, 2);
+	sim.enable_early_stopping(criteria);
+	std::ofstream file;
+	sim.run(file);
+	
+	EXPECT_EQ(TIME_REACHED, sim.get_convergence_monitor()->get_stop_reason());
+	EXPECT_EQ(4000, sim.get_clock());
+	EXPECT_EQ(6, sim.get_convergence_monitor()->get_nb_batches());
+}
+
+TEST (SimulationTest, CheckpointRestore){
+	Simulation sim(1000, 250, 0.1, 100, 5, 2);
+	std::ostringstream transient;
+	sim.run(transient);
+	ASSERT_TRUE(sim.save("checkpoint_test.chk"));
+	
+	//the original simulation goes on
+	std::ostringstream expected;
+	sim.set_t_stop(200);
+	sim.run(expected);
+	EXPECT_EQ(2000, sim.get_clock());
+	
+	//a new simulation starts from the checkpoint
+	Simulation restored(1000, 250, 0.1, 200, 5, 2);
+	ASSERT_TRUE(restored.restore("checkpoint_test.chk"));
+	EXPECT_EQ(1000, restored.get_clock());
+	std::ostringstream spikes;
+	restored.run(spikes);
+	
+	EXPECT_FALSE(expected.str().empty());
+	EXPECT_EQ(expected.str(), spikes.str());
+	
+	//the parameters have to be the same
+	Simulation other(1000, 250, 0.1, 200, 4, 2);
+	EXPECT_FALSE(other.restore("checkpoint_test.chk"));
+	EXPECT_FALSE(other.restore("missing_checkpoint.chk"));
+	
+	std::remove("checkpoint_test.chk");
+}
+
+TEST (SimulationTest, BackgroundCheckpoints){
+	Simulation sim(1000, 250, 0.1, 100, 5, 2);
+	sim.enable_background_checkpoints("background_test", 20, 2);
+	std::ostringstream spikes;
+	sim.run(spikes);
+	
+	const BackgroundCheckpointer* checkpointer(sim.get_background_checkpointer());
+	ASSERT_TRUE(checkpointer != nullptr);
+	EXPECT_EQ(5, checkpointer->get_nb_started());
+	EXPECT_EQ(5, checkpointer->get_nb_completed());
+	EXPECT_EQ(0, checkpointer->get_nb_failed());
+	EXPECT_EQ("background_test_1000.chk", checkpointer->get_last_checkpoint());
+	
+	//only the last 2 checkpoints are kept
+	EXPECT_FALSE(std::ifstream("background_test_600.chk").is_open());
+	EXPECT_TRUE(std::ifstream("background_test_800.chk").is_open());
+	
+	//the checkpoint written in the background is the state at the time of the fork
+	Simulation restored(1000, 250, 0.1, 150, 5, 2);
+	ASSERT_TRUE(restored.restore("background_test_800.chk"));
+	EXPECT_EQ(800, restored.get_clock());
+	std::ostringstream restored_spikes;
+	restored.run(restored_spikes);
+	
+	std::ostringstream expected;
+	sim.set_t_stop(150);
+	sim.run(expected);
+	std::istringstream lines(spikes.str());
+	std::string line;
+	std::string end_of_spikes;
+	while (std::getline(lines, line)) {
+		if (std::stod(line) > 80.05) {
+			end_of_spikes += line + '\n';
+		}
+	}
+	EXPECT_FALSE(end_of_spikes.empty());
+	EXPECT_EQ(end_of_spikes + expected.str(), restored_spikes.str());
+	
+	for (unsigned long T(200) ; T<=1500 ; T += 200) {
+		std::remove(("background_test_" + std::to_string(T) + ".chk").c_str());
+	}
+	
+	EXPECT_EQ(0, checkpointer->get_nb_synchronous());
+	
+	//while a writing thread is alive, the process is not forked and the checkpoint is written directly
+	{
+		AsyncWriter writer("background_test.bin");
+		BackgroundCheckpointer synchronous("background_test", 1);
+		synchronous.step(sim, 1500);
+		EXPECT_EQ(1, synchronous.get_nb_synchronous());
+		EXPECT_EQ(1, synchronous.get_nb_completed());
+		EXPECT_EQ("background_test_1500.chk", synchronous.get_last_checkpoint());
+	}
+	Simulation synchronous_restored(1000, 250, 0.1, 150, 5, 2);
+	EXPECT_TRUE(synchronous_restored.restore("background_test_1500.chk"));
+	EXPECT_EQ(1500, synchronous_restored.get_clock());
+	std::remove("background_test_1500.chk");
+	std::remove("background_test.bin");
+}
+
+TEST (MeanFieldTest, UnconnectedNeurons){
+	//neurons without connections only receive the background noise: mu = ETA*Vthr and sigma^2 = J*ETA*Vthr
+	const double ETA(1.2);
+	Brain brain(std::make_shared<Connectivity>(500), 500, 0.1, ETA*20.0*0.1 / (0.1*20.0));
+	brain.set_noise_seed(1);
+	SpikeStatistics statistics(500, 0.1);
+	brain.attach_recorder(&statistics);
+	std::ofstream no_file;
+	for (unsigned long T(1) ; T<=10000 ; ++T) {
+		brain.update(T, no_file);
+	}
+	
+	MeanField mean_field(0, 0);
+	EXPECT_NEAR(statistics.get_mean_rate(), mean_field.transfer(ETA*20.0, std::sqrt(0.1*ETA*20.0)), 1.0);
+	EXPECT_NEAR(statistics.get_mean_cv(), mean_field.cv(ETA*20.0, std::sqrt(0.1*ETA*20.0)), 0.02);
+	
+	//without noise the rate is the one of a deterministic neuron
+	EXPECT_NEAR(1000.0 / (2.0 + 20.0*std::log(24.0/4.0)), mean_field.transfer(24.0, 0.0), 1e-9);
+	EXPECT_EQ(0.0, mean_field.transfer(19.0, 0.0));
+}
+
+TEST (MeanFieldTest, Predictions){
+	Simulation simulation(1000, 250, 0.1, 0, 5, 2, 1);
+	EXPECT_EQ(MeanField(100, 25).predict(5, 2).rate, simulation.get_mean_field().predict(5, 2).rate);
+	EXPECT_EQ(simulation.get_mean_field().predict(5, 2).rate, Simulation::mean_field(1000, 250).predict(5, 2).rate);
+	
+	//rates of the network of 12500 neurons: 32 Hz at (g = 5, ETA = 2), 30 Hz at (8, 4)
+	MeanFieldPrediction prediction(MeanField().predict(5, 2));
+	EXPECT_NEAR(32.0, prediction.rate, 1.0);
+	EXPECT_TRUE(prediction.stable);
+	prediction = MeanField().predict(8, 4);
+	EXPECT_NEAR(30.0, prediction.rate, 1.0);
+	EXPECT_FALSE(prediction.stable);
+	EXPECT_EQ(SYNCHRONOUS_IRREGULAR, prediction.regime);
+	
+	MeanField mean_field;
+	EXPECT_EQ(QUIESCENT, mean_field.predict(5, 0.5).regime);
+	EXPECT_EQ(SYNCHRONOUS_REGULAR, mean_field.predict(3, 2).regime);
+	EXPECT_EQ(ASYNCHRONOUS_IRREGULAR, mean_field.predict(5, 1).regime);
+	
+	//the rate is a solution of the self-consistent equation
+	prediction = mean_field.predict(6, 1.5);
+	double mu, sigma;
+	mean_field.input(prediction.rate, 6, 1.5, mu, sigma);
+	EXPECT_NEAR(prediction.rate, mean_field.transfer(mu, sigma), 1e-6*prediction.rate);
+}
+
+TEST (GaussianNoiseTest, Moments){
+	std::mt19937 generator(1);
+	GaussianNoise noise(2.0, 3.0);
+	std::vector<double> values(100001);
+	noise.generate(generator, values.data(), values.size());
+	
+	double sum(0.0), sum_of_squares(0.0), nb_outside(0.0);
+	for (auto value : values) {
+		sum += value;
+		sum_of_squares += (value-2.0)*(value-2.0);
+		nb_outside += (std::fabs(value-2.0) > 2.0*3.0);
+	}
+	EXPECT_NEAR(2.0, sum / values.size(), 0.03);
+	EXPECT_NEAR(9.0, sum_of_squares / values.size(), 0.1);
+	EXPECT_NEAR(0.0455, nb_outside / values.size(), 0.003);
+	
+	//the same generator gives the same numbers
+	std::vector<double> same(values.size());
+	generator.seed(1);
+	noise.generate(generator, same.data(), same.size());
+	EXPECT_EQ(values, same);
+}
+
+TEST (BrainTest, GaussianBackgroundNoise){
+	//the rates with the Gaussian noise are the ones with the Poisson noise (diffusion approximation)
+	std::shared_ptr<Connectivity> network(random_network());
+	double rates[2];
+	for (unsigned int noise(0) ; noise<2 ; ++noise) {
+		Brain brain(network, 1000, 0.1, 2.0);
+		brain.set_background_noise(noise == 0 ? POISSON_NOISE : GAUSSIAN_NOISE);
+		SpikeStatistics statistics(1250, 0.1);
+		brain.attach_recorder(&statistics);
+		run_brains({&brain}, 1, 5000);
+		rates[noise] = statistics.get_mean_rate();
+	}
+	EXPECT_NEAR(rates[0], rates[1], 0.03*rates[0]);
+}
+
+TEST (EventDrivenBrainTest, SameStatisticsAsBrain){
+	std::ofstream no_file;
+	
+	//unconnected neurons: the rate and the CV of a neuron which only receives the background noise
+	const double ETA(1.2);
+	EventDrivenBrain unconnected(std::make_shared<Connectivity>(500), 500, 0.1, ETA);
+	unconnected.set_noise_seed(1);
+	SpikeStatistics unconnected_statistics(500, 0.1);
+	unconnected.attach_recorder(&unconnected_statistics);
+	unconnected.run(10000, no_file);
+	MeanField mean_field(0, 0);
+	EXPECT_NEAR(unconnected_statistics.get_mean_rate(), mean_field.transfer(ETA*20.0, std::sqrt(0.1*ETA*20.0)), 1.0);
+	EXPECT_NEAR(unconnected_statistics.get_mean_cv(), mean_field.cv(ETA*20.0, std::sqrt(0.1*ETA*20.0)), 0.02);
+	
+	//a network: the same rate as a brain with the same connections
+	std::shared_ptr<Connectivity> network(random_network());
+	Brain brain(network, 1000, 0.1, 2.0);
+	SpikeStatistics brain_statistics(1250, 0.1);
+	brain.attach_recorder(&brain_statistics);
+	EventDrivenBrain event_driven(network, 1000, 0.1, 2.0);
+	event_driven.set_noise_seed(1);
+	SpikeStatistics event_driven_statistics(1250, 0.1);
+	event_driven.attach_recorder(&event_driven_statistics);
+	run_brains({&brain}, 1, 5000);
+	event_driven.run(5000, no_file);
+	EXPECT_NEAR(brain_statistics.get_mean_rate(), event_driven_statistics.get_mean_rate(), 0.03*brain_statistics.get_mean_rate());
+	
+	//with a weak background noise, most neurons are not updated at each step
+	EventDrivenBrain weak(network, 1000, 0.1, 0.2);
+	weak.run(1000, no_file);
+	EXPECT_LT(weak.get_nb_of_updates(), 0.2*1250*1000);
+	EXPECT_GT(weak.get_nb_of_updates(), 0.15*1250*1000);
+}
+
+TEST (EventDrivenBrainTest, PreciseTiming){
+	std::ofstream no_file;
+	std::shared_ptr<Connectivity> network(random_network());
+	
+	//the delay has to be at least one step
+	EventDrivenBrain too_short(network, 1000, 0.1, 2.0);
+	EXPECT_FALSE(too_short.enable_precise_timing(0.05, 2.0));
+	
+	//the same network with steps of 0.1 ms and 0.5 ms (the same background noise per ms) has the same statistics
+	EventDrivenBrain fine(network, 1000, 0.1, 2.0);
+	EXPECT_TRUE(fine.enable_precise_timing(1.5, 2.0));
+	fine.set_noise_seed(1);
+	SpikeStatistics fine_statistics(1250, 0.1);
+	fine.attach_recorder(&fine_statistics);
+	fine.run(5000, no_file);
+	EventDrivenBrain coarse(network, 1000, 0.5, 10.0, 3, 4);
+	EXPECT_TRUE(coarse.enable_precise_timing(1.5, 2.0));
+	coarse.set_noise_seed(2);
+	SpikeStatistics coarse_statistics(1250, 0.5);
+	coarse.attach_recorder(&coarse_statistics);
+	coarse.run(1000, no_file);
+	EXPECT_NEAR(fine_statistics.get_mean_rate(), coarse_statistics.get_mean_rate(), 0.03*fine_statistics.get_mean_rate());
+	EXPECT_NEAR(fine_statistics.get_mean_cv(), coarse_statistics.get_mean_cv(), 0.03);
+	
+	//the spikes are not on the grid
+	double off_grid(0.0);
+	for (unsigned long neuron(0) ; neuron<1250 ; ++neuron) {
+		const double time(coarse.get_last_spike_time(neuron) / 0.5);
+		off_grid += std::abs(time - std::round(time));
+	}
+	EXPECT_GT(off_grid, 0.1*1250);
+}
+
+TEST (FastBrainTest, SameSpikesAsBrain){
+	std::shared_ptr<Connectivity> network(random_network());
+	
+	//with the parameters of N. Brunel's network (specialised kernel) and with another delay and time constant (generic kernel)
+	for (unsigned int Delay_Steps : {15u, 10u}) {
+		const double TAU(Delay_Steps == 15 ? 20.0 : 15.0);
+		Brain brain(network, 1000, 0.1, 2.0, Delay_Steps, 20, 20.0, 0.0, 1.0, -5.0, 0.1, TAU);
+		FastBrain<> fast(network, 1000, LifModel(0.1, 20.0, 0.0, 0.1, TAU), 2.0, Delay_Steps);
+		EXPECT_EQ(Delay_Steps == 15, fast.get_model().is_specialized());
+		expect_same_spikes(brain, fast);
+	}
+}
+
+TEST (FastBrainTest, DistributedDelays){
+	std::shared_ptr<Connectivity> network(random_network());
+	network->set_random_delays(0, 10, 4);
+	
+	//delays from 5 to 15 steps, the fast brain delivers its spikes every 5 steps
+	Brain brain(network, 1000, 0.1, 2.0, 5);
+	FastBrain<> fast(network, 1000, LifModel(), 2.0, 5);
+	expect_same_spikes(brain, fast);
+}
+
+TEST (FastBrainTest, QuantizedWeights){
+	//weights from 0.5 to 1.5 with codes of 8 bits, and with codes of 16 bits and distributed delays
+	for (unsigned int bits : {8u, 16u}) {
+		std::shared_ptr<Connectivity> network(random_network());
+		ASSERT_TRUE(network->set_random_weights(0.5, bits, 8));
+		if (bits == 16) {
+			network->set_random_delays(0, 5, 9);
+		}
+		Brain brain(network, 1000, 0.1, 2.0, 10);
+		FastBrain<> fast(network, 1000, LifModel(), 2.0, 10);
+		expect_same_spikes(brain, fast);
+	}
+}
+
+TEST (FastBrainTest, ExponentialModels){
+	std::ofstream no_file;
+	std::shared_ptr<Connectivity> network(random_network());
+	
+	//an AdEx neuron without adaptation is an exponential neuron
+	FastBrain<ExponentialModel> exponential(network, 1000);
+	exponential.set_noise_seed(6);
+	exponential.run(2000, no_file);
+	FastBrain<AdaptiveExponentialModel> no_adaptation(network, 1000, AdaptiveExponentialModel(0.1, 18.0, 1.0, 30.0, 0.0, 0.1, 20.0, 0.0, 0.0));
+	no_adaptation.set_noise_seed(6);
+	no_adaptation.run(2000, no_file);
+	
+	//the adaptation decreases the rate
+	FastBrain<AdaptiveExponentialModel> adaptation(network, 1000, AdaptiveExponentialModel(0.1, 18.0, 1.0, 30.0, 0.0, 0.1, 20.0, 0.5, 2.0));
+	adaptation.set_noise_seed(6);
+	adaptation.run(2000, no_file);
+	
+	unsigned long nb_spikes(0), nb_adapted_spikes(0);
+	for (unsigned long i(0) ; i<1250 ; ++i) {
+		EXPECT_EQ(exponential.get_nb_of_spikes(i), no_adaptation.get_nb_of_spikes(i));
+		nb_spikes += exponential.get_nb_of_spikes(i);
+		nb_adapted_spikes += adaptation.get_nb_of_spikes(i);
+	}
+	EXPECT_GT(nb_spikes, 1250u);
+	EXPECT_LT(nb_adapted_spikes, 0.8*nb_spikes);
+}
+
+TEST (FastBrainTest, GeneratedModels){
+	std::ofstream no_file;
+	std::shared_ptr<Connectivity> network(random_network());
+	
+	//the generated leaky integrate-and-fire neuron is the same as LifModel
+	FastBrain<> lif(network, 1000, LifModel(0.1, 20.0, 0.0, 0.1, 15.0));
+	lif.set_noise_seed(7);
+	lif.run(2000, no_file);
+	FastBrain<GeneratedLifModel> generated(network, 1000, GeneratedLifModel(0.1, 20.0, 0.0, 0.1, 15.0));
+	generated.set_noise_seed(7);
+	generated.run(2000, no_file);
+	FastBrain<QuadraticModel> quadratic(network, 1000);
+	quadratic.set_noise_seed(7);
+	quadratic.run(2000, no_file);
+	
+	unsigned long nb_spikes(0), nb_quadratic_spikes(0);
+	for (unsigned long i(0) ; i<1250 ; ++i) {
+		EXPECT_EQ(lif.get_nb_of_spikes(i), generated.get_nb_of_spikes(i));
+		EXPECT_EQ(lif.get_membrane_potential(i), generated.get_membrane_potential(i));
+		nb_spikes += lif.get_nb_of_spikes(i);
+		nb_quadratic_spikes += quadratic.get_nb_of_spikes(i);
+	}
+	EXPECT_GT(nb_spikes, 1250u);
+	EXPECT_GT(nb_quadratic_spikes, 1250u);
+}
+
+TEST (PopulationDensityTest, RatesAndOscillations){
+	std::ostringstream rates;
+	
+	//the stationary rate is the one of the mean-field theory and the probability is conserved
+	PopulationDensity density(10000, 2500, 1000, 250, 5, 2);
+	density.run(5000, rates);
+	EXPECT_NEAR(MeanField().stationary_rate(5, 2), density.get_rate(true), 0.01*density.get_rate(true));
+	EXPECT_DOUBLE_EQ(density.get_rate(true), density.get_rate(false));
+	double total(density.get_refractory_fraction(true));
+	for (auto p : density.get_density(true)) {
+		total += p * 60.0/600;
+	}
+	EXPECT_NEAR(1.0, total, 1e-9);
+	
+	//fast oscillations at (g = 8, ETA = 4), seen by a population analyzer like in a brain
+	PopulationDensity oscillating(10000, 2500, 1000, 250, 8, 4);
+	oscillating.run(1000, rates);
+	PopulationAnalyzer analyzer(10000, 2500);
+	oscillating.attach_recorder(&analyzer);
+	oscillating.run(1000+4*2560, rates);
+	EXPECT_NEAR(30.0, analyzer.get_mean_rate(true), 2.0);
+	EXPECT_GT(analyzer.get_peak_frequency(true), 100.0);
+	EXPECT_GT(analyzer.get_peak_ratio(true), 10.0);
+	
+	PopulationDensity small(Simulation::population_density(1000, 250, 0.1, 5, 2));
+	small.run(3000, rates);
+	EXPECT_NEAR(MeanField(100, 25).stationary_rate(5, 2), small.get_rate(true), 0.02*small.get_rate(true));
+}
+
+TEST (ConnectivityTest, RandomConnections){
+	std::shared_ptr<Connectivity> network(Connectivity::random(100, 25, 10, 3, 42));
+	std::shared_ptr<Connectivity> same(Connectivity::random(100, 25, 10, 3, 42));
+	
+	EXPECT_EQ(125, network->get_nb_neurons());
+	EXPECT_EQ(125*13, network->get_nb_connections());
+	
+	std::vector<unsigned int> nb_excitatory(125, 0);
+	std::vector<unsigned int> nb_inhibitory(125, 0);
+	for (unsigned long i(0) ; i<125 ; ++i) {
+		ASSERT_EQ(network->get_nb_receivers(i), same->get_nb_receivers(i));
+		EXPECT_TRUE(std::equal(network->begin(i), network->end(i), same->begin(i)));
+		for (const std::uint32_t* receiver(network->begin(i)) ; receiver != network->end(i) ; ++receiver) {
+			if (i<100) {
+				++nb_excitatory[*receiver];
+			} else {
+				++nb_inhibitory[*receiver];
+			}
+		}
+	}
+	EXPECT_EQ(std::vector<unsigned int>(125, 10), nb_excitatory);
+	EXPECT_EQ(std::vector<unsigned int>(125, 3), nb_inhibitory);
+}
+
+TEST (ConnectivityTest, Cache){
+	std::string file_name(Connectivity::cache_file_name(100, 25, 10, 3, 7, "."));
+	std::remove(file_name.c_str());
+	
+	//the first call creates the file, the second one only maps it
+	std::shared_ptr<Connectivity> created(Connectivity::cached_random(100, 25, 10, 3, 7, "."));
+	EXPECT_TRUE(std::ifstream(file_name).is_open());
+	std::shared_ptr<Connectivity> mapped(Connectivity::cached_random(100, 25, 10, 3, 7, "."));
+	EXPECT_TRUE(mapped->is_mapped());
+	std::shared_ptr<Connectivity> expected(Connectivity::random(100, 25, 10, 3, 7));
+	
+	ASSERT_EQ(expected->get_nb_connections(), mapped->get_nb_connections());
+	EXPECT_TRUE(std::equal(expected->begin(0), expected->end(124), mapped->begin(0)));
+	
+	//a mapped network is copied in memory before being modified
+	mapped->add(3, 4);
+	EXPECT_FALSE(mapped->is_mapped());
+	EXPECT_EQ(expected->get_nb_receivers(3)+1, mapped->get_nb_receivers(3));
+	EXPECT_EQ(4, *(mapped->end(3)-1));
+	EXPECT_EQ(expected->get_nb_connections(), Connectivity::map(file_name)->get_nb_connections());
+	
+	std::remove(file_name.c_str());
+	EXPECT_TRUE(Connectivity::map(file_name) == nullptr);
+}
+
+TEST (ConnectivityTest, CorruptFiles){
+	std::shared_ptr<Connectivity> network(std::make_shared<Connectivity>(3));
+	network->add(0, 1);
+	network->add(0, 2);
+	network->add(1, 2);
+	std::stringstream stream;
+	network->write(stream);
+	const std::string valid(stream.str());
+	
+	//the numbers of neurons, connections and buckets are followed by the offsets and the receivers
+	std::string wrong_receiver(valid);
+	const std::uint32_t receiver(3);
+	wrong_receiver.replace(24 + 4*8, 4, reinterpret_cast<const char*>(&receiver), 4);
+	std::istringstream wrong_receiver_stream(wrong_receiver);
+	Connectivity read(3);
+	EXPECT_FALSE(read.read(wrong_receiver_stream));
+	std::string wrong_offsets(valid);
+	const std::uint64_t offset(1);
+	wrong_offsets.replace(24 + 2*8, 8, reinterpret_cast<const char*>(&offset), 8);
+	std::istringstream wrong_offsets_stream(wrong_offsets);
+	EXPECT_FALSE(read.read(wrong_offsets_stream));
+	
+	//huge numbers of connections or buckets are refused without allocating their arrays
+	std::string huge_connections(valid);
+	const std::uint64_t huge(1ull << 60);
+	huge_connections.replace(8, 8, reinterpret_cast<const char*>(&huge), 8);
+	huge_connections.replace(24 + 3*8, 8, reinterpret_cast<const char*>(&huge), 8);
+	std::istringstream huge_connections_stream(huge_connections);
+	EXPECT_FALSE(read.read(huge_connections_stream));
+	std::string huge_buckets(valid);
+	huge_buckets.replace(16, 8, reinterpret_cast<const char*>(&huge), 8);
+	std::istringstream huge_buckets_stream(huge_buckets);
+	EXPECT_FALSE(read.read(huge_buckets_stream));
+	
+	//the delays of the buckets of a neuron increase
+	Connectivity delayed(*network);
+	ASSERT_TRUE(delayed.set_delays({1, 2, 1}));
+	std::stringstream delayed_stream;
+	delayed.write(delayed_stream);
+	std::string wrong_delays(delayed_stream.str());
+	const std::uint32_t delay(1);
+	wrong_delays.replace(24 + 4*8 + 3*4 + 4*8 + 4*8 + 4, 4, reinterpret_cast<const char*>(&delay), 4);
+	std::istringstream wrong_delays_stream(wrong_delays);
+	EXPECT_FALSE(read.read(wrong_delays_stream));
+	std::istringstream delayed_read_stream(delayed_stream.str());
+	EXPECT_TRUE(read.read(delayed_read_stream));
+	
+	std::istringstream valid_stream(valid);
+	EXPECT_TRUE(read.read(valid_stream));
+	EXPECT_TRUE(read.is_same(*network));
+	
+	//the last receiver of a mapped file
+	ASSERT_TRUE(network->save("corrupt.bin"));
+	EXPECT_TRUE(Connectivity::map("corrupt.bin") != nullptr);
+	{
+		std::fstream file("corrupt.bin", std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(-4, std::ios::end);
+		file.write(reinterpret_cast<const char*>(&receiver), 4);
+	}
+	EXPECT_TRUE(Connectivity::map("corrupt.bin") == nullptr);
+	
+	//a number of connections of the header whose arrays would overflow the size
+	ASSERT_TRUE(network->save("corrupt.bin"));
+	{
+		std::fstream file("corrupt.bin", std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(8*8);
+		file.write(reinterpret_cast<const char*>(&huge), 8);
+	}
+	EXPECT_TRUE(Connectivity::map("corrupt.bin") == nullptr);
+	std::remove("corrupt.bin");
+	
+	//a brain which loads the connections it already has keeps them shared
+	Brain brain(network, 2);
+	std::stringstream state;
+	brain.save(state);
+	ASSERT_TRUE(brain.load(state));
+	EXPECT_EQ(network, brain.get_network());
+}
+
+TEST (ConnectivityTest, Delays){
+	std::shared_ptr<Connectivity> network(Connectivity::random(100, 25, 10, 3, 42));
+	std::shared_ptr<Connectivity> expected(Connectivity::random(100, 25, 10, 3, 42));
+	EXPECT_FALSE(network->has_delays());
+	EXPECT_FALSE(network->set_delays(std::vector<std::uint32_t>(3, 1)));
+	ASSERT_TRUE(network->set_random_delays(2, 6, 1));
+	EXPECT_EQ(2, network->get_min_delay());
+	EXPECT_EQ(6, network->get_max_delay());
+	
+	//the receivers of each neuron are the same, grouped in buckets of increasing delays
+	const std::vector<std::uint32_t> delays(network->get_delays());
+	for (unsigned long i(0) ; i<125 ; ++i) {
+		std::vector<std::uint32_t> receivers(network->begin(i), network->end(i));
+		std::vector<std::uint32_t> expected_receivers(expected->begin(i), expected->end(i));
+		std::sort(receivers.begin(), receivers.end());
+		std::sort(expected_receivers.begin(), expected_receivers.end());
+		EXPECT_EQ(expected_receivers, receivers);
+		
+		const std::uint32_t* receiver(network->begin(i));
+		for (unsigned long bucket(0) ; bucket<network->get_nb_buckets(i) ; ++bucket) {
+			ASSERT_EQ(receiver, network->bucket_begin(i, bucket));
+			EXPECT_LT(network->bucket_begin(i, bucket), network->bucket_end(i, bucket));
+			if (bucket > 0) {
+				EXPECT_GT(network->get_bucket_delay(i, bucket), network->get_bucket_delay(i, bucket-1));
+			}
+			for ( ; receiver != network->bucket_end(i, bucket) ; ++receiver) {
+				EXPECT_EQ(network->get_bucket_delay(i, bucket), delays[receiver - network->begin(0)]);
+			}
+		}
+		EXPECT_EQ(network->end(i), receiver);
+	}
+	
+	//the delays are kept by the checkpoints and the cache files
+	std::stringstream stream;
+	network->write(stream);
+	Connectivity read(125);
+	ASSERT_TRUE(read.read(stream));
+	EXPECT_EQ(delays, read.get_delays());
+	ASSERT_TRUE(network->save("delays.bin"));
+	std::shared_ptr<Connectivity> mapped(Connectivity::map("delays.bin"));
+	ASSERT_TRUE(mapped != nullptr);
+	EXPECT_EQ(delays, mapped->get_delays());
+	EXPECT_TRUE(std::equal(network->begin(0), network->end(124), mapped->begin(0)));
+	std::remove("delays.bin");
+	
+	//a connection added has no delay
+	network->add(3, 4);
+	EXPECT_EQ(0, network->get_min_delay());
+	EXPECT_EQ(0, network->get_bucket_delay(3, 0));
+	EXPECT_EQ(4, *network->bucket_begin(3, 0));
+}
+
+TEST (ConnectivityTest, Weights){
+	std::shared_ptr<Connectivity> network(Connectivity::random(100, 25, 10, 3, 42));
+	EXPECT_FALSE(network->has_weights());
+	EXPECT_EQ(1.0, network->get_weight_scale());
+	std::vector<double> weights(network->get_nb_connections());
+	for (unsigned long k(0) ; k<weights.size() ; ++k) {
+		weights[k] = 0.5 + (k % 97)/64.0;
+	}
+	EXPECT_FALSE(network->set_weights(weights, 12));
+	weights[5] = -1.0;
+	EXPECT_FALSE(network->set_weights(weights, 8));
+	weights[5] = 0.5;
+	
+	//the error of a code is at most half of the scale
+	for (unsigned int bits : {16u, 8u}) {
+		ASSERT_TRUE(network->set_weights(weights, bits));
+		EXPECT_EQ(bits, network->get_weight_bits());
+		EXPECT_DOUBLE_EQ(*std::max_element(weights.begin(), weights.end()) / (std::ldexp(1.0, bits) - 1), network->get_weight_scale());
+		const std::vector<double> quantized(network->get_weights());
+		for (unsigned long k(0) ; k<weights.size() ; ++k) {
+			EXPECT_LE(std::abs(quantized[k] - weights[k]), 0.5*network->get_weight_scale());
+		}
+	}
+	EXPECT_TRUE(network->weight_codes_16(0, 0) == nullptr);
+	ASSERT_TRUE(network->weight_codes_8(0, 0) != nullptr);
+	
+	//the weights follow their receivers when they are grouped by delay
+	std::vector<std::vector<std::pair<std::uint32_t, double>>> connections(125);
+	std::vector<double> quantized(network->get_weights());
+	for (unsigned long i(0) ; i<125 ; ++i) {
+		for (const std::uint32_t* receiver(network->begin(i)) ; receiver != network->end(i) ; ++receiver) {
+			connections[i].push_back(std::make_pair(*receiver, quantized[receiver - network->begin(0)]));
+		}
+		std::sort(connections[i].begin(), connections[i].end());
+	}
+	network->set_random_delays(1, 4, 2);
+	quantized = network->get_weights();
+	for (unsigned long i(0) ; i<125 ; ++i) {
+		std::vector<std::pair<std::uint32_t, double>> sorted;
+		for (unsigned long bucket(0) ; bucket<network->get_nb_buckets(i) ; ++bucket) {
+			for (const std::uint32_t* receiver(network->bucket_begin(i, bucket)) ; receiver != network->bucket_end(i, bucket) ; ++receiver) {
+				const unsigned long k(receiver - network->bucket_begin(i, bucket));
+				EXPECT_EQ(quantized[receiver - network->begin(0)], network->get_weight_scale()*network->weight_codes_8(i, bucket)[k]);
+				sorted.push_back(std::make_pair(*receiver, quantized[receiver - network->begin(0)]));
+			}
+		}
+		std::sort(sorted.begin(), sorted.end());
+		EXPECT_EQ(connections[i], sorted);
+	}
+	
+	//the weights are kept by the checkpoints and the cache files
+	std::stringstream stream;
+	network->write(stream);
+	Connectivity read(125);
+	ASSERT_TRUE(read.read(stream));
+	EXPECT_EQ(quantized, read.get_weights());
+	ASSERT_TRUE(network->save("weights.bin"));
+	std::shared_ptr<Connectivity> mapped(Connectivity::map("weights.bin"));
+	ASSERT_TRUE(mapped != nullptr);
+	EXPECT_EQ(quantized, mapped->get_weights());
+	EXPECT_EQ(network->get_delays(), mapped->get_delays());
+	std::remove("weights.bin");
+}
+
+TEST (BrainTest, SharedConnections){
+	std::shared_ptr<Connectivity> network(Connectivity::random(10, 5, 2, 1, 1));
+	Brain brain(network, 10);
+	Brain other(network, 10);
+	
+	EXPECT_EQ(15, brain.get_nb_neurons());
+	EXPECT_EQ(5, brain.get_nb_inhibitory());
+	EXPECT_EQ(network, brain.get_network());
+	
+	//the brain which adds a connection gets its own copy
+	EXPECT_TRUE(brain.add_connection(0, 1));
+	EXPECT_FALSE(brain.add_connection(0, 15));
+	EXPECT_NE(network, brain.get_network());
+	EXPECT_EQ(network, other.get_network());
+	EXPECT_EQ(other.is_connected(0, 1)+1, brain.is_connected(0, 1));
+}
+
+TEST (StdpTest, PairsOfSpikes){
+	std::shared_ptr<Connectivity> network(std::make_shared<Connectivity>(3));
+	network->add(0, 1);
+	network->add(0, 2);
+	network->add(1, 2);
+	StdpParameters parameters;
+	parameters.A_plus = 0.1;
+	parameters.A_minus = 0.2;
+	parameters.TAU_plus = 20.0;
+	parameters.TAU_minus = 10.0;
+	parameters.w_max = 2.0;
+	Stdp stdp(network, 0, 3, 0, 3, 1.0, 0.1, parameters);
+	EXPECT_TRUE(stdp.is_enabled());
+	EXPECT_FALSE(Stdp().is_enabled());
+	
+	//a receiver which spikes after its transmitter potentiates the connection, a transmitter which spikes after its receiver depresses it
+	stdp.spikes({0}, 10);
+	stdp.spikes({1}, 30);
+	stdp.spikes({0}, 50);
+	EXPECT_NEAR(1.0 + 0.2*std::exp(-0.1) - 0.4*std::exp(-0.2), stdp.get_weight(0, 1), 1e-6);
+	EXPECT_EQ(1.0, stdp.get_weight(0, 2));
+	EXPECT_EQ(1.0, stdp.get_weight(1, 2));
+	EXPECT_EQ(0.0, stdp.get_weight(2, 0));
+	
+	//the traces add the spikes of a neuron
+	stdp.spikes({2}, 60);
+	EXPECT_NEAR(1.0 + 0.2*(std::exp(-0.2) + 1.0)*std::exp(-0.05), stdp.get_weight(0, 2), 1e-6);
+	EXPECT_NEAR(1.0 + 0.2*std::exp(-0.15), stdp.get_weight(1, 2), 1e-6);
+	
+	//the weights stay below w_max
+	for (unsigned long T(61) ; T<100 ; ++T) {
+		stdp.spikes({2}, T);
+	}
+	EXPECT_EQ(2.0, stdp.get_weight(0, 2));
+}
+
+TEST (StdpTest, CoincidentSpikes){
+	//two neurons connected both ways spike twice in the same steps, given in both orders
+	std::shared_ptr<Connectivity> network(std::make_shared<Connectivity>(2));
+	network->add(0, 1);
+	network->add(1, 0);
+	StdpParameters parameters;
+	parameters.A_plus = 0.1;
+	parameters.A_minus = 0.2;
+	parameters.w_max = 2.0;
+	Stdp stdp(network, 0, 2, 0, 2, 1.0, 0.1, parameters);
+	
+	//the spikes of a step only see the traces of before the step
+	stdp.spikes({0, 1}, 10);
+	EXPECT_EQ(1.0, stdp.get_weight(0, 1));
+	EXPECT_EQ(1.0, stdp.get_weight(1, 0));
+	stdp.spikes({1, 0}, 30);
+	EXPECT_NEAR(1.0 + 0.2*std::exp(-0.1) - 0.4*std::exp(-0.1), stdp.get_weight(0, 1), 1e-6);
+	EXPECT_NEAR(stdp.get_weight(0, 1), stdp.get_weight(1, 0), 1e-6);
+}
+
+TEST (StdpTest, PlasticBrain){
+	std::shared_ptr<Connectivity> network(random_network());
+	
+	//without any change of the weights, a plastic brain is the same as a static one
+	Brain fixed(network, 1000);
+	Brain plastic(network, 1000);
+	StdpParameters no_learning;
+	no_learning.A_plus = 0.0;
+	no_learning.A_minus = 0.0;
+	ASSERT_TRUE(plastic.enable_stdp(no_learning));
+	no_learning.target = 2;
+	EXPECT_FALSE(plastic.enable_stdp(no_learning));
+	
+	Brain learning(network, 1000);
+	learning.enable_stdp();
+	EXPECT_DOUBLE_EQ(1.0, learning.get_stdp().get_mean_weight());
+	run_brains({&fixed, &plastic, &learning});
+	expect_same_spikes(fixed, plastic);
+	
+	//the weights of the E->E connections change and stay between 0 and w_max, the others are not plastic
+	EXPECT_NE(1.0, learning.get_stdp().get_mean_weight());
+	for (unsigned long i(0) ; i<1000 ; ++i) {
+		const float* weights(learning.get_stdp().get_weights(i));
+		for (const std::uint32_t* receiver(network->begin(i)) ; receiver != network->end(i) ; ++receiver) {
+			if (*receiver < 1000) {
+				EXPECT_GE(weights[receiver - network->begin(i)], 0.0);
+				EXPECT_LE(weights[receiver - network->begin(i)], 2.0);
+			}
+		}
+	}
+	EXPECT_TRUE(learning.get_stdp().get_weights(1100) == nullptr);
+	
+	//the connections can't change under the plasticity
+	const double mean_weight(learning.get_stdp().get_mean_weight());
+	EXPECT_FALSE(learning.add_connection(0, 1));
+	EXPECT_EQ(network, learning.get_network());
+	EXPECT_EQ(mean_weight, learning.get_stdp().get_mean_weight());
+	
+	//the plastic weights are saved with the brain
+	Brain restored(network, 1000);
+	expect_restored(learning, restored, [](Brain& brain) { brain.enable_stdp(); });
+	EXPECT_EQ(learning.get_stdp().get_mean_weight(), restored.get_stdp().get_mean_weight());
+}
+
+TEST (ShortTermPlasticityTest, Efficacy){
+	//depression: the resources used by a spike recover with TAU_rec
+	ShortTermParameters parameters;
+	parameters.source = 0;
+	parameters.U = 0.5;
+	parameters.TAU_rec = 800.0;
+	ShortTermPlasticity depressing(10, 20, 0.1, parameters);
+	EXPECT_TRUE(depressing.is_enabled());
+	EXPECT_EQ(1.0, depressing.spike(5, 100));
+	EXPECT_EQ(1.0, depressing.spike(10, 100));
+	EXPECT_DOUBLE_EQ(1.0 - 0.5*std::exp(-10.0/800.0), depressing.spike(10, 200));
+	EXPECT_DOUBLE_EQ(1.0 - 0.5*std::exp(-10.0/800.0), depressing.get_efficacy(10));
+	EXPECT_EQ(1.0, depressing.get_efficacy(11));
+	
+	//facilitation: u increases by U*(1-u) at each spike and decays with TAU_facil
+	parameters.U = 0.1;
+	parameters.TAU_rec = 100.0;
+	parameters.TAU_facil = 1000.0;
+	ShortTermPlasticity facilitating(0, 1, 0.1, parameters);
+	EXPECT_EQ(1.0, facilitating.spike(0, 0));
+	const double u(0.1*std::exp(-5.0/1000.0) + 0.1*(1.0 - 0.1*std::exp(-5.0/1000.0)));
+	const double x(1.0 - 0.1*std::exp(-5.0/100.0));
+	EXPECT_DOUBLE_EQ(u*x/0.1, facilitating.spike(0, 50));
+	EXPECT_GT(facilitating.get_efficacy(0), 1.0);
+	
+	EXPECT_FALSE(ShortTermPlasticity().is_enabled());
+	EXPECT_EQ(1.0, ShortTermPlasticity().spike(0, 10));
+}
+
+TEST (ShortTermPlasticityTest, DepressingBrain){
+	std::shared_ptr<Connectivity> network(random_network());
+	
+	//with U = 1 and an immediate recovery every spike transmits its weight, as in a static brain
+	Brain fixed(network, 1000);
+	Brain unchanged(network, 1000);
+	ShortTermParameters parameters;
+	parameters.U = 1.0;
+	parameters.TAU_rec = 0.0;
+	ASSERT_TRUE(unchanged.enable_short_term_plasticity(parameters));
+	parameters.U = 0.0;
+	EXPECT_FALSE(unchanged.enable_short_term_plasticity(parameters));
+	
+	//the depression of the E->E connections lowers the activity
+	Brain depressing(network, 1000);
+	depressing.enable_short_term_plasticity();
+	run_brains({&fixed, &unchanged, &depressing});
+	expect_same_spikes(fixed, unchanged);
+	EXPECT_LT(nb_of_spikes(depressing), nb_of_spikes(fixed));
+	
+	//the states of the transmitters are saved with the brain
+	Brain restored(network, 1000);
+	expect_restored(depressing, restored, [](Brain& brain) { brain.enable_short_term_plasticity(); });
+	for (unsigned long i(0) ; i<1000 ; ++i) {
+		EXPECT_EQ(depressing.get_short_term_plasticity().get_efficacy(i), restored.get_short_term_plasticity().get_efficacy(i));
+	}
+}
+
+TEST (SweepTest, Description){
+	std::istringstream description("# small sweep\nNE 400\nNI 100\nt_stop 50 # ms\nthreads 3\nspikes yes\n\ngrid 3 5 3 1 2 2\npoint 6 4 2\n");
+	Sweep sweep;
+	std::ostringstream errors;
+	EXPECT_TRUE(sweep.read(description, errors));
+	EXPECT_EQ("", errors.str());
+	
+	EXPECT_EQ(400, sweep.get_settings().NE);
+	EXPECT_EQ(50.0, sweep.get_settings().t_stop);
+	EXPECT_EQ(3, sweep.get_settings().threads);
+	EXPECT_TRUE(sweep.get_settings().write_spikes);
+	EXPECT_FALSE(sweep.get_settings().early_stopping);
+	
+	ASSERT_EQ(7, sweep.get_points().size());
+	EXPECT_EQ(4.0, sweep.get_points()[3].g);
+	EXPECT_EQ(2.0, sweep.get_points()[3].ETA);
+	EXPECT_EQ(1, sweep.get_points()[3].seed);
+	EXPECT_EQ(6.0, sweep.get_points()[6].g);
+	EXPECT_EQ(2, sweep.get_points()[6].seed);
+	
+	std::istringstream wrong("point 4\nspikes maybe\nunknown 3\n");
+	EXPECT_FALSE(sweep.read(wrong, errors));
+	EXPECT_EQ(7, sweep.get_points().size());
+}
+
+TEST (SweepTest, Run){
+	SweepSettings settings;
+	settings.NE = 400;
+	settings.NI = 100;
+	settings.t_stop = 100;
+	settings.threads = 2;
+	settings.output_directory = "sweep_test";
+	
+	Sweep sweep(settings);
+	sweep.add_point(3, 2);
+	sweep.add_point(5, 2);
+	sweep.add_point(6, 4);
+	sweep.add_point(3, 2);
+	std::ostringstream log;
+	sweep.run(log);
+	
+	ASSERT_EQ(4, sweep.get_results().size());
+	for (const auto& result : sweep.get_results()) {
+		EXPECT_GT(result.excitatory_rate, 0.0);
+		EXPECT_EQ(100.0, result.simulated_time);
+	}
+	EXPECT_EQ(5.0, sweep.get_results()[1].point.g);
+	
+	//same parameters and same seed give the same simulation
+	EXPECT_EQ(sweep.get_results()[0].excitatory_rate, sweep.get_results()[3].excitatory_rate);
+	EXPECT_EQ(sweep.get_results()[0].cv, sweep.get_results()[3].cv);
+	
+	std::ifstream summary("sweep_test/sweep_summary.txt");
+	std::string line;
+	unsigned int nb_lines(0);
+	while (std::getline(summary, line)) {
+		++nb_lines;
+	}
+	EXPECT_EQ(5, nb_lines);
+	
+	for (unsigned int k(0) ; k<4 ; ++k) {
+		std::remove(("sweep_test/run_" + std::to_string(k) + "_population.txt").c_str());
+	}
+	std::remove("sweep_test/sweep_summary.txt");
+	std::remove("sweep_test");
+}
+
+TEST (SweepTest, EarlyStoppingAfterTransient){
+	SweepSettings settings;
+	settings.NE = 400;
+	settings.NI = 100;
+	settings.transient = 1000;
+	settings.t_stop = 100;
+	settings.output_directory = "sweep_test";
+	settings.early_stopping = true;
+	settings.criteria.stable_batches = 1;
+	
+	//the monitor could stop after 350 ms, it only starts with the measures, after the transient
+	Sweep sweep(settings);
+	sweep.add_point(5, 2);
+	std::ostringstream log;
+	sweep.run(log);
+	ASSERT_EQ(1, sweep.get_results().size());
+	EXPECT_EQ(1100.0, sweep.get_results()[0].simulated_time);
+	EXPECT_GT(sweep.get_results()[0].excitatory_rate, 0.0);
+	
+	std::remove("sweep_test/run_0_population.txt");
+	std::remove("sweep_test/sweep_summary.txt");
+	std::remove("sweep_test");
+}
+
+TEST (SweepTest, Continuation){
+	std::istringstream description("NE 400\nNI 100\nt_stop 50\ntransient 40\nthreads 1\ncontinuation yes 10\noutput sweep_test\ngrid 4 6 3 2 2 1\npoint 5 3\n");
+	Sweep sweep;
+	EXPECT_TRUE(sweep.read(description));
+	EXPECT_TRUE(sweep.get_settings().continuation);
+	EXPECT_EQ(10.0, sweep.get_settings().continuation_transient);
+	std::ostringstream log;
+	sweep.run(log);
+	
+	//the points with the same ETA are a chain, the last point starts a new one
+	ASSERT_EQ(4, sweep.get_results().size());
+	EXPECT_FALSE(sweep.get_results()[0].continued);
+	EXPECT_TRUE(sweep.get_results()[1].continued);
+	EXPECT_TRUE(sweep.get_results()[2].continued);
+	EXPECT_FALSE(sweep.get_results()[3].continued);
+	EXPECT_EQ(90.0, sweep.get_results()[0].simulated_time);
+	EXPECT_EQ(60.0, sweep.get_results()[1].simulated_time);
+	EXPECT_EQ(90.0, sweep.get_results()[3].simulated_time);
+	for (const auto& result : sweep.get_results()) {
+		EXPECT_GT(result.excitatory_rate, 0.0);
+	}
+	
+	//only the adjacent points of a grid are chained, and the chains are at most 8/3 points long to share them between 3 threads
+	SweepSettings settings(sweep.get_settings());
+	settings.threads = 3;
+	Sweep shared(settings);
+	shared.add_grid(4, 7, 4, 2, 2, 1);
+	shared.add_point(7, 3);
+	shared.add_point(7, 2);
+	shared.add_grid(4, 6, 2, 2, 2, 1);
+	shared.run(log);
+	ASSERT_EQ(8, shared.get_results().size());
+	const bool continued[8] = {false, true, true, false, false, false, false, true};
+	for (unsigned int k(0) ; k<8 ; ++k) {
+		EXPECT_EQ(continued[k], shared.get_results()[k].continued);
+	}
+	
+	for (unsigned int k(0) ; k<8 ; ++k) {
+		std::remove(("sweep_test/run_" + std::to_string(k) + "_population.txt").c_str());
+	}
+	std::remove("sweep_test/sweep_summary.txt");
+	std::remove("sweep_test");
+}
+
+TEST (SweepTest, AdaptiveGrid){
+	std::istringstream description("NE 400\nNI 100\nt_stop 50\noutput sweep_test\nadaptive 4 6 2 0 0.1 2 3\n");
+	Sweep sweep;
+	EXPECT_TRUE(sweep.read(description));
+	ASSERT_EQ(4, sweep.get_points().size());
+	std::ostringstream log;
+	sweep.run(log);
+	
+	//every corner is quiescent: nothing is refined
+	EXPECT_EQ(4, sweep.get_results().size());
+	
+	//the grid crosses the boundary of the quiescent regime (ETA = 0)
+	SweepSettings settings(sweep.get_settings());
+	settings.continuation = true;
+	Sweep boundary(settings);
+	boundary.add_adaptive_grid(4, 6, 2, 0, 2, 2, 2);
+	boundary.run(log);
+	const unsigned long nb_points(boundary.get_points().size());
+	EXPECT_GE(nb_points, 9);
+	EXPECT_LT(nb_points, 25);
+	ASSERT_EQ(nb_points, boundary.get_results().size());
+	for (const auto& result : boundary.get_results()) {
+		if (result.point.ETA == 0.0) {
+			EXPECT_EQ(QUIESCENT, result.regime);
+		} else if (result.point.ETA == 2.0) {
+			EXPECT_NE(QUIESCENT, result.regime);
+		}
+	}
+	
+	//a refined point only starts from the previous point if it is half a cell of its level away
+	for (unsigned long k(4) ; k<nb_points ; ++k) {
+		const SweepPoint& point(boundary.get_points()[k]);
+		const SweepPoint& previous(boundary.get_points()[k-1]);
+		EXPECT_LT(point.g_step, 2.0);
+		if (boundary.get_results()[k].continued) {
+			EXPECT_LE(std::abs(point.g - previous.g) + std::abs(point.ETA - previous.ETA), std::max(point.g_step, point.ETA_step) + 1e-9);
+		}
+	}
+	
+	for (unsigned int k(0) ; k<nb_points ; ++k) {
+		std::remove(("sweep_test/run_" + std::to_string(k) + "_population.txt").c_str());
+	}
+	std::remove("sweep_test/sweep_summary.txt");
+	std::remove("sweep_test");
+}
+
+TEST (SweepTest, SkipPredicted){
+	std::istringstream description("NE 400\nNI 100\nt_stop 50\noutput sweep_test\nskip_predicted Q SR\npoint 5 0.5\npoint 5 2\n");
+	Sweep sweep;
+	EXPECT_TRUE(sweep.read(description));
+	ASSERT_EQ(2, sweep.get_settings().skipped_regimes.size());
+	std::ostringstream log;
+	sweep.run(log);
+	
+	ASSERT_EQ(2, sweep.get_results().size());
+	EXPECT_FALSE(sweep.get_results()[0].simulated);
+	EXPECT_EQ(QUIESCENT, sweep.get_results()[0].regime);
+	EXPECT_EQ(0.0, sweep.get_results()[0].simulated_time);
+	EXPECT_EQ(sweep.get_results()[1].simulated, sweep.get_results()[1].predicted_regime != SYNCHRONOUS_REGULAR);
+	
+	std::remove("sweep_test/run_1_population.txt");
+	std::remove("sweep_test/sweep_summary.txt");
+	std::remove("sweep_test");
+}
+
+TEST (EnsembleTest, ConnectionsWithoutDelaysOrWeights){
+	//the ensemble and the event-driven brain give every signal the delay and the weight of its population
+	std::shared_ptr<Connectivity> delayed(Connectivity::random(400, 100, 40, 10, 3));
+	ASSERT_TRUE(delayed->set_random_delays(0, 5, 1));
+	std::shared_ptr<Connectivity> weighted(Connectivity::random(400, 100, 40, 10, 3));
+	ASSERT_TRUE(weighted->set_random_weights(0.5, 8, 1));
+	std::vector<EnsembleTrial> trials({{5.0, 2.0, 1}});
+	EXPECT_THROW(Ensemble(delayed, 400, trials), std::invalid_argument);
+	EXPECT_THROW(Ensemble(weighted, 400, trials), std::invalid_argument);
+	EXPECT_THROW(EventDrivenBrain(delayed, 400), std::invalid_argument);
+	EXPECT_THROW(EventDrivenBrain(weighted, 400), std::invalid_argument);
+}
+
+TEST (EnsembleTest, SameSpikesAsBrains){
+	std::shared_ptr<Connectivity> network(Connectivity::random(400, 100, 40, 10, 3));
+	std::vector<EnsembleTrial> trials({{5.0, 2.0, 1}, {3.0, 2.0, 2}, {6.0, 4.0, 1}});
+	Ensemble ensemble(network, 400, trials);
+	SpikeRecorder recorder(100000);
+	ensemble.attach_recorder(1, &recorder);
+	ensemble.run(1000);
+	EXPECT_EQ(1000, ensemble.get_clock());
+	
+	//each trial is a brain with the same connections, parameters and noise
+	for (unsigned int k(0) ; k<trials.size() ; ++k) {
+		Brain brain(network, 400, 0.1, trials[k].ETA*20.0*0.1 / (0.1*20), 15, 20, 20.0, 0.0, 1.0, -trials[k].g);
+		brain.set_noise_seed(trials[k].seed);
+		std::ofstream no_file;
+		for (unsigned long T(1) ; T<=1000 ; ++T) {
+			brain.update(T, no_file);
+		}
+		
+		unsigned long total(0);
+		for (unsigned long i(0) ; i<500 ; ++i) {
+			ASSERT_EQ(brain.get_neuron(i).get_nb_of_spikes(), ensemble.get_nb_of_spikes(i, k));
+			ASSERT_EQ(brain.get_neuron(i).get_membrane_potential(), ensemble.get_membrane_potential(i, k));
+			total += ensemble.get_nb_of_spikes(i, k);
+		}
+		EXPECT_GT(total, 0);
+		EXPECT_EQ(total, ensemble.get_total_nb_of_spikes(k));
+	}
+	EXPECT_EQ(ensemble.get_total_nb_of_spikes(1), recorder.get_nb_recorded());
+}
+
+TEST (SimulationTest, Continuation){
+	std::shared_ptr<Connectivity> network(Connectivity::random(400, 100, 40, 10, 1));
+	Simulation previous(network, 400, 0.1, 50, 5, 2);
+	previous.set_noise_seed(1);
+	std::ofstream no_file;
+	previous.run(no_file);
+	
+	Simulation next(network, 400, 0.1, 20, 3, 2);
+	EXPECT_TRUE(next.continue_from(previous));
+	EXPECT_EQ(500, next.get_clock());
+	
+	//the neurons have the membrane potentials of the previous simulation
+	std::vector<unsigned long> neurons(500);
+	for (unsigned long i(0) ; i<500 ; ++i) {
+		neurons[i] = i;
+	}
+	std::vector<double> previous_potentials(500), next_potentials(500);
+	previous.get_brain().gather_membrane_potentials(neurons, previous_potentials.data());
+	next.get_brain().gather_membrane_potentials(neurons, next_potentials.data());
+	EXPECT_EQ(previous_potentials, next_potentials);
+	EXPECT_NE(std::vector<double>(500, 0.0), next_potentials);
+	
+	next.run(no_file);
+	EXPECT_EQ(700, next.get_clock());
+	
+	//with the same parameters and the same noise, the signals on the way and the refractory periods are copied too:
+	//the continuation simulates what the previous simulation would have simulated
+	Simulation same(network, 400, 0.1, 20, 5, 2);
+	ASSERT_TRUE(same.continue_from(previous));
+	same.set_noise_seed(2);
+	previous.set_noise_seed(2);
+	previous.set_t_stop(70);
+	std::ostringstream same_spikes, previous_spikes;
+	same.run(same_spikes);
+	previous.run(previous_spikes);
+	EXPECT_FALSE(previous_spikes.str().empty());
+	EXPECT_EQ(previous_spikes.str(), same_spikes.str());
+	previous.get_brain().gather_membrane_potentials(neurons, previous_potentials.data());
+	same.get_brain().gather_membrane_potentials(neurons, next_potentials.data());
+	EXPECT_EQ(previous_potentials, next_potentials);
+	
+	Simulation other(Connectivity::random(40, 10, 4, 1, 1), 40, 0.1, 20, 3, 2);
+	EXPECT_FALSE(other.continue_from(previous));
+}
+
 TEST (SimulationTest, ConstantValues){
 	Simulation sim(10000, 2500, 0.1, 0, 4.5, 0.9);
 	